@@ -18,8 +18,12 @@
 #ifndef ICONNMANAGERSERVICE_H
 #define ICONNMANAGERSERVICE_H
 
+#include <vector>
+
 #include "IConnManagerServiceTypes.h"
+#include "Poco/AutoPtr.h"
 #include "Poco/BasicEvent.h"
+#include "Poco/RefCountedObject.h"
 #include "Poco/OSP/Service.h"
 
 namespace Stla {
@@ -30,6 +34,56 @@ namespace Connectivity {
  */
 const char* const CONNMANAGER_SERVICE_NAME = "stla.connectivity.connmanager.service.base";
 
+/**
+ * ICellularMetricsSubscription delivers the cellular metric events of the service to one application,
+ * filtered according to its \link CellularEventFilter \endlink.
+ * Each event is filtered separately. The subscription ends when the last pointer to it is released.
+ */
+#ifdef DOXYGEN_WORKING
+class ICellularMetricsSubscription : public Poco::RefCountedObject
+#else
+class __attribute__((visibility("default"))) ICellularMetricsSubscription : public Poco::RefCountedObject
+#endif
+{
+public:
+    /**
+     * @brief Class smart pointer definition
+     */
+    typedef Poco::AutoPtr<ICellularMetricsSubscription> Ptr;
+
+    /**
+     * ICellularMetricsSubscription destructor
+     */
+    virtual ~ICellularMetricsSubscription() {};
+
+    /**
+     * @brief Setter for the filter of the subscription
+     * @param[in] filter New filter, applied from the next change
+     * @return Error number described in \link ConMgrErrno \endlink.
+     */
+    virtual ConMgrErrno setFilter(const CellularEventFilter& filter) = 0;
+
+    /**
+     * @brief Filtered onCellularSignalStrengthChanged of \link IConnManagerService \endlink
+     */
+    Poco::BasicEvent<const unsigned char> onCellularSignalStrengthChanged;
+
+    /**
+     * @brief Filtered onGsmMetrics of \link IConnManagerService \endlink, min_delta applies to raw_rssi
+     */
+    Poco::BasicEvent<const GsmMetrics> onGsmMetrics;
+
+    /**
+     * @brief Filtered onUmtsMetrics of \link IConnManagerService \endlink, min_delta applies to rscp
+     */
+    Poco::BasicEvent<const UmtsMetrics> onUmtsMetrics;
+
+    /**
+     * @brief Filtered onLteMetrics of \link IConnManagerService \endlink, min_delta applies to rsrp
+     */
+    Poco::BasicEvent<const LteMetrics> onLteMetrics;
+};
+
 /**
  * IConnManagerService is the interface that provides information about Connection Manager
  */
@@ -294,6 +348,124 @@ public:
      */
     virtual ConMgrErrno getRegistrationStatus(RegistrationStatus& result) = 0;
 
+    /**
+     * @brief Getter for the whole radio picture at once
+     *
+     * The snapshot is read from a cache of the service: it does not query the modem. The cache is updated on each
+     * modem notification, and refreshed from the modem at the period set by setRadioSnapshotRefreshPeriod.
+     * Compare the version with the one of a previous snapshot to know whether anything changed.
+     *
+     * @param [out] result Radio snapshot as \link RadioSnapshot \endlink
+     * @return Error number described in \link ConMgrErrno \endlink.
+     */
+    virtual ConMgrErrno getRadioSnapshot(RadioSnapshot& result) = 0;
+
+    /**
+     * @brief Setter for the refresh period of the radio snapshot cache
+     *
+     * @param[in] periodMs Period of the modem queries refreshing the cache, in milliseconds.
+     *            0 to update the cache from the modem notifications only.
+     *            The period is common to all applications: the last value set applies.
+     *
+     * @return Error number described in \link ConMgrErrno \endlink.
+     *         ConMgrErr_InvalidArgument if periodMs is below 1000.
+     */
+    virtual ConMgrErrno setRadioSnapshotRefreshPeriod(unsigned int periodMs) = 0;
+
+    /**
+     * @brief Create a filtered subscription to the cellular metric events
+     *
+     * The unfiltered onCellularSignalStrengthChanged fires when the signal strength moves from one range to another,
+     * and onGsmMetrics, onUmtsMetrics and onLteMetrics fire on every change reported by the modem. A subscription
+     * applies its own filter to every change reported by the modem instead: with the default filter, its
+     * onCellularSignalStrengthChanged fires on each new value, and band_crossing_only gives the ranges of the
+     * unfiltered event. A filter with min_delta or min_interval_ms reduces the number of metric events dispatched
+     * to an application during mobility.
+     * For the metric events, the band is the one of the signal strength of the current network type.
+     *
+     * @param[in] filter Filter of the subscription
+     * @param[out] result New subscription
+     * @return Error number described in \link ConMgrErrno \endlink.
+     */
+    virtual ConMgrErrno createCellularMetricsSubscription(const CellularEventFilter& filter,
+        ICellularMetricsSubscription::Ptr& result) = 0;
+
+    /**
+     * @brief Getter for the link quality history
+     *
+     * The service records a sample each time the LTE metrics, the registration status, the network type or the data
+     * path change, with the GNSS position. The history is bounded: the oldest samples are dropped first.
+     *
+     * @param[in] since Oldest system time of the samples to return
+     * @param[out] result Samples, oldest first, as \link LinkQualitySample \endlink
+     * @return Error number described in \link ConMgrErrno \endlink.
+     */
+    virtual ConMgrErrno getLinkQualityHistory(time_t since, std::vector<LinkQualitySample>& result) = 0;
+
+    /**
+     * @brief Getter for the predicted link quality
+     *
+     * @param[in] horizonS Horizon of the prediction in seconds, from 1 to 3600
+     * @param[out] result Prediction as \link LinkQualityPrediction \endlink
+     * @return Error number described in \link ConMgrErrno \endlink.
+     */
+    virtual ConMgrErrno getLinkQualityPrediction(unsigned int horizonS, LinkQualityPrediction& result) = 0;
+
+    /**
+     * @brief Poco Event triggered when a transfer may start or resume, and when its path or rate changes
+     *
+     * The transfer runs on the given path, at most at the given rate, until onTransferPaused.
+     */
+    Poco::BasicEvent<const TransferGrant> onTransferGranted;
+
+    /**
+     * @brief Poco Event triggered when a running transfer must stop, e.g. its path is lost, the cellular budget is spent
+     * or a transfer of higher priority needs the slot. It is granted again later, and resumes from the bytes already
+     * reported.
+     */
+    Poco::BasicEvent<const unsigned int> onTransferPaused;
+
+    /**
+     * @brief Queue a bulk transfer in the transfer scheduler
+     *
+     * The scheduler decides when each transfer runs, so concurrent uploads do not starve each other nor the telematic
+     * APN: Wi-Fi first, cellular within the byte budget and the predicted link quality.
+     * The transfer starts on onTransferGranted.
+     *
+     * @param[in] request Transfer as \link TransferRequest \endlink
+     * @param[out] transferId Identifier of the transfer
+     * @return Error number described in \link ConMgrErrno \endlink.
+     */
+    virtual ConMgrErrno requestTransfer(const TransferRequest& request, unsigned int& transferId) = 0;
+
+    /**
+     * @brief Report the bytes transferred since the last report, counted in the cellular budget when on cellular
+     *
+     * @param[in] transferId Identifier of the transfer
+     * @param[in] bytes Bytes transferred
+     * @return Error number described in \link ConMgrErrno \endlink.
+     *         ConMgrErr_InvalidArgument if the transfer is unknown.
+     */
+    virtual ConMgrErrno reportTransferProgress(unsigned int transferId, uint64_t bytes) = 0;
+
+    /**
+     * @brief Remove a transfer from the scheduler, when it is done or cancelled
+     *
+     * @param[in] transferId Identifier of the transfer
+     * @return Error number described in \link ConMgrErrno \endlink.
+     *         ConMgrErr_InvalidArgument if the transfer is unknown.
+     */
+    virtual ConMgrErrno releaseTransfer(unsigned int transferId) = 0;
+
+    /**
+     * @brief Setter for the transfer scheduler configuration
+     *
+     * @param[in] config Configuration as \link TransferSchedulerConfig \endlink
+     * @return Error number described in \link ConMgrErrno \endlink.
+     *         ConMgrErr_InvalidArgument if max_concurrent or budget_period_s is 0.
+     */
+    virtual ConMgrErrno setTransferSchedulerConfig(const TransferSchedulerConfig& config) = 0;
+
     /**
      * @brief Poco Event triggered every 5 minutes
      *
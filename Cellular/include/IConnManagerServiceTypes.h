@@ -19,6 +19,7 @@
 #define ICONNMANAGERSERVICETYPES_H
 
 #include <string.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <assert.h>
 #include <time.h>
@@ -109,6 +110,73 @@ enum ConMgrRegistrationStatus
     NADIF_REG_STAT_CAMPED               /**< Camped on a network */
 };
 
+/**
+ * \brief The ConMgrSignalBand defines the signal quality bands of the signal strength.
+ */
+//@serialize
+enum ConMgrSignalBand
+{
+    ConMgrBand_Lost = 0,    /**< No signal (0) or error value (255) */
+    ConMgrBand_Poor,        /**< Poor signal */
+    ConMgrBand_Fair,        /**< Fair signal */
+    ConMgrBand_Good,        /**< Good signal */
+    ConMgrBand_Excellent    /**< Excellent signal */
+};
+
+/**
+ * @brief Band of a signal strength, as documented for onCellularSignalStrengthChanged.
+ * CDMA network types use the GSM ranges, an unknown network type the LTE ranges.
+ */
+inline ConMgrSignalBand getSignalBand(ConMgrNetworkType networkType, unsigned char signalStrength)
+{
+    unsigned char excellent = 34;
+    unsigned char good = 26;
+    unsigned char fair = 9;
+    if ((networkType == ConMgrNtwType_GSM) || (networkType == ConMgrNtwType_CDMA_1X) || (networkType == ConMgrNtwType_CDMA_EVDO))
+    {
+        excellent = 64;
+        good = 40;
+        fair = 18;
+    }
+    else if (networkType == ConMgrNtwType_WCDMA)
+    {
+        excellent = 42;
+        good = 30;
+        fair = 18;
+    }
+
+    if ((signalStrength == 0) || (signalStrength == 0xFF))
+    {
+        return ConMgrBand_Lost;
+    }
+    if (signalStrength >= excellent)
+    {
+        return ConMgrBand_Excellent;
+    }
+    if (signalStrength >= good)
+    {
+        return ConMgrBand_Good;
+    }
+    return (signalStrength >= fair) ? ConMgrBand_Fair : ConMgrBand_Poor;
+}
+
+/**
+ * @brief Structure contains the filter of a cellular metrics subscription:
+ * - band_crossing_only (Notify only when the signal band changes, see \link ConMgrSignalBand \endlink)
+ * - min_delta (Minimum change of the main value since the last notification: signal strength,
+ *   GSM raw_rssi, UMTS rscp or LTE rsrp. Ignored if band_crossing_only is set. A band change is always notified.
+ *   With 0, any change of the event value, including the other fields of the metrics, is notified)
+ * - min_interval_ms (Minimum time between two notifications of the same event. The last change received
+ *   in between is notified at the end of the interval)
+ */
+struct CellularEventFilter
+{
+    bool band_crossing_only;
+    unsigned short int min_delta;
+    unsigned int min_interval_ms;
+    CellularEventFilter(): band_crossing_only(false), min_delta(0), min_interval_ms(0){}
+};
+
 /**
  * @brief Structure contains information about Gsm metrics:
  * - raw_rssi (The Received Signal Strength Indicator)
@@ -204,6 +272,142 @@ struct RegistrationStatus
     }
 };
 
+/**
+ * @brief Structure contains a conflated picture of the radio, served from the cache of the service:
+ * - version (Incremented each time one of the fields below changes, 0 before the first update)
+ * - timestamp (System time of the last change)
+ * - modem_available (Cellular modem availability)
+ * - network_type (Cellular network type)
+ * - signal_strength (RSSI from 0 to 100, 255 as error value)
+ * - gsm, umts, lte (Metrics of each technology, only the current network type is refreshed)
+ * - nb_cells (Number of neighboring cells per technology)
+ * - registration (Registration status)
+ */
+struct RadioSnapshot
+{
+    unsigned int version;
+    time_t timestamp;
+    bool modem_available;
+    ConMgrNetworkType network_type;
+    unsigned char signal_strength;
+    GsmMetrics gsm;
+    UmtsMetrics umts;
+    LteMetrics lte;
+    CellularNbCells nb_cells;
+    RegistrationStatus registration;
+    RadioSnapshot(): version(0), timestamp(0), modem_available(false), network_type(ConMgrNtwType_Unknown), signal_strength(0xFF){}
+};
+
+/**
+ * \brief The ConMgrDataPath defines the data path modes reported by getDataPath.
+ */
+//@serialize
+enum ConMgrDataPath
+{
+    ConMgrDataPath_None = 0,    /**< "no data" */
+    ConMgrDataPath_Cellular,    /**< "cellular" */
+    ConMgrDataPath_Wifi         /**< "wifi" */
+};
+
+/**
+ * @brief Structure contains one sample of the link quality history, recorded when one of its fields changes:
+ * - timestamp (System time of the change)
+ * - network_type (Cellular network type)
+ * - rsrp, rsrq, snr (LTE metrics, same values as \link LteMetrics \endlink, default values if not on LTE)
+ * - ps_reg_status (Registration to the cellular packet switch)
+ * - data_path (Data path mode)
+ * - position_valid, latitude, longitude (GNSS position in WGS84 degrees at the time of the sample)
+ */
+struct LinkQualitySample
+{
+    time_t timestamp;
+    ConMgrNetworkType network_type;
+    short int rsrp;
+    signed char rsrq;
+    short int snr;
+    ConMgrRegistrationStatus ps_reg_status;
+    ConMgrDataPath data_path;
+    bool position_valid;
+    double latitude;
+    double longitude;
+    LinkQualitySample(): timestamp(0), network_type(ConMgrNtwType_Unknown), rsrp(0), rsrq(0x7F), snr(0x7FFF),
+        ps_reg_status(NADIF_REG_STAT_UNKNOWN), data_path(ConMgrDataPath_None), position_valid(false), latitude(0), longitude(0){}
+};
+
+/**
+ * @brief Structure contains the link quality expected over the next horizon_s seconds, at the current position:
+ * - horizon_s (Horizon of the prediction, as requested)
+ * - throughput_kbps (Indicative cellular throughput, from the network type and the LTE rsrp)
+ * - dropout_risk (Share of time without packet switch registration in the matching history, 0 to 100)
+ * - confidence (0 to 100, grows with the amount of history used; 0 if there is no history)
+ *
+ * The prediction combines the recent samples with the history recorded around the current position,
+ * so an application can defer a bulk transfer until it reaches an area of good coverage.
+ */
+struct LinkQualityPrediction
+{
+    unsigned int horizon_s;
+    unsigned int throughput_kbps;
+    unsigned char dropout_risk;
+    unsigned char confidence;
+    LinkQualityPrediction(): horizon_s(0), throughput_kbps(0), dropout_risk(100), confidence(0){}
+};
+
+/**
+ * @brief Structure contains a bulk transfer submitted to the transfer scheduler:
+ * - priority (0 to 255, higher first)
+ * - size_bytes (Bytes left to transfer)
+ * - deadline (System time before which the transfer should be done, 0 if none. When it gets close, the transfer is
+ *   started on cellular even if the predicted link quality is below min_throughput_kbps)
+ * - wifi_only (Never started on cellular)
+ * - apn (APN used on cellular)
+ */
+struct TransferRequest
+{
+    unsigned char priority;
+    uint64_t size_bytes;
+    time_t deadline;
+    bool wifi_only;
+    ConApnName apn;
+    TransferRequest(): priority(0), size_bytes(0), deadline(0), wifi_only(false), apn(ApnName_Public){}
+};
+
+/**
+ * @brief Structure contains the authorization to run a transfer:
+ * - transfer_id (As returned by requestTransfer)
+ * - data_path (ConMgrDataPath_Wifi or ConMgrDataPath_Cellular)
+ * - apn (APN to use on cellular)
+ * - rate_kbps (Rate not to exceed, 0 for no limit)
+ */
+struct TransferGrant
+{
+    unsigned int transfer_id;
+    ConMgrDataPath data_path;
+    ConApnName apn;
+    unsigned int rate_kbps;
+    TransferGrant(): transfer_id(0), data_path(ConMgrDataPath_None), apn(ApnName_Public), rate_kbps(0){}
+};
+
+/**
+ * @brief Structure contains the configuration of the transfer scheduler:
+ * - max_concurrent (Transfers running at the same time, all paths together)
+ * - cellular_budget_bytes (Bytes of bulk transfers allowed on cellular per budget period, 0 for no cellular)
+ * - budget_period_s (Length of the budget period)
+ * - telematic_reserved_kbps (Part of the predicted cellular throughput kept for the telematic traffic)
+ * - min_throughput_kbps (No new transfer starts on cellular below this predicted throughput, unless its deadline is close.
+ *   Transfers already running on cellular go on at their share of the throughput)
+ */
+struct TransferSchedulerConfig
+{
+    unsigned int max_concurrent;
+    uint64_t cellular_budget_bytes;
+    unsigned int budget_period_s;
+    unsigned int telematic_reserved_kbps;
+    unsigned int min_throughput_kbps;
+    TransferSchedulerConfig(): max_concurrent(2), cellular_budget_bytes(50 * 1024 * 1024), budget_period_s(86400),
+        telematic_reserved_kbps(64), min_throughput_kbps(500){}
+};
+
 /**
  * @brief Structure contains information about Date time:
  * - local_time (Universal time)
@@ -0,0 +1,131 @@
+/**
+ * \file
+ *         CellularEventFilterState.cpp
+ * \brief
+ *         Decision of a cellular metrics subscription to notify a metric change or not
+ *
+ * \par Copyright Notice:
+ * \verbatim
+ * Copyright (c) 2021 Stellantis N.V.
+ * All Rights Reserved.
+ * The reproduction, transmission or use of this document or its contents is
+ * not permitted without express written authority.
+ * Offenders will be liable for damages. All rights, including rights created
+ * by patent grant or registration of a utility model or design, are reserved.
+ * \endverbatim
+ */
+
+#include "CellularEventFilterState.h"
+
+namespace Stla {
+namespace Connectivity {
+
+const uint64_t CellularEventFilterState::NO_DEADLINE;
+const size_t CellularEventFilterState::OTHER_FIELDS;
+
+CellularEventFilterState::CellularEventFilterState(): m_notified(false), m_lastBand(ConMgrBand_Lost), m_lastMs(0),
+    m_pending(false), m_pendingBand(ConMgrBand_Lost)
+{
+    m_lastValue = Value();
+    m_pendingValue = Value();
+}
+
+void CellularEventFilterState::setFilter(const CellularEventFilter& filter)
+{
+    m_filter = filter;
+}
+
+bool CellularEventFilterState::offer(unsigned char signalStrength, ConMgrSignalBand band, uint64_t nowMs)
+{
+    Value value = Value();
+    value.main = signalStrength;
+    return offer(value, band, nowMs);
+}
+
+bool CellularEventFilterState::offer(const GsmMetrics& metrics, ConMgrSignalBand band, uint64_t nowMs)
+{
+    Value value = Value();
+    value.main = metrics.raw_rssi;
+    value.other[0] = metrics.bler;
+    return offer(value, band, nowMs);
+}
+
+bool CellularEventFilterState::offer(const UmtsMetrics& metrics, ConMgrSignalBand band, uint64_t nowMs)
+{
+    Value value = Value();
+    value.main = metrics.rscp;
+    value.other[0] = metrics.raw_rssi;
+    value.other[1] = metrics.ecio;
+    value.other[2] = metrics.bler;
+    return offer(value, band, nowMs);
+}
+
+bool CellularEventFilterState::offer(const LteMetrics& metrics, ConMgrSignalBand band, uint64_t nowMs)
+{
+    Value value = Value();
+    value.main = metrics.rsrp;
+    value.other[0] = metrics.raw_rssi;
+    value.other[1] = metrics.rsrq;
+    value.other[2] = metrics.snr;
+    return offer(value, band, nowMs);
+}
+
+bool CellularEventFilterState::offer(const Value& value, ConMgrSignalBand band, uint64_t nowMs)
+{
+    if (m_notified)
+    {
+        const int delta = (value.main > m_lastValue.main) ? value.main - m_lastValue.main
+            : m_lastValue.main - value.main;
+        bool otherChanged = false;
+        for (size_t i = 0; i < OTHER_FIELDS; ++i)
+        {
+            otherChanged = otherChanged || (value.other[i] != m_lastValue.other[i]);
+        }
+        // Without min_delta, any change of the metrics is significant.
+        const bool significant = (band != m_lastBand)
+            || (!m_filter.band_crossing_only && (delta > 0) && (delta >= m_filter.min_delta))
+            || (!m_filter.band_crossing_only && (m_filter.min_delta == 0) && otherChanged);
+        if (!significant)
+        {
+            // Back within the threshold of the last notification: nothing left to notify.
+            m_pending = false;
+            return false;
+        }
+        if (nowMs < m_lastMs + m_filter.min_interval_ms)
+        {
+            m_pending = true;
+            m_pendingValue = value;
+            m_pendingBand = band;
+            return false;
+        }
+    }
+    notified(value, band, nowMs);
+    return true;
+}
+
+bool CellularEventFilterState::flush(uint64_t nowMs)
+{
+    if (!m_pending || (nowMs < m_lastMs + m_filter.min_interval_ms))
+    {
+        return false;
+    }
+    notified(m_pendingValue, m_pendingBand, nowMs);
+    return true;
+}
+
+uint64_t CellularEventFilterState::deadline() const
+{
+    return m_pending ? m_lastMs + m_filter.min_interval_ms : NO_DEADLINE;
+}
+
+void CellularEventFilterState::notified(const Value& value, ConMgrSignalBand band, uint64_t nowMs)
+{
+    m_notified = true;
+    m_lastValue = value;
+    m_lastBand = band;
+    m_lastMs = nowMs;
+    m_pending = false;
+}
+
+}
+}
@@ -0,0 +1,94 @@
+/**
+ * \file
+ *         CellularEventFilterState.h
+ * \brief
+ *         Decision of a cellular metrics subscription to notify a metric change or not
+ *
+ * \par Copyright Notice:
+ * \verbatim
+ * Copyright (c) 2021 Stellantis N.V.
+ * All Rights Reserved.
+ * The reproduction, transmission or use of this document or its contents is
+ * not permitted without express written authority.
+ * Offenders will be liable for damages. All rights, including rights created
+ * by patent grant or registration of a utility model or design, are reserved.
+ * \endverbatim
+ */
+
+#ifndef CELLULAREVENTFILTERSTATE_H
+#define CELLULAREVENTFILTERSTATE_H
+
+#include <stdint.h>
+
+#include "IConnManagerServiceTypes.h"
+
+namespace Stla {
+namespace Connectivity {
+
+/**
+ * CellularEventFilterState applies a \link CellularEventFilter \endlink to one event of one subscription.
+ *
+ * Each change is given to offer(), with the value of the event and the current band. min_delta applies to the
+ * main value (signal strength, raw_rssi, rscp or rsrp); with min_delta 0, a change of any other field of the
+ * metrics is notified too. When offer() returns false because of min_interval_ms only, the change is pending:
+ * the service keeps the last value of the event, and notifies it when flush() returns true, at the latest at
+ * deadline().
+ *
+ * Times are monotonic, in milliseconds. The class is not thread-safe.
+ */
+class CellularEventFilterState
+{
+public:
+    static const uint64_t NO_DEADLINE = UINT64_MAX;
+
+    CellularEventFilterState();
+
+    /**
+     * @brief Set the filter. The next change is compared with the last notified value.
+     */
+    void setFilter(const CellularEventFilter& filter);
+
+    /**
+     * @return true if the change must be notified now.
+     */
+    bool offer(unsigned char signalStrength, ConMgrSignalBand band, uint64_t nowMs);
+    bool offer(const GsmMetrics& metrics, ConMgrSignalBand band, uint64_t nowMs);
+    bool offer(const UmtsMetrics& metrics, ConMgrSignalBand band, uint64_t nowMs);
+    bool offer(const LteMetrics& metrics, ConMgrSignalBand band, uint64_t nowMs);
+
+    /**
+     * @return true if a pending change must be notified now.
+     */
+    bool flush(uint64_t nowMs);
+
+    /**
+     * @return time at which the pending change must be notified, or NO_DEADLINE.
+     */
+    uint64_t deadline() const;
+
+private:
+    static const size_t OTHER_FIELDS = 3;
+
+    struct Value
+    {
+        int main;                   // field min_delta applies to
+        int other[OTHER_FIELDS];    // other fields of the metrics, 0 if unused
+    };
+
+    bool offer(const Value& value, ConMgrSignalBand band, uint64_t nowMs);
+    void notified(const Value& value, ConMgrSignalBand band, uint64_t nowMs);
+
+    CellularEventFilter m_filter;
+    bool m_notified;            // something notified already
+    Value m_lastValue;
+    ConMgrSignalBand m_lastBand;
+    uint64_t m_lastMs;
+    bool m_pending;
+    Value m_pendingValue;
+    ConMgrSignalBand m_pendingBand;
+};
+
+}
+}
+
+#endif // CELLULAREVENTFILTERSTATE_H
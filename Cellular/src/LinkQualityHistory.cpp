@@ -0,0 +1,283 @@
+/**
+ * \file
+ *         LinkQualityHistory.cpp
+ * \brief
+ *         Link quality time series of the connection manager, and prediction from it
+ *
+ * \par Copyright Notice:
+ * \verbatim
+ * Copyright (c) 2021 Stellantis N.V.
+ * All Rights Reserved.
+ * The reproduction, transmission or use of this document or its contents is
+ * not permitted without express written authority.
+ * Offenders will be liable for damages. All rights, including rights created
+ * by patent grant or registration of a utility model or design, are reserved.
+ * \endverbatim
+ */
+
+#include "LinkQualityHistory.h"
+
+#include <cmath>
+
+namespace Stla {
+namespace Connectivity {
+
+namespace {
+
+/* Indicative LTE throughput by rsrp, linearly interpolated between the points. */
+const struct
+{
+    int rsrp;
+    unsigned int kbps;
+} LTE_THROUGHPUT[] = {
+    { -120, 200 },
+    { -110, 1000 },
+    { -100, 4000 },
+    { -90, 10000 },
+    { -80, 20000 }
+};
+const size_t LTE_THROUGHPUT_POINTS = sizeof(LTE_THROUGHPUT) / sizeof(LTE_THROUGHPUT[0]);
+const unsigned int WCDMA_THROUGHPUT_KBPS = 1000;
+const unsigned int GSM_THROUGHPUT_KBPS = 100;
+
+const double POSITION_SCALE = 100000.0;     // Record position unit
+const double TILE_SCALE = 100.0;            // 0.01 degree tiles
+
+}
+
+const size_t LinkQualityHistory::DEFAULT_CAPACITY;
+const size_t LinkQualityHistory::DEFAULT_MAX_TILES;
+const time_t LinkQualityHistory::MAX_SAMPLE_DURATION_S;
+
+LinkQualityHistory::LinkQualityHistory(size_t capacity, size_t maxTiles): m_capacity((capacity > 0) ? capacity : 1),
+    m_first(0), m_maxTiles(maxTiles)
+{
+    m_ring.reserve(m_capacity);
+}
+
+void LinkQualityHistory::record(const LinkQualitySample& sample)
+{
+    if (!m_ring.empty())
+    {
+        const Record& last = at(m_ring.size() - 1);
+        const time_t duration = static_cast<time_t>(sample.timestamp - last.timestamp);
+        account(last, (duration < MAX_SAMPLE_DURATION_S) ? duration : MAX_SAMPLE_DURATION_S);
+    }
+
+    if (m_ring.size() < m_capacity)
+    {
+        m_ring.push_back(pack(sample));
+    }
+    else
+    {
+        m_ring[m_first] = pack(sample);
+        m_first = (m_first + 1) % m_capacity;
+    }
+}
+
+void LinkQualityHistory::getSamples(time_t since, std::vector<LinkQualitySample>& result) const
+{
+    result.clear();
+    for (size_t i = 0; i < m_ring.size(); ++i)
+    {
+        if (at(i).timestamp >= since)
+        {
+            result.push_back(unpack(at(i)));
+        }
+    }
+}
+
+void LinkQualityHistory::predict(time_t now, unsigned int horizonS, bool positionValid, double latitude,
+    double longitude, LinkQualityPrediction& result) const
+{
+    result = LinkQualityPrediction();
+    result.horizon_s = horizonS;
+    if (horizonS == 0)
+    {
+        return;
+    }
+
+    // Recent trend: the samples overlapping [now - horizonS, now], weighted by their duration in the window.
+    const int64_t windowStart = static_cast<int64_t>(now) - horizonS;
+    int64_t end = now;
+    uint64_t recentS = 0;
+    uint64_t recentThroughput = 0;
+    uint64_t recentDropoutS = 0;
+    for (size_t i = m_ring.size(); (i > 0) && (end > windowStart); --i)
+    {
+        const Record& record = at(i - 1);
+        const int64_t start = (record.timestamp > windowStart) ? record.timestamp : windowStart;
+        if (start < end)
+        {
+            const uint64_t duration = static_cast<uint64_t>(end - start);
+            const LinkQualitySample sample = unpack(record);
+            recentS += duration;
+            recentThroughput += duration * estimateThroughputKbps(sample);
+            recentDropoutS += registered(sample.ps_reg_status) ? 0 : duration;
+        }
+        end = (record.timestamp < end) ? record.timestamp : end;
+    }
+
+    // Coverage at the current position.
+    uint64_t tileS = 0;
+    uint64_t tileThroughput = 0;
+    uint64_t tileDropoutS = 0;
+    if (positionValid)
+    {
+        const std::map<TileKey, Tile>::const_iterator it = m_tiles.find(tileOf(latitude, longitude));
+        if (it != m_tiles.end())
+        {
+            tileS = it->second.durationS;
+            tileThroughput = it->second.throughputSum;
+            tileDropoutS = it->second.dropoutS;
+        }
+    }
+
+    if ((recentS == 0) && (tileS == 0))
+    {
+        return;
+    }
+    // Each source counts for half when both are known.
+    double throughput = 0;
+    double dropout = 0;
+    unsigned int sources = 0;
+    if (recentS > 0)
+    {
+        throughput += static_cast<double>(recentThroughput) / recentS;
+        dropout += static_cast<double>(recentDropoutS) / recentS;
+        ++sources;
+    }
+    if (tileS > 0)
+    {
+        throughput += static_cast<double>(tileThroughput) / tileS;
+        dropout += static_cast<double>(tileDropoutS) / tileS;
+        ++sources;
+    }
+    result.throughput_kbps = static_cast<unsigned int>(throughput / sources);
+    result.dropout_risk = static_cast<unsigned char>(std::floor(100.0 * dropout / sources + 0.5));
+
+    // Half of the confidence from the coverage of the recent window, half from the time known in the tile.
+    const uint64_t recentPart = (recentS < horizonS) ? recentS : horizonS;
+    const uint64_t tilePart = (tileS < horizonS) ? tileS : horizonS;
+    result.confidence = static_cast<unsigned char>((50 * recentPart + 50 * tilePart) / horizonS);
+}
+
+unsigned int LinkQualityHistory::estimateThroughputKbps(const LinkQualitySample& sample)
+{
+    if (!registered(sample.ps_reg_status))
+    {
+        return 0;
+    }
+    switch (sample.network_type)
+    {
+    case ConMgrNtwType_LTE:
+    {
+        // rsrp 0 is the "not available" value of LteMetrics: take the middle of the table.
+        const int rsrp = (sample.rsrp != 0) ? sample.rsrp : LTE_THROUGHPUT[LTE_THROUGHPUT_POINTS / 2].rsrp;
+        if (rsrp <= LTE_THROUGHPUT[0].rsrp)
+        {
+            return LTE_THROUGHPUT[0].kbps;
+        }
+        for (size_t i = 1; i < LTE_THROUGHPUT_POINTS; ++i)
+        {
+            if (rsrp <= LTE_THROUGHPUT[i].rsrp)
+            {
+                const unsigned int span = LTE_THROUGHPUT[i].kbps - LTE_THROUGHPUT[i - 1].kbps;
+                return LTE_THROUGHPUT[i - 1].kbps + span * (rsrp - LTE_THROUGHPUT[i - 1].rsrp)
+                    / (LTE_THROUGHPUT[i].rsrp - LTE_THROUGHPUT[i - 1].rsrp);
+            }
+        }
+        return LTE_THROUGHPUT[LTE_THROUGHPUT_POINTS - 1].kbps;
+    }
+    case ConMgrNtwType_WCDMA:
+        return WCDMA_THROUGHPUT_KBPS;
+    default:
+        return GSM_THROUGHPUT_KBPS;
+    }
+}
+
+LinkQualityHistory::Record LinkQualityHistory::pack(const LinkQualitySample& sample)
+{
+    Record record;
+    record.timestamp = sample.timestamp;
+    record.latitude = static_cast<int32_t>(std::floor(sample.latitude * POSITION_SCALE + 0.5));
+    record.longitude = static_cast<int32_t>(std::floor(sample.longitude * POSITION_SCALE + 0.5));
+    record.rsrp = sample.rsrp;
+    record.snr = sample.snr;
+    record.rsrq = sample.rsrq;
+    record.networkType = static_cast<uint8_t>(sample.network_type);
+    record.psRegStatus = static_cast<uint8_t>(sample.ps_reg_status);
+    record.flags = static_cast<uint8_t>((sample.data_path & 0x03) | (sample.position_valid ? 0x04 : 0));
+    return record;
+}
+
+LinkQualitySample LinkQualityHistory::unpack(const Record& record)
+{
+    LinkQualitySample sample;
+    sample.timestamp = static_cast<time_t>(record.timestamp);
+    sample.network_type = static_cast<ConMgrNetworkType>(record.networkType);
+    sample.rsrp = record.rsrp;
+    sample.rsrq = record.rsrq;
+    sample.snr = record.snr;
+    sample.ps_reg_status = static_cast<ConMgrRegistrationStatus>(record.psRegStatus);
+    sample.data_path = static_cast<ConMgrDataPath>(record.flags & 0x03);
+    sample.position_valid = ((record.flags & 0x04) != 0);
+    sample.latitude = record.latitude / POSITION_SCALE;
+    sample.longitude = record.longitude / POSITION_SCALE;
+    return sample;
+}
+
+LinkQualityHistory::TileKey LinkQualityHistory::tileOf(double latitude, double longitude)
+{
+    return TileKey(static_cast<int32_t>(std::floor(latitude * TILE_SCALE)),
+        static_cast<int32_t>(std::floor(longitude * TILE_SCALE)));
+}
+
+bool LinkQualityHistory::registered(ConMgrRegistrationStatus status)
+{
+    return (status == NADIF_REG_STAT_REGISTERED) || (status == NADIF_REG_STAT_REGISTERED_ROAMING);
+}
+
+const LinkQualityHistory::Record& LinkQualityHistory::at(size_t index) const
+{
+    return m_ring[(m_first + index) % m_ring.size()];
+}
+
+void LinkQualityHistory::account(const Record& record, time_t durationS)
+{
+    if (((record.flags & 0x04) == 0) || (durationS <= 0) || (m_maxTiles == 0))
+    {
+        return;
+    }
+    const LinkQualitySample sample = unpack(record);
+    const TileKey key = tileOf(sample.latitude, sample.longitude);
+    std::map<TileKey, Tile>::iterator it = m_tiles.find(key);
+    if (it == m_tiles.end())
+    {
+        if (m_tiles.size() >= m_maxTiles)
+        {
+            // Forget the tile not visited for the longest time.
+            std::map<TileKey, Tile>::iterator oldest = m_tiles.begin();
+            for (std::map<TileKey, Tile>::iterator tile = m_tiles.begin(); tile != m_tiles.end(); ++tile)
+            {
+                if (tile->second.lastUpdate < oldest->second.lastUpdate)
+                {
+                    oldest = tile;
+                }
+            }
+            m_tiles.erase(oldest);
+        }
+        it = m_tiles.insert(std::make_pair(key, Tile())).first;
+        it->second.durationS = 0;
+        it->second.throughputSum = 0;
+        it->second.dropoutS = 0;
+    }
+    Tile& tile = it->second;
+    tile.durationS += static_cast<uint64_t>(durationS);
+    tile.throughputSum += static_cast<uint64_t>(durationS) * estimateThroughputKbps(sample);
+    tile.dropoutS += registered(sample.ps_reg_status) ? 0 : static_cast<uint64_t>(durationS);
+    tile.lastUpdate = record.timestamp;
+}
+
+}
+}
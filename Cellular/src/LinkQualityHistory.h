@@ -0,0 +1,115 @@
+/**
+ * \file
+ *         LinkQualityHistory.h
+ * \brief
+ *         Link quality time series of the connection manager, and prediction from it
+ *
+ * \par Copyright Notice:
+ * \verbatim
+ * Copyright (c) 2021 Stellantis N.V.
+ * All Rights Reserved.
+ * The reproduction, transmission or use of this document or its contents is
+ * not permitted without express written authority.
+ * Offenders will be liable for damages. All rights, including rights created
+ * by patent grant or registration of a utility model or design, are reserved.
+ * \endverbatim
+ */
+
+#ifndef LINKQUALITYHISTORY_H
+#define LINKQUALITYHISTORY_H
+
+#include <map>
+#include <vector>
+#include <stdint.h>
+
+#include "IConnManagerServiceTypes.h"
+
+namespace Stla {
+namespace Connectivity {
+
+/**
+ * LinkQualityHistory keeps the last samples in a ring of fixed capacity, packed to 24 bytes each, and a
+ * coverage map: for each tile of 0.01 x 0.01 degree (about 1 km), the time spent in it and the throughput
+ * and registration observed during that time. The map outlives the ring, so a route driven every day
+ * is known even when the ring only covers the last hours.
+ *
+ * A sample is considered valid until the next one. The class is not thread-safe.
+ */
+class LinkQualityHistory
+{
+public:
+    static const size_t DEFAULT_CAPACITY = 8192;
+    static const size_t DEFAULT_MAX_TILES = 4096;
+
+    /**
+     * @brief Longest time credited to one sample in the coverage map, so a gap (e.g. TCU off) is not
+     * accounted to the last position.
+     */
+    static const time_t MAX_SAMPLE_DURATION_S = 600;
+
+    explicit LinkQualityHistory(size_t capacity = DEFAULT_CAPACITY, size_t maxTiles = DEFAULT_MAX_TILES);
+
+    /**
+     * @brief Append a sample. Samples must be recorded in time order.
+     */
+    void record(const LinkQualitySample& sample);
+
+    /**
+     * @brief Samples with a timestamp not older than since, oldest first.
+     */
+    void getSamples(time_t since, std::vector<LinkQualitySample>& result) const;
+
+    /**
+     * @brief Predict the link quality over the next horizonS seconds from the last horizonS seconds of
+     * samples and from the coverage map tile of the given position.
+     */
+    void predict(time_t now, unsigned int horizonS, bool positionValid, double latitude, double longitude,
+        LinkQualityPrediction& result) const;
+
+    /**
+     * @brief Indicative throughput of a sample, 0 without packet switch registration.
+     */
+    static unsigned int estimateThroughputKbps(const LinkQualitySample& sample);
+
+private:
+    struct Record
+    {
+        int64_t timestamp;
+        int32_t latitude;       // 1e-5 degree
+        int32_t longitude;
+        int16_t rsrp;
+        int16_t snr;
+        int8_t rsrq;
+        uint8_t networkType;
+        uint8_t psRegStatus;
+        uint8_t flags;          // data path (bits 0-1), position valid (bit 2)
+    };
+
+    struct Tile
+    {
+        uint64_t durationS;
+        uint64_t throughputSum;     // kbps x s
+        uint64_t dropoutS;
+        int64_t lastUpdate;
+    };
+
+    typedef std::pair<int32_t, int32_t> TileKey;
+
+    static Record pack(const LinkQualitySample& sample);
+    static LinkQualitySample unpack(const Record& record);
+    static TileKey tileOf(double latitude, double longitude);
+    static bool registered(ConMgrRegistrationStatus status);
+    const Record& at(size_t index) const;    // 0 is the oldest
+    void account(const Record& record, time_t durationS);
+
+    std::vector<Record> m_ring;
+    size_t m_capacity;
+    size_t m_first;
+    size_t m_maxTiles;
+    std::map<TileKey, Tile> m_tiles;
+};
+
+}
+}
+
+#endif // LINKQUALITYHISTORY_H
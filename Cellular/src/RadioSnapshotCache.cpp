@@ -0,0 +1,184 @@
+/**
+ * \file
+ *         RadioSnapshotCache.cpp
+ * \brief
+ *         Cache of the radio state of the connection manager, served by getRadioSnapshot
+ *
+ * \par Copyright Notice:
+ * \verbatim
+ * Copyright (c) 2021 Stellantis N.V.
+ * All Rights Reserved.
+ * The reproduction, transmission or use of this document or its contents is
+ * not permitted without express written authority.
+ * Offenders will be liable for damages. All rights, including rights created
+ * by patent grant or registration of a utility model or design, are reserved.
+ * \endverbatim
+ */
+
+#include "RadioSnapshotCache.h"
+
+namespace Stla {
+namespace Connectivity {
+
+namespace {
+
+bool sameGsm(const GsmMetrics& a, const GsmMetrics& b)
+{
+    return (a.raw_rssi == b.raw_rssi) && (a.bler == b.bler);
+}
+
+bool sameUmts(const UmtsMetrics& a, const UmtsMetrics& b)
+{
+    return (a.raw_rssi == b.raw_rssi) && (a.rscp == b.rscp) && (a.ecio == b.ecio) && (a.bler == b.bler);
+}
+
+bool sameLte(const LteMetrics& a, const LteMetrics& b)
+{
+    return (a.raw_rssi == b.raw_rssi) && (a.rsrq == b.rsrq) && (a.rsrp == b.rsrp) && (a.snr == b.snr);
+}
+
+bool sameNbCells(const CellularNbCells& a, const CellularNbCells& b)
+{
+    return (a.num_gsm_cells == b.num_gsm_cells) && (a.num_wcdma_cells == b.num_wcdma_cells)
+        && (a.num_lte_cells == b.num_lte_cells);
+}
+
+bool sameRegistration(const RegistrationStatus& a, const RegistrationStatus& b)
+{
+    return (a.mnc == b.mnc) && (a.mcc == b.mcc) && (a.network_type == b.network_type)
+        && (a.cs_reg_status == b.cs_reg_status) && (a.ps_reg_status == b.ps_reg_status) && (a.tac == b.tac)
+        && (strncmp(a.network_name, b.network_name, MAX_NETWORK_NAME_LEN) == 0)
+        && (strncmp(a.cid, b.cid, MAX_CID_LEN) == 0)
+        && (strncmp(a.lac, b.lac, MAX_LAC_LEN) == 0);
+}
+
+}
+
+const unsigned int RadioSnapshotCache::MIN_REFRESH_PERIOD_MS;
+
+RadioSnapshotCache::RadioSnapshotCache(): m_refreshPeriodMs(0), m_lastRefreshMs(0), m_refreshed(false)
+{
+}
+
+void RadioSnapshotCache::setModemAvailability(bool available, time_t now)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_snapshot.modem_available != available)
+    {
+        m_snapshot.modem_available = available;
+        changed(now);
+    }
+}
+
+void RadioSnapshotCache::setNetworkType(ConMgrNetworkType networkType, time_t now)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_snapshot.network_type != networkType)
+    {
+        m_snapshot.network_type = networkType;
+        changed(now);
+    }
+}
+
+void RadioSnapshotCache::setSignalStrength(unsigned char signalStrength, time_t now)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_snapshot.signal_strength != signalStrength)
+    {
+        m_snapshot.signal_strength = signalStrength;
+        changed(now);
+    }
+}
+
+void RadioSnapshotCache::setGsmMetrics(const GsmMetrics& metrics, time_t now)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!sameGsm(m_snapshot.gsm, metrics))
+    {
+        m_snapshot.gsm = metrics;
+        changed(now);
+    }
+}
+
+void RadioSnapshotCache::setUmtsMetrics(const UmtsMetrics& metrics, time_t now)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!sameUmts(m_snapshot.umts, metrics))
+    {
+        m_snapshot.umts = metrics;
+        changed(now);
+    }
+}
+
+void RadioSnapshotCache::setLteMetrics(const LteMetrics& metrics, time_t now)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!sameLte(m_snapshot.lte, metrics))
+    {
+        m_snapshot.lte = metrics;
+        changed(now);
+    }
+}
+
+void RadioSnapshotCache::setNbCells(const CellularNbCells& nbCells, time_t now)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!sameNbCells(m_snapshot.nb_cells, nbCells))
+    {
+        m_snapshot.nb_cells = nbCells;
+        changed(now);
+    }
+}
+
+void RadioSnapshotCache::setRegistrationStatus(const RegistrationStatus& status, time_t now)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!sameRegistration(m_snapshot.registration, status))
+    {
+        m_snapshot.registration = status;
+        changed(now);
+    }
+}
+
+void RadioSnapshotCache::get(RadioSnapshot& result) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    result = m_snapshot;
+}
+
+ConMgrErrno RadioSnapshotCache::setRefreshPeriod(unsigned int periodMs)
+{
+    if ((periodMs != 0) && (periodMs < MIN_REFRESH_PERIOD_MS))
+    {
+        return ConMgrErr_InvalidArgument;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_refreshPeriodMs = periodMs;
+    return ConMgrErr_OK;
+}
+
+bool RadioSnapshotCache::refreshDue(uint64_t nowMs)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if ((m_refreshPeriodMs == 0) || (m_refreshed && (nowMs < m_lastRefreshMs + m_refreshPeriodMs)))
+    {
+        return false;
+    }
+    m_refreshed = true;
+    m_lastRefreshMs = nowMs;
+    return true;
+}
+
+void RadioSnapshotCache::changed(time_t now)
+{
+    ++m_snapshot.version;
+    if (m_snapshot.version == 0)
+    {
+        // 0 means "never updated"
+        m_snapshot.version = 1;
+    }
+    m_snapshot.timestamp = now;
+}
+
+}
+}
@@ -0,0 +1,79 @@
+/**
+ * \file
+ *         RadioSnapshotCache.h
+ * \brief
+ *         Cache of the radio state of the connection manager, served by getRadioSnapshot
+ *
+ * \par Copyright Notice:
+ * \verbatim
+ * Copyright (c) 2021 Stellantis N.V.
+ * All Rights Reserved.
+ * The reproduction, transmission or use of this document or its contents is
+ * not permitted without express written authority.
+ * Offenders will be liable for damages. All rights, including rights created
+ * by patent grant or registration of a utility model or design, are reserved.
+ * \endverbatim
+ */
+
+#ifndef RADIOSNAPSHOTCACHE_H
+#define RADIOSNAPSHOTCACHE_H
+
+#include <mutex>
+#include <stdint.h>
+
+#include "IConnManagerServiceTypes.h"
+
+namespace Stla {
+namespace Connectivity {
+
+/**
+ * RadioSnapshotCache keeps the last value of each radio metric, as notified by the modem or read at refresh.
+ *
+ * The setters are called from the modem thread; the version is incremented only when a value actually changes,
+ * so repeated notifications of the same value do not wake up pollers. get() copies the snapshot under a lock
+ * and can be called from any thread.
+ */
+class RadioSnapshotCache
+{
+public:
+    static const unsigned int MIN_REFRESH_PERIOD_MS = 1000;
+
+    RadioSnapshotCache();
+
+    void setModemAvailability(bool available, time_t now);
+    void setNetworkType(ConMgrNetworkType networkType, time_t now);
+    void setSignalStrength(unsigned char signalStrength, time_t now);
+    void setGsmMetrics(const GsmMetrics& metrics, time_t now);
+    void setUmtsMetrics(const UmtsMetrics& metrics, time_t now);
+    void setLteMetrics(const LteMetrics& metrics, time_t now);
+    void setNbCells(const CellularNbCells& nbCells, time_t now);
+    void setRegistrationStatus(const RegistrationStatus& status, time_t now);
+
+    void get(RadioSnapshot& result) const;
+
+    /**
+     * @brief Set the period of the modem queries refreshing the cache, 0 to rely on the notifications only.
+     * @return ConMgrErr_InvalidArgument if periodMs is below MIN_REFRESH_PERIOD_MS.
+     */
+    ConMgrErrno setRefreshPeriod(unsigned int periodMs);
+
+    /**
+     * @brief Tell whether the modem must be queried now, and if so start a new period.
+     * @param[in] nowMs Monotonic time in milliseconds
+     */
+    bool refreshDue(uint64_t nowMs);
+
+private:
+    void changed(time_t now);
+
+    mutable std::mutex m_mutex;
+    RadioSnapshot m_snapshot;
+    unsigned int m_refreshPeriodMs;
+    uint64_t m_lastRefreshMs;
+    bool m_refreshed;
+};
+
+}
+}
+
+#endif // RADIOSNAPSHOTCACHE_H
@@ -0,0 +1,249 @@
+/**
+ * \file
+ *         TransferScheduler.cpp
+ * \brief
+ *         Scheduler of the bulk transfers over Wi-Fi and the cellular APNs
+ *
+ * \par Copyright Notice:
+ * \verbatim
+ * Copyright (c) 2021 Stellantis N.V.
+ * All Rights Reserved.
+ * The reproduction, transmission or use of this document or its contents is
+ * not permitted without express written authority.
+ * Offenders will be liable for damages. All rights, including rights created
+ * by patent grant or registration of a utility model or design, are reserved.
+ * \endverbatim
+ */
+
+#include "TransferScheduler.h"
+
+#include <algorithm>
+
+namespace Stla {
+namespace Connectivity {
+
+namespace {
+
+struct Order
+{
+    const TransferRequest* request;
+    unsigned int id;
+};
+
+/* Higher priority first, then earlier deadline (none last), then submission order. */
+bool before(const Order& a, const Order& b)
+{
+    if (a.request->priority != b.request->priority)
+    {
+        return a.request->priority > b.request->priority;
+    }
+    if (a.request->deadline != b.request->deadline)
+    {
+        if ((a.request->deadline == 0) || (b.request->deadline == 0))
+        {
+            return a.request->deadline != 0;
+        }
+        return a.request->deadline < b.request->deadline;
+    }
+    return a.id < b.id;
+}
+
+}
+
+TransferScheduler::TransferScheduler(): m_nextId(1), m_wifiAvailable(false), m_budgetUsed(0), m_budgetPeriod(-1)
+{
+    m_apnAvailable[ApnName_Public] = false;
+    m_apnAvailable[ApnName_Telematic] = false;
+}
+
+ConMgrErrno TransferScheduler::setConfig(const TransferSchedulerConfig& config)
+{
+    if ((config.max_concurrent == 0) || (config.budget_period_s == 0))
+    {
+        return ConMgrErr_InvalidArgument;
+    }
+    m_config = config;
+    return ConMgrErr_OK;
+}
+
+unsigned int TransferScheduler::submit(const TransferRequest& request)
+{
+    // After a wrap of the counter, skip the ids of transfers still submitted.
+    while ((m_nextId == 0) || (m_transfers.find(m_nextId) != m_transfers.end()))
+    {
+        ++m_nextId;
+    }
+    const unsigned int id = m_nextId++;
+    Transfer& transfer = m_transfers[id];
+    transfer.request = request;
+    transfer.running = false;
+    transfer.dataPath = ConMgrDataPath_None;
+    transfer.rateKbps = 0;
+    return id;
+}
+
+ConMgrErrno TransferScheduler::progress(unsigned int transferId, uint64_t bytes, time_t now)
+{
+    std::map<unsigned int, Transfer>::iterator it = m_transfers.find(transferId);
+    if (it == m_transfers.end())
+    {
+        return ConMgrErr_InvalidArgument;
+    }
+    Transfer& transfer = it->second;
+    transfer.request.size_bytes -= std::min(bytes, transfer.request.size_bytes);
+    if (transfer.running && (transfer.dataPath == ConMgrDataPath_Cellular))
+    {
+        rollBudget(now);
+        m_budgetUsed += bytes;
+    }
+    return ConMgrErr_OK;
+}
+
+ConMgrErrno TransferScheduler::release(unsigned int transferId)
+{
+    return (m_transfers.erase(transferId) > 0) ? ConMgrErr_OK : ConMgrErr_InvalidArgument;
+}
+
+void TransferScheduler::setWifiAvailable(bool available)
+{
+    m_wifiAvailable = available;
+}
+
+ConMgrErrno TransferScheduler::setApnAvailable(ConApnName apn, bool available)
+{
+    if ((apn != ApnName_Public) && (apn != ApnName_Telematic))
+    {
+        return ConMgrErr_InvalidArgument;
+    }
+    m_apnAvailable[apn] = available;
+    return ConMgrErr_OK;
+}
+
+void TransferScheduler::setCellularPrediction(const LinkQualityPrediction& prediction)
+{
+    m_prediction = prediction;
+}
+
+void TransferScheduler::schedule(time_t now, std::vector<TransferGrant>& granted, std::vector<unsigned int>& paused)
+{
+    granted.clear();
+    paused.clear();
+    rollBudget(now);
+
+    std::vector<Order> order;
+    order.reserve(m_transfers.size());
+    for (std::map<unsigned int, Transfer>::const_iterator it = m_transfers.begin(); it != m_transfers.end(); ++it)
+    {
+        const Order entry = { &it->second.request, it->first };
+        order.push_back(entry);
+    }
+    std::sort(order.begin(), order.end(), before);
+
+    const unsigned int throughput = cellularThroughputKbps();
+    const bool budgetLeft = (m_budgetUsed < m_config.cellular_budget_bytes);
+    std::map<unsigned int, ConMgrDataPath> paths;
+    unsigned int slots = m_config.max_concurrent;
+    unsigned int cellular = 0;
+    for (std::vector<Order>::const_iterator it = order.begin(); (it != order.end()) && (slots > 0); ++it)
+    {
+        const Transfer& transfer = m_transfers[it->id];
+        ConMgrDataPath path = ConMgrDataPath_None;
+        if (m_wifiAvailable)
+        {
+            path = ConMgrDataPath_Wifi;
+        }
+        else if (!transfer.request.wifi_only && apnAvailable(transfer.request.apn) && budgetLeft
+            && ((throughput >= m_config.min_throughput_kbps) || urgent(transfer, now)
+                || (transfer.running && (transfer.dataPath == ConMgrDataPath_Cellular))))
+        {
+            // A low throughput only holds back new transfers, running ones go on at their share of it.
+            path = ConMgrDataPath_Cellular;
+            ++cellular;
+        }
+        if (path != ConMgrDataPath_None)
+        {
+            paths[it->id] = path;
+            --slots;
+        }
+    }
+
+    // Equal share of what the telematic traffic leaves; a rate of 0 would mean no limit.
+    unsigned int share = 0;
+    if (cellular > 0)
+    {
+        const unsigned int available = (throughput > m_config.telematic_reserved_kbps)
+            ? throughput - m_config.telematic_reserved_kbps : 0;
+        share = std::max(available / cellular, 1u);
+    }
+
+    for (std::vector<Order>::const_iterator it = order.begin(); it != order.end(); ++it)
+    {
+        Transfer& transfer = m_transfers[it->id];
+        const std::map<unsigned int, ConMgrDataPath>::const_iterator path = paths.find(it->id);
+        if (path == paths.end())
+        {
+            if (transfer.running)
+            {
+                transfer.running = false;
+                transfer.dataPath = ConMgrDataPath_None;
+                transfer.rateKbps = 0;
+                paused.push_back(it->id);
+            }
+            continue;
+        }
+        const unsigned int rate = (path->second == ConMgrDataPath_Cellular) ? share : 0;
+        if (!transfer.running || (transfer.dataPath != path->second) || (transfer.rateKbps != rate))
+        {
+            transfer.running = true;
+            transfer.dataPath = path->second;
+            transfer.rateKbps = rate;
+            TransferGrant grant;
+            grant.transfer_id = it->id;
+            grant.data_path = path->second;
+            grant.apn = transfer.request.apn;
+            grant.rate_kbps = rate;
+            granted.push_back(grant);
+        }
+    }
+}
+
+uint64_t TransferScheduler::getCellularBudgetUsed() const
+{
+    return m_budgetUsed;
+}
+
+void TransferScheduler::rollBudget(time_t now)
+{
+    const int64_t period = static_cast<int64_t>(now) / m_config.budget_period_s;
+    if (period != m_budgetPeriod)
+    {
+        m_budgetPeriod = period;
+        m_budgetUsed = 0;
+    }
+}
+
+unsigned int TransferScheduler::cellularThroughputKbps() const
+{
+    return (m_prediction.confidence > 0) ? m_prediction.throughput_kbps : m_config.min_throughput_kbps;
+}
+
+bool TransferScheduler::urgent(const Transfer& transfer, time_t now) const
+{
+    if (transfer.request.deadline == 0)
+    {
+        return false;
+    }
+    // Time needed at the predicted throughput, at least 1 kbps.
+    const uint64_t kbps = std::max(cellularThroughputKbps(), 1u);
+    const uint64_t neededS = transfer.request.size_bytes * 8 / (kbps * 1000);
+    return static_cast<int64_t>(now) + static_cast<int64_t>(neededS) >= static_cast<int64_t>(transfer.request.deadline);
+}
+
+bool TransferScheduler::apnAvailable(ConApnName apn) const
+{
+    // A request with an invalid APN never gets the cellular path.
+    return ((apn == ApnName_Public) || (apn == ApnName_Telematic)) && m_apnAvailable[apn];
+}
+
+}
+}
@@ -0,0 +1,122 @@
+/**
+ * \file
+ *         TransferScheduler.h
+ * \brief
+ *         Scheduler of the bulk transfers over Wi-Fi and the cellular APNs
+ *
+ * \par Copyright Notice:
+ * \verbatim
+ * Copyright (c) 2021 Stellantis N.V.
+ * All Rights Reserved.
+ * The reproduction, transmission or use of this document or its contents is
+ * not permitted without express written authority.
+ * Offenders will be liable for damages. All rights, including rights created
+ * by patent grant or registration of a utility model or design, are reserved.
+ * \endverbatim
+ */
+
+#ifndef TRANSFERSCHEDULER_H
+#define TRANSFERSCHEDULER_H
+
+#include <map>
+#include <vector>
+#include <stdint.h>
+
+#include "IConnManagerServiceTypes.h"
+
+namespace Stla {
+namespace Connectivity {
+
+/**
+ * TransferScheduler decides which bulk transfers run, on which path and at which rate.
+ *
+ * Transfers are ordered by priority, then by deadline. The first max_concurrent ones run: on Wi-Fi when it is
+ * available, else on cellular if their APN is up, the budget of the period is not spent and the predicted throughput
+ * is at least min_throughput_kbps (or their deadline is close, or they already run on cellular). The predicted
+ * throughput minus the part reserved for the telematic traffic is shared equally between the transfers running on
+ * cellular.
+ *
+ * The service calls schedule() after each change of the inputs, and periodically for the budget period and the
+ * deadlines, then notifies the grants and pauses returned. The class is not thread-safe.
+ */
+class TransferScheduler
+{
+public:
+    TransferScheduler();
+
+    /**
+     * @return ConMgrErr_InvalidArgument if max_concurrent or budget_period_s is 0.
+     */
+    ConMgrErrno setConfig(const TransferSchedulerConfig& config);
+
+    /**
+     * @return identifier of the new transfer, waiting until the next schedule().
+     */
+    unsigned int submit(const TransferRequest& request);
+
+    /**
+     * @brief Account bytes transferred, in the cellular budget of the period of now if running on cellular.
+     * @return ConMgrErr_InvalidArgument if the transfer is unknown.
+     */
+    ConMgrErrno progress(unsigned int transferId, uint64_t bytes, time_t now);
+
+    /**
+     * @return ConMgrErr_InvalidArgument if the transfer is unknown.
+     */
+    ConMgrErrno release(unsigned int transferId);
+
+    void setWifiAvailable(bool available);
+
+    /**
+     * @brief Set whether the APN is connected and allowed to carry data (e.g. not in garage box mode).
+     *
+     * @return ConMgrErr_InvalidArgument if apn is not ApnName_Public or ApnName_Telematic.
+     */
+    ConMgrErrno setApnAvailable(ConApnName apn, bool available);
+
+    /**
+     * @brief Set the cellular link prediction. Without confidence, the throughput is assumed to be
+     * min_throughput_kbps.
+     */
+    void setCellularPrediction(const LinkQualityPrediction& prediction);
+
+    /**
+     * @brief Compute the running transfers.
+     * @param[out] granted Transfers to start, or whose path or rate changed
+     * @param[out] paused Transfers to stop
+     */
+    void schedule(time_t now, std::vector<TransferGrant>& granted, std::vector<unsigned int>& paused);
+
+    /**
+     * @brief Bytes transferred on cellular in the current budget period.
+     */
+    uint64_t getCellularBudgetUsed() const;
+
+private:
+    struct Transfer
+    {
+        TransferRequest request;
+        bool running;
+        ConMgrDataPath dataPath;
+        unsigned int rateKbps;
+    };
+
+    void rollBudget(time_t now);
+    unsigned int cellularThroughputKbps() const;
+    bool urgent(const Transfer& transfer, time_t now) const;
+    bool apnAvailable(ConApnName apn) const;
+
+    TransferSchedulerConfig m_config;
+    std::map<unsigned int, Transfer> m_transfers;
+    unsigned int m_nextId;
+    bool m_wifiAvailable;
+    bool m_apnAvailable[2];
+    LinkQualityPrediction m_prediction;
+    uint64_t m_budgetUsed;
+    int64_t m_budgetPeriod;     // index of the current budget period
+};
+
+}
+}
+
+#endif // TRANSFERSCHEDULER_H
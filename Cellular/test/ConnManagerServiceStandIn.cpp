@@ -0,0 +1,984 @@
+/**
+ * \file
+ *         ConnManagerServiceStandIn.cpp
+ * \brief
+ *         Connection manager service replaying a scenario script, for offline runs on a X86 PC target
+ *
+ * \par Copyright Notice:
+ * \verbatim
+ * Copyright (c) 2021 Stellantis N.V.
+ * All Rights Reserved.
+ * The reproduction, transmission or use of this document or its contents is
+ * not permitted without express written authority.
+ * Offenders will be liable for damages. All rights, including rights created
+ * by patent grant or registration of a utility model or design, are reserved.
+ * \endverbatim
+ */
+
+#include "ConnManagerServiceStandIn.h"
+
+#include <algorithm>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace Stla {
+namespace Connectivity {
+
+namespace {
+
+typedef std::lock_guard<std::recursive_mutex> Lock;
+
+bool parseLong(const std::string& text, long min, long max, long& value)
+{
+    char* end = NULL;
+    value = strtol(text.c_str(), &end, 10);
+    return !text.empty() && (*end == '\0') && (value >= min) && (value <= max);
+}
+
+bool parseDouble(const std::string& text, double min, double max, double& value)
+{
+    char* end = NULL;
+    value = strtod(text.c_str(), &end);
+    return !text.empty() && (*end == '\0') && (value >= min) && (value <= max);
+}
+
+bool parseNetworkType(const std::string& text, ConMgrNetworkType& value)
+{
+    static const char* const NAMES[] = { "unknown", "gsm", "wcdma", "lte", "cdma1x", "cdmaevdo" };
+    for (size_t i = 0; i < sizeof(NAMES) / sizeof(NAMES[0]); ++i)
+    {
+        if (text == NAMES[i])
+        {
+            value = static_cast<ConMgrNetworkType>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool parseRegistrationStatus(const std::string& text, ConMgrRegistrationStatus& value)
+{
+    static const char* const NAMES[] = { "unknown", "notregistered", "registered", "limited", "roaming", "camped" };
+    for (size_t i = 0; i < sizeof(NAMES) / sizeof(NAMES[0]); ++i)
+    {
+        if (text == NAMES[i])
+        {
+            value = static_cast<ConMgrRegistrationStatus>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool parseApn(const std::string& text, ConApnName& value)
+{
+    value = (text == "telematic") ? ApnName_Telematic : ApnName_Public;
+    return (text == "public") || (text == "telematic");
+}
+
+bool parseWifiMode(const std::string& text, WiFiServerNetState_e& value)
+{
+    static const char* const NAMES[] = { "off", "enabling_sta", "enabling_ap", "sta", "ap", "disabling", "recovering",
+        "failure" };
+    for (size_t i = 0; i < sizeof(NAMES) / sizeof(NAMES[0]); ++i)
+    {
+        if (text == NAMES[i])
+        {
+            value = static_cast<WiFiServerNetState_e>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool parseWifiSecurity(const std::string& text, WiFiServerSecurity_e& value)
+{
+    static const char* const NAMES[] = { "none", "wpa_psk", "wpa_eap", "wpa2_wps", "wpa2_psk", "wpa2_eap", "wep" };
+    for (size_t i = 0; i < sizeof(NAMES) / sizeof(NAMES[0]); ++i)
+    {
+        if (text == NAMES[i])
+        {
+            value = static_cast<WiFiServerSecurity_e>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool parseWifiState(const std::string& text, WiFiServerIF_ServiceState_e& value)
+{
+    static const char* const NAMES[] = { "connecting", "connected", "disconnecting", "disconnected", "failure" };
+    for (size_t i = 0; i < sizeof(NAMES) / sizeof(NAMES[0]); ++i)
+    {
+        if (text == NAMES[i])
+        {
+            value = static_cast<WiFiServerIF_ServiceState_e>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool parseOnOff(const std::string& text, const char* on, const char* off, bool& value)
+{
+    value = (text == on);
+    return (text == on) || (text == off);
+}
+
+const char* dataPathName(ConMgrDataPath dataPath)
+{
+    switch (dataPath)
+    {
+    case ConMgrDataPath_Cellular:
+        return "cellular";
+    case ConMgrDataPath_Wifi:
+        return "wifi";
+    default:
+        return "no data";
+    }
+}
+
+}
+
+/**
+ * Subscription filters the metric events of the stand-in for one application. It detaches itself from the
+ * stand-in when the last pointer to it is released.
+ */
+class ConnManagerServiceStandIn::Subscription : public ICellularMetricsSubscription
+{
+public:
+    Subscription(ConnManagerServiceStandIn& service, const CellularEventFilter& filter): m_service(&service),
+        m_lastSignal(0xFF)
+    {
+        setFilter(filter);
+    }
+
+    virtual ~Subscription()
+    {
+        if (m_service != NULL)
+        {
+            m_service->detach(this);
+        }
+    }
+
+    virtual ConMgrErrno setFilter(const CellularEventFilter& filter)
+    {
+        if (m_service == NULL)
+        {
+            return ConMgrErr_UnavailableService;
+        }
+        Lock lock(m_service->m_mutex);
+        m_signal.setFilter(filter);
+        m_gsm.setFilter(filter);
+        m_umts.setFilter(filter);
+        m_lte.setFilter(filter);
+        return ConMgrErr_OK;
+    }
+
+    void offerSignalStrength(unsigned char value, ConMgrSignalBand band, uint64_t nowMs)
+    {
+        m_lastSignal = value;
+        if (m_signal.offer(value, band, nowMs))
+        {
+            onCellularSignalStrengthChanged.notify(this, value);
+        }
+    }
+
+    void offerGsm(const GsmMetrics& metrics, ConMgrSignalBand band, uint64_t nowMs)
+    {
+        m_lastGsm = metrics;
+        if (m_gsm.offer(metrics, band, nowMs))
+        {
+            onGsmMetrics.notify(this, metrics);
+        }
+    }
+
+    void offerUmts(const UmtsMetrics& metrics, ConMgrSignalBand band, uint64_t nowMs)
+    {
+        m_lastUmts = metrics;
+        if (m_umts.offer(metrics, band, nowMs))
+        {
+            onUmtsMetrics.notify(this, metrics);
+        }
+    }
+
+    void offerLte(const LteMetrics& metrics, ConMgrSignalBand band, uint64_t nowMs)
+    {
+        m_lastLte = metrics;
+        if (m_lte.offer(metrics, band, nowMs))
+        {
+            onLteMetrics.notify(this, metrics);
+        }
+    }
+
+    void flush(uint64_t nowMs)
+    {
+        if (m_signal.flush(nowMs))
+        {
+            onCellularSignalStrengthChanged.notify(this, m_lastSignal);
+        }
+        if (m_gsm.flush(nowMs))
+        {
+            onGsmMetrics.notify(this, m_lastGsm);
+        }
+        if (m_umts.flush(nowMs))
+        {
+            onUmtsMetrics.notify(this, m_lastUmts);
+        }
+        if (m_lte.flush(nowMs))
+        {
+            onLteMetrics.notify(this, m_lastLte);
+        }
+    }
+
+    void serviceGone()
+    {
+        m_service = NULL;
+    }
+
+private:
+    ConnManagerServiceStandIn* m_service;
+    CellularEventFilterState m_signal;
+    CellularEventFilterState m_gsm;
+    CellularEventFilterState m_umts;
+    CellularEventFilterState m_lte;
+    unsigned char m_lastSignal;
+    GsmMetrics m_lastGsm;
+    UmtsMetrics m_lastUmts;
+    LteMetrics m_lastLte;
+};
+
+const unsigned int ConnManagerServiceStandIn::PREDICTION_HORIZON_S;
+
+ConnManagerServiceStandIn::ConnManagerServiceStandIn(time_t startTime): m_wifi(NULL), m_startTime(startTime),
+    m_nowMs(0), m_nextStep(0), m_signalNotified(false), m_signalBand(ConMgrBand_Lost), m_dataPath(ConMgrDataPath_None),
+    m_garageBox(false), m_positionValid(false), m_latitude(0), m_longitude(0)
+{
+    m_apnAvailable[ApnName_Public] = false;
+    m_apnAvailable[ApnName_Telematic] = false;
+}
+
+ConnManagerServiceStandIn::ConnManagerServiceStandIn(time_t startTime, WifiServiceProviderStandIn& wifi): m_wifi(&wifi),
+    m_startTime(startTime), m_nowMs(0), m_nextStep(0), m_signalNotified(false), m_signalBand(ConMgrBand_Lost),
+    m_dataPath(ConMgrDataPath_None), m_garageBox(false), m_positionValid(false), m_latitude(0), m_longitude(0)
+{
+    m_apnAvailable[ApnName_Public] = false;
+    m_apnAvailable[ApnName_Telematic] = false;
+    updateDataPath();
+}
+
+ConnManagerServiceStandIn::~ConnManagerServiceStandIn()
+{
+    for (std::vector<Subscription*>::iterator it = m_subscriptions.begin(); it != m_subscriptions.end(); ++it)
+    {
+        (*it)->serviceGone();
+    }
+}
+
+bool ConnManagerServiceStandIn::load(std::istream& script, std::string& error)
+{
+    Lock lock(m_mutex);
+    ConnectivityScenario scenario;
+    if (!scenario.parse(script, error))
+    {
+        return false;
+    }
+    for (std::vector<ConnectivityScenario::Step>::const_iterator it = scenario.getSteps().begin();
+        it != scenario.getSteps().end(); ++it)
+    {
+        if (!check(*it, error))
+        {
+            return false;
+        }
+    }
+    m_scenario = scenario;
+    m_nextStep = 0;
+    return true;
+}
+
+bool ConnManagerServiceStandIn::runUntil(uint64_t nowMs)
+{
+    Lock lock(m_mutex);
+    const std::vector<ConnectivityScenario::Step>& steps = m_scenario.getSteps();
+    while ((m_nextStep < steps.size()) && (steps[m_nextStep].timeMs <= nowMs))
+    {
+        m_nowMs = std::max(m_nowMs, steps[m_nextStep].timeMs);
+        apply(steps[m_nextStep]);
+        ++m_nextStep;
+    }
+    m_nowMs = std::max(m_nowMs, nowMs);
+
+    SubscriptionList subscriptions;
+    copySubscriptions(subscriptions);
+    for (SubscriptionList::iterator it = subscriptions.begin(); it != subscriptions.end(); ++it)
+    {
+        (*it)->flush(m_nowMs);
+    }
+    // The prediction, the budget period and the deadlines move with the clock.
+    updateScheduler();
+    return m_nextStep < steps.size();
+}
+
+ConMgrErrno ConnManagerServiceStandIn::getCellularNetworkType(ConMgrNetworkType& result)
+{
+    RadioSnapshot snapshot;
+    m_radio.get(snapshot);
+    result = snapshot.network_type;
+    return ConMgrErr_OK;
+}
+
+ConMgrErrno ConnManagerServiceStandIn::getApnConState(ConApnName interface, bool& result)
+{
+    if ((interface != ApnName_Public) && (interface != ApnName_Telematic))
+    {
+        return ConMgrErr_InvalidArgument;
+    }
+    Lock lock(m_mutex);
+    result = m_apnAvailable[interface];
+    return ConMgrErr_OK;
+}
+
+ConMgrErrno ConnManagerServiceStandIn::getCellularMCC(int& result)
+{
+    RadioSnapshot snapshot;
+    m_radio.get(snapshot);
+    result = snapshot.registration.mcc;
+    return ConMgrErr_OK;
+}
+
+ConMgrErrno ConnManagerServiceStandIn::getWiFiDataConState(bool& result)
+{
+    Lock lock(m_mutex);
+    result = (m_dataPath == ConMgrDataPath_Wifi);
+    return ConMgrErr_OK;
+}
+
+ConMgrErrno ConnManagerServiceStandIn::getCellularSignalStrength(unsigned char& result)
+{
+    RadioSnapshot snapshot;
+    m_radio.get(snapshot);
+    result = snapshot.signal_strength;
+    return ConMgrErr_OK;
+}
+
+ConMgrErrno ConnManagerServiceStandIn::getCellularModemAvailability(bool& result)
+{
+    RadioSnapshot snapshot;
+    m_radio.get(snapshot);
+    result = snapshot.modem_available;
+    return ConMgrErr_OK;
+}
+
+ConMgrErrno ConnManagerServiceStandIn::getGsmMetrics(GsmMetrics& result)
+{
+    RadioSnapshot snapshot;
+    m_radio.get(snapshot);
+    result = snapshot.gsm;
+    return ConMgrErr_OK;
+}
+
+ConMgrErrno ConnManagerServiceStandIn::getUmtsMetrics(UmtsMetrics& result)
+{
+    RadioSnapshot snapshot;
+    m_radio.get(snapshot);
+    result = snapshot.umts;
+    return ConMgrErr_OK;
+}
+
+ConMgrErrno ConnManagerServiceStandIn::getLteMetrics(LteMetrics& result)
+{
+    RadioSnapshot snapshot;
+    m_radio.get(snapshot);
+    result = snapshot.lte;
+    return ConMgrErr_OK;
+}
+
+ConMgrErrno ConnManagerServiceStandIn::getCellularNbCells(CellularNbCells& result)
+{
+    RadioSnapshot snapshot;
+    m_radio.get(snapshot);
+    result = snapshot.nb_cells;
+    return ConMgrErr_OK;
+}
+
+ConMgrErrno ConnManagerServiceStandIn::getRegistrationStatus(RegistrationStatus& result)
+{
+    RadioSnapshot snapshot;
+    m_radio.get(snapshot);
+    result = snapshot.registration;
+    return ConMgrErr_OK;
+}
+
+ConMgrErrno ConnManagerServiceStandIn::getRadioSnapshot(RadioSnapshot& result)
+{
+    m_radio.get(result);
+    return ConMgrErr_OK;
+}
+
+ConMgrErrno ConnManagerServiceStandIn::setRadioSnapshotRefreshPeriod(unsigned int periodMs)
+{
+    // Nothing to query: the scenario notifies every change.
+    return m_radio.setRefreshPeriod(periodMs);
+}
+
+ConMgrErrno ConnManagerServiceStandIn::createCellularMetricsSubscription(const CellularEventFilter& filter,
+    ICellularMetricsSubscription::Ptr& result)
+{
+    Lock lock(m_mutex);
+    Subscription* subscription = new Subscription(*this, filter);
+    m_subscriptions.push_back(subscription);
+    result = subscription;
+    return ConMgrErr_OK;
+}
+
+ConMgrErrno ConnManagerServiceStandIn::getLinkQualityHistory(time_t since, std::vector<LinkQualitySample>& result)
+{
+    Lock lock(m_mutex);
+    m_history.getSamples(since, result);
+    return ConMgrErr_OK;
+}
+
+ConMgrErrno ConnManagerServiceStandIn::getLinkQualityPrediction(unsigned int horizonS, LinkQualityPrediction& result)
+{
+    if (horizonS == 0)
+    {
+        return ConMgrErr_InvalidArgument;
+    }
+    Lock lock(m_mutex);
+    m_history.predict(now(), horizonS, m_positionValid, m_latitude, m_longitude, result);
+    return ConMgrErr_OK;
+}
+
+ConMgrErrno ConnManagerServiceStandIn::requestTransfer(const TransferRequest& request, unsigned int& transferId)
+{
+    if ((request.apn != ApnName_Public) && (request.apn != ApnName_Telematic))
+    {
+        return ConMgrErr_InvalidArgument;
+    }
+    Lock lock(m_mutex);
+    transferId = m_scheduler.submit(request);
+    schedule();
+    return ConMgrErr_OK;
+}
+
+ConMgrErrno ConnManagerServiceStandIn::reportTransferProgress(unsigned int transferId, uint64_t bytes)
+{
+    Lock lock(m_mutex);
+    const ConMgrErrno result = m_scheduler.progress(transferId, bytes, now());
+    if (result == ConMgrErr_OK)
+    {
+        schedule();
+    }
+    return result;
+}
+
+ConMgrErrno ConnManagerServiceStandIn::releaseTransfer(unsigned int transferId)
+{
+    Lock lock(m_mutex);
+    const ConMgrErrno result = m_scheduler.release(transferId);
+    if (result == ConMgrErr_OK)
+    {
+        schedule();
+    }
+    return result;
+}
+
+ConMgrErrno ConnManagerServiceStandIn::setTransferSchedulerConfig(const TransferSchedulerConfig& config)
+{
+    Lock lock(m_mutex);
+    const ConMgrErrno result = m_scheduler.setConfig(config);
+    if (result == ConMgrErr_OK)
+    {
+        schedule();
+    }
+    return result;
+}
+
+ConMgrErrno ConnManagerServiceStandIn::getCellularTime(DateTime& result)
+{
+    Lock lock(m_mutex);
+    result = DateTime();
+    result.local_time = now();
+    return ConMgrErr_OK;
+}
+
+ConMgrErrno ConnManagerServiceStandIn::getSystemTime(time_t& result)
+{
+    Lock lock(m_mutex);
+    result = now();
+    return ConMgrErr_OK;
+}
+
+ConMgrErrno ConnManagerServiceStandIn::getDataPath(std::string& result)
+{
+    Lock lock(m_mutex);
+    result = dataPathName(m_dataPath);
+    return ConMgrErr_OK;
+}
+
+ConMgrErrno ConnManagerServiceStandIn::setGarageBoxMode(bool isGarageBox)
+{
+    Lock lock(m_mutex);
+    m_garageBox = isGarageBox;
+    updateScheduler();
+    return ConMgrErr_OK;
+}
+
+ConMgrErrno ConnManagerServiceStandIn::getGarageBoxMode(bool& isDataAllowed)
+{
+    Lock lock(m_mutex);
+    isDataAllowed = !m_garageBox;
+    return ConMgrErr_OK;
+}
+
+bool ConnManagerServiceStandIn::check(const ConnectivityScenario::Step& step, std::string& error) const
+{
+    const std::vector<std::string>& args = step.arguments;
+    const size_t count = args.size();
+    long number = 0;
+    double real = 0;
+    bool flag = false;
+    ConMgrNetworkType networkType;
+    ConMgrRegistrationStatus status;
+    ConApnName apn;
+    WiFiServerNetState_e mode;
+    WiFiServerSecurity_e security;
+    WiFiServerIF_ServiceState_e state;
+
+    bool valid = false;
+    if (step.command == "modem")
+    {
+        valid = (count == 1) && parseOnOff(args[0], "on", "off", flag);
+    }
+    else if (step.command == "network")
+    {
+        valid = (count == 1) && parseNetworkType(args[0], networkType);
+    }
+    else if (step.command == "signal")
+    {
+        valid = (count == 1) && parseLong(args[0], 0, 255, number) && ((number <= 100) || (number == 255));
+    }
+    else if (step.command == "gsm")
+    {
+        valid = (count == 2) && parseLong(args[0], -128, 127, number) && parseLong(args[1], 0, 255, number);
+    }
+    else if (step.command == "umts")
+    {
+        valid = (count == 4) && parseLong(args[0], -128, 127, number) && parseLong(args[1], -32768, 32767, number)
+            && parseLong(args[2], -32768, 32767, number) && parseLong(args[3], 0, 65535, number);
+    }
+    else if (step.command == "lte")
+    {
+        valid = (count == 4) && parseLong(args[0], -128, 127, number) && parseLong(args[1], -128, 127, number)
+            && parseLong(args[2], -32768, 32767, number) && parseLong(args[3], -32768, 32767, number);
+    }
+    else if (step.command == "nbcells")
+    {
+        valid = (count == 3) && parseLong(args[0], 0, 255, number) && parseLong(args[1], 0, 255, number)
+            && parseLong(args[2], 0, 255, number);
+    }
+    else if (step.command == "register")
+    {
+        valid = ((count == 1) || (count == 3) || (count == 4)) && parseRegistrationStatus(args[0], status)
+            && ((count == 1) || (parseLong(args[1], 0, 999, number) && parseLong(args[2], 0, 999, number)))
+            && ((count < 4) || (args[3].size() < MAX_NETWORK_NAME_LEN));
+    }
+    else if (step.command == "apn")
+    {
+        valid = (count == 2) && parseApn(args[0], apn) && parseOnOff(args[1], "up", "down", flag);
+    }
+    else if (step.command == "position")
+    {
+        valid = ((count == 1) && (args[0] == "none"))
+            || ((count == 2) && parseDouble(args[0], -90, 90, real) && parseDouble(args[1], -180, 180, real));
+    }
+    else if (step.command == "mode")
+    {
+        valid = (m_wifi != NULL) && (count == 1) && parseWifiMode(args[0], mode);
+    }
+    else if (step.command == "bss")
+    {
+        valid = (m_wifi != NULL) && (count == 5) && parseLong(args[2], 0, 255, number)
+            && parseLong(args[3], 0, 255, number) && parseWifiSecurity(args[4], security);
+    }
+    else if (step.command == "lost")
+    {
+        valid = (m_wifi != NULL) && (count == 1);
+    }
+    else if (step.command == "scan")
+    {
+        valid = (m_wifi != NULL) && (count == 0);
+    }
+    else if (step.command == "state")
+    {
+        valid = (m_wifi != NULL) && ((count == 1) || (count == 2)) && parseWifiState(args[0], state);
+    }
+
+    if (!valid)
+    {
+        char line[16];
+        snprintf(line, sizeof(line), "%u", step.line);
+        error = std::string("line ") + line + ": invalid " + step.command;
+    }
+    return valid;
+}
+
+void ConnManagerServiceStandIn::apply(const ConnectivityScenario::Step& step)
+{
+    const std::vector<std::string>& args = step.arguments;
+    const time_t time = now();
+    RadioSnapshot before;
+    m_radio.get(before);
+
+    if (step.command == "modem")
+    {
+        bool available = false;
+        parseOnOff(args[0], "on", "off", available);
+        m_radio.setModemAvailability(available, time);
+    }
+    else if (step.command == "network")
+    {
+        ConMgrNetworkType networkType = ConMgrNtwType_Unknown;
+        parseNetworkType(args[0], networkType);
+        m_radio.setNetworkType(networkType, time);
+    }
+    else if (step.command == "signal")
+    {
+        m_radio.setSignalStrength(static_cast<unsigned char>(atoi(args[0].c_str())), time);
+    }
+    else if (step.command == "gsm")
+    {
+        GsmMetrics metrics;
+        metrics.raw_rssi = static_cast<signed char>(atoi(args[0].c_str()));
+        metrics.bler = static_cast<unsigned char>(atoi(args[1].c_str()));
+        m_radio.setGsmMetrics(metrics, time);
+    }
+    else if (step.command == "umts")
+    {
+        UmtsMetrics metrics;
+        metrics.raw_rssi = static_cast<signed char>(atoi(args[0].c_str()));
+        metrics.rscp = static_cast<short int>(atoi(args[1].c_str()));
+        metrics.ecio = static_cast<short int>(atoi(args[2].c_str()));
+        metrics.bler = static_cast<unsigned short int>(atoi(args[3].c_str()));
+        m_radio.setUmtsMetrics(metrics, time);
+    }
+    else if (step.command == "lte")
+    {
+        LteMetrics metrics;
+        metrics.raw_rssi = static_cast<signed char>(atoi(args[0].c_str()));
+        metrics.rsrq = static_cast<signed char>(atoi(args[1].c_str()));
+        metrics.rsrp = static_cast<short int>(atoi(args[2].c_str()));
+        metrics.snr = static_cast<short int>(atoi(args[3].c_str()));
+        m_radio.setLteMetrics(metrics, time);
+    }
+    else if (step.command == "nbcells")
+    {
+        CellularNbCells nbCells;
+        nbCells.num_gsm_cells = static_cast<unsigned char>(atoi(args[0].c_str()));
+        nbCells.num_wcdma_cells = static_cast<unsigned char>(atoi(args[1].c_str()));
+        nbCells.num_lte_cells = static_cast<unsigned char>(atoi(args[2].c_str()));
+        m_radio.setNbCells(nbCells, time);
+    }
+    else if (step.command == "register")
+    {
+        RegistrationStatus registration = before.registration;
+        ConMgrRegistrationStatus status = NADIF_REG_STAT_UNKNOWN;
+        parseRegistrationStatus(args[0], status);
+        registration.cs_reg_status = status;
+        registration.ps_reg_status = status;
+        registration.network_type = before.network_type;
+        if (args.size() >= 3)
+        {
+            registration.mcc = static_cast<unsigned short int>(atoi(args[1].c_str()));
+            registration.mnc = static_cast<unsigned short int>(atoi(args[2].c_str()));
+        }
+        if (args.size() == 4)
+        {
+            strncpy(registration.network_name, args[3].c_str(), MAX_NETWORK_NAME_LEN - 1);
+            registration.network_name[MAX_NETWORK_NAME_LEN - 1] = '\0';
+        }
+        m_radio.setRegistrationStatus(registration, time);
+    }
+    else if (step.command == "apn")
+    {
+        APNConnState state;
+        parseApn(args[0], state.interface);
+        parseOnOff(args[1], "up", "down", state.available);
+        if (m_apnAvailable[state.interface] != state.available)
+        {
+            m_apnAvailable[state.interface] = state.available;
+            onApnConStateChanged.notify(this, state);
+        }
+    }
+    else if (step.command == "position")
+    {
+        m_positionValid = (args.size() == 2);
+        m_latitude = m_positionValid ? strtod(args[0].c_str(), NULL) : 0;
+        m_longitude = m_positionValid ? strtod(args[1].c_str(), NULL) : 0;
+    }
+    else
+    {
+        applyWifi(step);
+    }
+
+    RadioSnapshot after;
+    m_radio.get(after);
+    if (after.version != before.version)
+    {
+        if (after.modem_available != before.modem_available)
+        {
+            onCellularModemAvailabilityChanged.notify(this, after.modem_available);
+        }
+        if (after.network_type != before.network_type)
+        {
+            onCellularNetworkTypeChanged.notify(this, after.network_type);
+        }
+        if (step.command == "nbcells")
+        {
+            onCellularNbCellsChanged.notify(this, after.nb_cells);
+        }
+        if (step.command == "register")
+        {
+            onRegistrationStatusChanged.notify(this, after.registration);
+            if (after.registration.mcc != before.registration.mcc)
+            {
+                const int mcc = after.registration.mcc;
+                onCellularMCCChanged.notify(this, mcc);
+            }
+        }
+        if ((step.command == "signal") || (step.command == "network"))
+        {
+            notifySignalStrength(after);
+        }
+        if ((step.command == "gsm") || (step.command == "umts") || (step.command == "lte"))
+        {
+            notifyMetrics(after);
+        }
+    }
+
+    const bool dataPathChanged = updateDataPath();
+    if ((step.command == "network") || (step.command == "lte") || (step.command == "register")
+        || (step.command == "position") || dataPathChanged)
+    {
+        recordSample();
+    }
+    updateScheduler();
+}
+
+void ConnManagerServiceStandIn::applyWifi(const ConnectivityScenario::Step& step)
+{
+    const std::vector<std::string>& args = step.arguments;
+    if (step.command == "mode")
+    {
+        WiFiServerNetState_e mode = TCU_STATE_OFF;
+        parseWifiMode(args[0], mode);
+        m_wifi->applyMode(mode);
+    }
+    else if (step.command == "bss")
+    {
+        WifiServerServiceConfig service;
+        service.mac = args[0];
+        service.ssid = args[1];
+        service.rssi = static_cast<unsigned int>(atoi(args[2].c_str()));
+        service.channel = static_cast<unsigned int>(atoi(args[3].c_str()));
+        service.cipher = "";
+        service.IEE_802_11_mode = WIFI_SERVER_STD_IEEE80211_UNKNOWN;
+        service.connection_status = WIFI_SERVER_STATE_DISCONNECTED;
+        service.securityMode = WIFI_SERVER_SECURITYLEVEL_NONE;
+        parseWifiSecurity(args[4], service.securityMode);
+        m_wifi->applyBss(service);
+    }
+    else if (step.command == "lost")
+    {
+        m_wifi->applyLost(args[0]);
+    }
+    else if (step.command == "scan")
+    {
+        m_wifi->applyScan();
+    }
+    else if (step.command == "state")
+    {
+        WiFiServerIF_ServiceState_e state = WIFI_SERVER_STATE_DISCONNECTED;
+        parseWifiState(args[0], state);
+        if (args.size() == 2)
+        {
+            m_wifi->applyState(state, args[1]);
+        }
+        else
+        {
+            m_wifi->applyState(state);
+        }
+    }
+}
+
+bool ConnManagerServiceStandIn::updateDataPath()
+{
+    bool wifiConnected = false;
+    if (m_wifi != NULL)
+    {
+        WifiServerStatus status;
+        m_wifi->getWifiStatus(status);
+        wifiConnected = (status.connectionStatus == WIFI_SERVER_STATE_CONNECTED);
+    }
+    ConMgrDataPath dataPath = ConMgrDataPath_None;
+    if (wifiConnected)
+    {
+        dataPath = ConMgrDataPath_Wifi;
+    }
+    else if (m_apnAvailable[ApnName_Public])
+    {
+        dataPath = ConMgrDataPath_Cellular;
+    }
+    if (dataPath == m_dataPath)
+    {
+        return false;
+    }
+
+    const bool wifiChanged = ((dataPath == ConMgrDataPath_Wifi) != (m_dataPath == ConMgrDataPath_Wifi));
+    m_dataPath = dataPath;
+    const std::string name(dataPathName(dataPath));
+    onDataPathChanged.notify(this, name);
+    if (wifiChanged)
+    {
+        onWifiDataConStateChanged.notify(this, wifiConnected);
+    }
+    return true;
+}
+
+time_t ConnManagerServiceStandIn::now() const
+{
+    return m_startTime + static_cast<time_t>(m_nowMs / 1000);
+}
+
+ConMgrSignalBand ConnManagerServiceStandIn::band(const RadioSnapshot& snapshot) const
+{
+    return getSignalBand(snapshot.network_type, snapshot.signal_strength);
+}
+
+void ConnManagerServiceStandIn::notifySignalStrength(const RadioSnapshot& snapshot)
+{
+    if (!m_signalNotified && (snapshot.signal_strength == 0xFF))
+    {
+        // Not available yet, e.g. a network type step before the first signal step.
+        return;
+    }
+    const ConMgrSignalBand signalBand = band(snapshot);
+    // The unfiltered event only fires when the value moves from one range to another.
+    if (!m_signalNotified || (signalBand != m_signalBand))
+    {
+        m_signalNotified = true;
+        m_signalBand = signalBand;
+        onCellularSignalStrengthChanged.notify(this, snapshot.signal_strength);
+    }
+    SubscriptionList subscriptions;
+    copySubscriptions(subscriptions);
+    for (SubscriptionList::iterator it = subscriptions.begin(); it != subscriptions.end(); ++it)
+    {
+        (*it)->offerSignalStrength(snapshot.signal_strength, signalBand, m_nowMs);
+    }
+}
+
+void ConnManagerServiceStandIn::notifyMetrics(const RadioSnapshot& snapshot)
+{
+    const ConMgrSignalBand signalBand = band(snapshot);
+    switch (snapshot.network_type)
+    {
+    case ConMgrNtwType_LTE:
+        onLteMetrics.notify(this, snapshot.lte);
+        break;
+    case ConMgrNtwType_WCDMA:
+        onUmtsMetrics.notify(this, snapshot.umts);
+        break;
+    default:
+        onGsmMetrics.notify(this, snapshot.gsm);
+        break;
+    }
+    SubscriptionList subscriptions;
+    copySubscriptions(subscriptions);
+    for (SubscriptionList::iterator it = subscriptions.begin(); it != subscriptions.end(); ++it)
+    {
+        switch (snapshot.network_type)
+        {
+        case ConMgrNtwType_LTE:
+            (*it)->offerLte(snapshot.lte, signalBand, m_nowMs);
+            break;
+        case ConMgrNtwType_WCDMA:
+            (*it)->offerUmts(snapshot.umts, signalBand, m_nowMs);
+            break;
+        default:
+            (*it)->offerGsm(snapshot.gsm, signalBand, m_nowMs);
+            break;
+        }
+    }
+}
+
+void ConnManagerServiceStandIn::copySubscriptions(SubscriptionList& result) const
+{
+    // A delegate may release its subscription, or create one, while the events are notified: they are notified on
+    // a copy of the list, each subscription being held until the end of the notifications.
+    result.clear();
+    result.reserve(m_subscriptions.size());
+    for (std::vector<Subscription*>::const_iterator it = m_subscriptions.begin(); it != m_subscriptions.end(); ++it)
+    {
+        result.push_back(Poco::AutoPtr<Subscription>(*it, true));
+    }
+}
+
+void ConnManagerServiceStandIn::recordSample()
+{
+    RadioSnapshot snapshot;
+    m_radio.get(snapshot);
+    LinkQualitySample sample;
+    sample.timestamp = now();
+    sample.network_type = snapshot.network_type;
+    sample.rsrp = snapshot.lte.rsrp;
+    sample.rsrq = snapshot.lte.rsrq;
+    sample.snr = snapshot.lte.snr;
+    sample.ps_reg_status = snapshot.registration.ps_reg_status;
+    sample.data_path = m_dataPath;
+    sample.position_valid = m_positionValid;
+    sample.latitude = m_latitude;
+    sample.longitude = m_longitude;
+    m_history.record(sample);
+}
+
+void ConnManagerServiceStandIn::updateScheduler()
+{
+    RadioSnapshot snapshot;
+    m_radio.get(snapshot);
+    const bool cellular = snapshot.modem_available && !m_garageBox;
+    m_scheduler.setWifiAvailable(m_dataPath == ConMgrDataPath_Wifi);
+    m_scheduler.setApnAvailable(ApnName_Public, cellular && m_apnAvailable[ApnName_Public]);
+    m_scheduler.setApnAvailable(ApnName_Telematic, cellular && m_apnAvailable[ApnName_Telematic]);
+
+    LinkQualityPrediction prediction;
+    m_history.predict(now(), PREDICTION_HORIZON_S, m_positionValid, m_latitude, m_longitude, prediction);
+    m_scheduler.setCellularPrediction(prediction);
+    schedule();
+}
+
+void ConnManagerServiceStandIn::schedule()
+{
+    std::vector<TransferGrant> granted;
+    std::vector<unsigned int> paused;
+    m_scheduler.schedule(now(), granted, paused);
+    for (std::vector<unsigned int>::const_iterator it = paused.begin(); it != paused.end(); ++it)
+    {
+        onTransferPaused.notify(this, *it);
+    }
+    for (std::vector<TransferGrant>::const_iterator it = granted.begin(); it != granted.end(); ++it)
+    {
+        onTransferGranted.notify(this, *it);
+    }
+}
+
+void ConnManagerServiceStandIn::detach(Subscription* subscription)
+{
+    Lock lock(m_mutex);
+    m_subscriptions.erase(std::remove(m_subscriptions.begin(), m_subscriptions.end(), subscription),
+        m_subscriptions.end());
+}
+
+}
+}
@@ -0,0 +1,180 @@
+/**
+ * \file
+ *         ConnManagerServiceStandIn.h
+ * \brief
+ *         Connection manager service replaying a scenario script, for offline runs on a X86 PC target
+ *
+ * \par Copyright Notice:
+ * \verbatim
+ * Copyright (c) 2021 Stellantis N.V.
+ * All Rights Reserved.
+ * The reproduction, transmission or use of this document or its contents is
+ * not permitted without express written authority.
+ * Offenders will be liable for damages. All rights, including rights created
+ * by patent grant or registration of a utility model or design, are reserved.
+ * \endverbatim
+ */
+
+#ifndef CONNMANAGERSERVICESTANDIN_H
+#define CONNMANAGERSERVICESTANDIN_H
+
+#include <istream>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#include "IConnManagerService.h"
+#include "ConnectivityScenario.h"
+#include "CellularEventFilterState.h"
+#include "LinkQualityHistory.h"
+#include "RadioSnapshotCache.h"
+#include "TransferScheduler.h"
+#include "WifiServiceProviderStandIn.h"
+
+namespace Stla {
+namespace Connectivity {
+
+/**
+ * ConnManagerServiceStandIn implements IConnManagerService from a scenario script instead of the modem, through the
+ * same radio cache, event filters, link quality history and transfer scheduler as the service. Given a
+ * \link WifiServiceProviderStandIn \endlink, it forwards the Wi-Fi steps of the script to it: both stand-ins then
+ * replay one script on one clock, so the transfer scheduler and the Wi-Fi offload engine see the same links.
+ *
+ * Script commands (see \link ConnectivityScenario \endlink for the line format):
+ * - modem on|off
+ * - network unknown|gsm|wcdma|lte|cdma1x|cdmaevdo
+ * - signal <0..100, 255>
+ * - gsm <raw_rssi> <bler>
+ * - umts <raw_rssi> <rscp> <ecio> <bler>
+ * - lte <raw_rssi> <rsrq> <rsrp> <snr>
+ * - nbcells <gsm> <wcdma> <lte>
+ * - register unknown|notregistered|registered|limited|roaming|camped [<mcc> <mnc> [<network name>]]
+ *   (packet and circuit switch; a roaming step usually changes the mcc too)
+ * - apn public|telematic up|down
+ * - position <latitude> <longitude> | position none
+ *
+ * Wi-Fi commands, only with a Wi-Fi service provider stand-in:
+ * - mode off|enabling_sta|enabling_ap|sta|ap|disabling|recovering|failure
+ *   (out of sta, the service list is empty and the client is disconnected)
+ * - bss <mac> <ssid> <rssi> <channel> none|wpa_psk|wpa_eap|wpa2_wps|wpa2_psk|wpa2_eap|wep
+ *   (adds or updates a service of the next scan; the ssid has no spaces)
+ * - lost <mac> (removes a service from the next scan)
+ * - scan (publishes the services added by bss and not lost since)
+ * - state connecting|connected|disconnecting|disconnected|failure [<mac>]
+ *   (client connection state, on the service of the given mac address)
+ *
+ * The data path follows the links: wifi while the Wi-Fi client is connected, else cellular while the public APN is
+ * up, else none.
+ *
+ * The replay runs on a simulated clock: runUntil() applies the steps due and advances the clock, as fast as the
+ * caller wants (e.g. in a loop for a reproducible benchmark, or from a timer for a real-time run). The system time
+ * is the start time given at construction plus the simulated time.
+ *
+ * All the methods lock the stand-in, events are notified with the lock held: a delegate may call the stand-in back
+ * from the notifying thread, not wait for another thread doing so.
+ */
+class ConnManagerServiceStandIn : public IConnManagerService
+{
+public:
+    typedef Poco::AutoPtr<ConnManagerServiceStandIn> Ptr;
+
+    static const unsigned int PREDICTION_HORIZON_S = 60;
+
+    explicit ConnManagerServiceStandIn(time_t startTime);
+
+    /**
+     * @brief Stand-in forwarding the Wi-Fi steps of its script to wifi, which must outlive it.
+     */
+    ConnManagerServiceStandIn(time_t startTime, WifiServiceProviderStandIn& wifi);
+    virtual ~ConnManagerServiceStandIn();
+
+    /**
+     * @brief Load a scenario script, replayed from its first step. Its times are simulated times: the steps already
+     * due are applied by the next runUntil().
+     * @param[out] error Description of the first invalid line, on failure
+     * @return false if the script is invalid; the previous one is then kept.
+     */
+    bool load(std::istream& script, std::string& error);
+
+    /**
+     * @brief Apply the steps due up to nowMs, in order, then set the simulated clock to nowMs.
+     * @return false once all the steps are applied.
+     */
+    bool runUntil(uint64_t nowMs);
+
+    virtual ConMgrErrno getCellularNetworkType(ConMgrNetworkType& result);
+    virtual ConMgrErrno getApnConState(ConApnName interface, bool& result);
+    virtual ConMgrErrno getCellularMCC(int& result);
+    virtual ConMgrErrno getWiFiDataConState(bool& result);
+    virtual ConMgrErrno getCellularSignalStrength(unsigned char& result);
+    virtual ConMgrErrno getCellularModemAvailability(bool& result);
+    virtual ConMgrErrno getGsmMetrics(GsmMetrics& result);
+    virtual ConMgrErrno getUmtsMetrics(UmtsMetrics& result);
+    virtual ConMgrErrno getLteMetrics(LteMetrics& result);
+    virtual ConMgrErrno getCellularNbCells(CellularNbCells& result);
+    virtual ConMgrErrno getRegistrationStatus(RegistrationStatus& result);
+    virtual ConMgrErrno getRadioSnapshot(RadioSnapshot& result);
+    virtual ConMgrErrno setRadioSnapshotRefreshPeriod(unsigned int periodMs);
+    virtual ConMgrErrno createCellularMetricsSubscription(const CellularEventFilter& filter,
+        ICellularMetricsSubscription::Ptr& result);
+    virtual ConMgrErrno getLinkQualityHistory(time_t since, std::vector<LinkQualitySample>& result);
+    virtual ConMgrErrno getLinkQualityPrediction(unsigned int horizonS, LinkQualityPrediction& result);
+    virtual ConMgrErrno requestTransfer(const TransferRequest& request, unsigned int& transferId);
+    virtual ConMgrErrno reportTransferProgress(unsigned int transferId, uint64_t bytes);
+    virtual ConMgrErrno releaseTransfer(unsigned int transferId);
+    virtual ConMgrErrno setTransferSchedulerConfig(const TransferSchedulerConfig& config);
+    virtual ConMgrErrno getCellularTime(DateTime& result);
+    virtual ConMgrErrno getSystemTime(time_t& result);
+    virtual ConMgrErrno getDataPath(std::string& result);
+    virtual ConMgrErrno setGarageBoxMode(bool isGarageBox);
+    virtual ConMgrErrno getGarageBoxMode(bool& isDataAllowed);
+
+private:
+    class Subscription;
+    friend class Subscription;
+    typedef std::vector<Poco::AutoPtr<Subscription> > SubscriptionList;
+
+    ConnManagerServiceStandIn(const ConnManagerServiceStandIn&);
+    ConnManagerServiceStandIn& operator=(const ConnManagerServiceStandIn&);
+
+    bool check(const ConnectivityScenario::Step& step, std::string& error) const;
+    void apply(const ConnectivityScenario::Step& step);
+    void applyWifi(const ConnectivityScenario::Step& step);
+    bool updateDataPath();
+    time_t now() const;
+    ConMgrSignalBand band(const RadioSnapshot& snapshot) const;
+    void notifySignalStrength(const RadioSnapshot& snapshot);
+    void notifyMetrics(const RadioSnapshot& snapshot);
+    void copySubscriptions(SubscriptionList& result) const;
+    void recordSample();
+    void updateScheduler();
+    void schedule();
+    void detach(Subscription* subscription);
+
+    std::recursive_mutex m_mutex;
+    WifiServiceProviderStandIn* m_wifi;
+    time_t m_startTime;
+    uint64_t m_nowMs;
+    ConnectivityScenario m_scenario;
+    size_t m_nextStep;
+
+    RadioSnapshotCache m_radio;
+    LinkQualityHistory m_history;
+    TransferScheduler m_scheduler;
+    std::vector<Subscription*> m_subscriptions;
+
+    bool m_signalNotified;
+    ConMgrSignalBand m_signalBand;      // of the last onCellularSignalStrengthChanged
+    bool m_apnAvailable[2];
+    ConMgrDataPath m_dataPath;
+    bool m_garageBox;
+    bool m_positionValid;
+    double m_latitude;
+    double m_longitude;
+};
+
+}
+}
+
+#endif // CONNMANAGERSERVICESTANDIN_H
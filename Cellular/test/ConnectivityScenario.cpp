@@ -0,0 +1,82 @@
+/**
+ * \file
+ *         ConnectivityScenario.cpp
+ * \brief
+ *         Scenario script replayed by the connectivity stand-ins
+ *
+ * \par Copyright Notice:
+ * \verbatim
+ * Copyright (c) 2021 Stellantis N.V.
+ * All Rights Reserved.
+ * The reproduction, transmission or use of this document or its contents is
+ * not permitted without express written authority.
+ * Offenders will be liable for damages. All rights, including rights created
+ * by patent grant or registration of a utility model or design, are reserved.
+ * \endverbatim
+ */
+
+#include "ConnectivityScenario.h"
+
+#include <sstream>
+#include <stdlib.h>
+
+namespace Stla {
+namespace Connectivity {
+
+bool ConnectivityScenario::parse(std::istream& script, std::string& error)
+{
+    std::vector<Step> steps;
+    std::string text;
+    unsigned int line = 0;
+    while (std::getline(script, text))
+    {
+        ++line;
+        const std::string::size_type comment = text.find('#');
+        std::istringstream tokens(text.substr(0, comment));
+        std::string time;
+        if (!(tokens >> time))
+        {
+            continue;
+        }
+
+        std::ostringstream prefix;
+        prefix << "line " << line << ": ";
+        char* end = NULL;
+        const unsigned long long timeMs = strtoull(time.c_str(), &end, 10);
+        if ((time.find_first_not_of("0123456789") != std::string::npos) || (*end != '\0'))
+        {
+            error = prefix.str() + "invalid time " + time;
+            return false;
+        }
+        if (!steps.empty() && (timeMs < steps.back().timeMs))
+        {
+            error = prefix.str() + "time goes backwards";
+            return false;
+        }
+
+        Step step;
+        step.timeMs = timeMs;
+        step.line = line;
+        if (!(tokens >> step.command))
+        {
+            error = prefix.str() + "no command";
+            return false;
+        }
+        std::string argument;
+        while (tokens >> argument)
+        {
+            step.arguments.push_back(argument);
+        }
+        steps.push_back(step);
+    }
+    m_steps.swap(steps);
+    return true;
+}
+
+const std::vector<ConnectivityScenario::Step>& ConnectivityScenario::getSteps() const
+{
+    return m_steps;
+}
+
+}
+}
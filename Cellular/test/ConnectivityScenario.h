@@ -0,0 +1,62 @@
+/**
+ * \file
+ *         ConnectivityScenario.h
+ * \brief
+ *         Scenario script replayed by the connectivity stand-ins
+ *
+ * \par Copyright Notice:
+ * \verbatim
+ * Copyright (c) 2021 Stellantis N.V.
+ * All Rights Reserved.
+ * The reproduction, transmission or use of this document or its contents is
+ * not permitted without express written authority.
+ * Offenders will be liable for damages. All rights, including rights created
+ * by patent grant or registration of a utility model or design, are reserved.
+ * \endverbatim
+ */
+
+#ifndef CONNECTIVITYSCENARIO_H
+#define CONNECTIVITYSCENARIO_H
+
+#include <istream>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+namespace Stla {
+namespace Connectivity {
+
+/**
+ * ConnectivityScenario reads a scenario script: one step per line, "<time_ms> <command> [arguments]", separated by
+ * spaces, with # for comments. Times are relative to the start of the replay and must not decrease.
+ *
+ * The commands and their arguments are checked by the stand-in replaying the script.
+ */
+class ConnectivityScenario
+{
+public:
+    struct Step
+    {
+        uint64_t timeMs;
+        std::string command;
+        std::vector<std::string> arguments;
+        unsigned int line;
+    };
+
+    /**
+     * @brief Read a script.
+     * @param[out] error Description of the first invalid line, on failure
+     * @return false if a line has no command or its time is invalid; the previous steps are then kept.
+     */
+    bool parse(std::istream& script, std::string& error);
+
+    const std::vector<Step>& getSteps() const;
+
+private:
+    std::vector<Step> m_steps;
+};
+
+}
+}
+
+#endif // CONNECTIVITYSCENARIO_H
@@ -29,7 +29,8 @@
 #include "Poco/BasicEvent.h"
 
 //To do - Logger file header addition
-#include "Poco/Logger.h
+#include "Poco/Logger.h"
+#include "Poco/Channel.h"
 
 /* Logging Service bundle includes */
 
@@ -77,13 +78,28 @@ public:
 		 * @param[in]  nLC_activation : Nb of cycles given by application for automatic activation at start up. Maximum to be defined with STLA.		 		 
 		 * @return  Returns 1 for valid request
          * \n       Returns 0 if the request is ignored.
+		 * @note The filter is parsed once when the request is accepted and compiled into packed (AppId, CtxID) keys (see packLogId()),
+		 * \n records are not string-compared. Returns 0 if an identifier of the filter is empty or longer than 4 characters.
          */
 		 //To Do 
 		virtual bool startLogStorage(Poco::Priority loglevel, std::string filter ,  int nLC_activation) = 0;	
 
+		/**
+         * @brief Starts storing logs with a priority threshold per (AppId, CtxID) pair, until stopLogStorage is called.
+		 \n Same behaviour as startLogStorage(Poco::Priority, std::string, int) otherwise: parallel requests are not supported.
+         *
+		 * @param[in]   filter : list of (AppId, CtxID, loglevel) entries, see sLogFilterEntry_t. An empty list stores all logs of all applications
+		 * \n with priority PRIO_INFORMATION or higher.
+		 * @param[in]  nLC_activation : Nb of cycles given by application for automatic activation at start up. Maximum to be defined with STLA.
+		 * @return  Returns 1 for valid request
+         * \n       Returns 0 if the request is ignored or if an identifier of the filter is invalid.
+         */
+		virtual bool startLogStorage(const std::list<sLogFilterEntry_t>& filter, int nLC_activation) = 0;
+
 		/**
 		 * @brief Stops the storing logs if already started. 
 		 \n This is \b implicit request if LOG_STORAGE_LIMIT is reached.
+		 \n When rotation is enabled with setLogStorageConfig(), the oldest segment is overwritten instead.
 		 \n The request is ignored , if startLogStorage() was not initiated or if already LOG_STORAGE_LIMIT is reached.
 		 * @return  Returns 1 for valid request
          * \n       Returns 0 if the request is ignored.
@@ -99,17 +115,136 @@ public:
          */
 		virtual int getStoredLogs(int logType=0) = 0;
 		
+		/**
+		 * @brief Configure the segmented log storage (segment size, number of segments, compression and rotation).
+		 \n The configuration is applied from the next segment; existing segments are kept.
+		 * @param[in]   config : storage configuration, see sLogStorageConfig_t
+		 * @return  SUCCESS if the configuration is applied
+		 * \n       ERROR if the total size exceeds LOG_STORAGE_LIMIT or the operation failed
+		 */
+		virtual Logging_Error_t setLogStorageConfig(const sLogStorageConfig_t& config) = 0;
+
+		/**
+		 * @brief Get the segments overlapping a time window and containing records of an application.
+		 \n Only the segment index is read, segment contents are not scanned.
+		 * @param[in]   fromTime : start of the window in milliseconds since epoch (UTC), 0 for no lower bound
+		 * @param[in]   toTime : end of the window in milliseconds since epoch (UTC), 0 for no upper bound
+		 * @param[in]   appId : application identifier the segments must contain, empty for all applications
+		 * @param[out]  segments : matching segments sorted by segmentId
+		 * @return  SUCCESS if the index is read, segments may be empty
+		 * \n       ERROR if operation is failed
+		 */
+		virtual Logging_Error_t getLogSegments(uint64_t fromTime, uint64_t toTime, const std::string& appId, std::list<sLogSegmentInfo_t>& segments) = 0;
+
+		/**
+		 * @brief Get Stored Log segment
+		 *
+		 * @param[in]   segmentId : identifier of the segment as returned by getLogSegments()
+		 * @return  Returns the file descriptor to the segment file, content is compressed as given by sLogSegmentInfo_t::compression.
+		 * \n       Returns -1 if there is no such segment (e.g. it has been rotated out)
+		 */
+		virtual int getLogSegment(unsigned int segmentId) = 0;
+
+		/**
+		 * @brief Stream a range of log storage segments directly to a destination descriptor.
+		 \n The copy is done by the kernel when possible, so multi-megabyte traces are not read into application buffers.
+		 \n The call returns when the whole range is written or on the first error.
+		 * @param[in]   destFd : descriptor opened for writing, e.g. a connected local socket or a file opened in a DSS namespace
+		 * @param[in]   request : segment range and compression, see sLogExportRequest_t
+		 * @param[out]  bytesWritten : number of bytes written to destFd, also set on error
+		 * @return  SUCCESS if the whole range is written
+		 * \n       ERROR_INVALID_ARGUMENT if destFd is not writable or a segment of the range does not exist
+		 * \n       ERROR if operation is failed
+		 */
+		virtual Logging_Error_t exportLogs(int destFd, const sLogExportRequest_t& request, uint64_t& bytesWritten) = 0;
+
+		/**
+		 * @brief Get the volume stored per (AppId, CtxID) pair, to identify which application fills LOG_STORAGE_LIMIT.
+		 * @param[out]  volume : one entry per pair having stored at least one record, sorted by decreasing bytesStored
+		 * @return  SUCCESS if the counters are retrieved
+		 * \n       ERROR if operation is failed
+		 */
+		virtual Logging_Error_t getLogVolume(std::list<sLogVolumeEntry_t>& volume) = 0;
+
+		/**
+		 * @brief Reset the counters returned by getLogVolume().
+		 * @return  SUCCESS if the counters are reset
+		 * \n       ERROR if operation is failed
+		 */
+		virtual Logging_Error_t resetLogVolume() = 0;
+
 		/**
 		 * @brief Notify when log storage stops (stopLogStorage request or reaching LOG_STORAGE_LIMIT)
+		 \n Not notified when LOG_STORAGE_LIMIT is reached with rotation enabled (see sLogStorageConfig_t).
 		*/
 		Poco::BasicEvent<void> logStorageStopped;
 		
+		/**
+		 * @brief Configure the event capture ring, which keeps recent records in memory independently of startLogStorage().
+		 * @param[in]   config : capture configuration, see sLogCaptureConfig_t
+		 * @return  SUCCESS if the configuration is applied
+		 * \n       ERROR_INVALID_ARGUMENT if a value is out of range
+		 * \n       ERROR if operation is failed
+		 */
+		virtual Logging_Error_t setLogCaptureConfig(const sLogCaptureConfig_t& config) = 0;
+
+		/**
+		 * @brief Enable or disable an automatic capture trigger (DTC confirmation, eCall start).
+		 \n LOG_TRIGGER_APPLICATION is always enabled.
+		 * @param[in]   trigger : trigger source
+		 * @param[in]   enable : true to start a capture on this trigger
+		 * @return  SUCCESS if the trigger is updated
+		 * \n       ERROR_INVALID_ARGUMENT if trigger is LOG_TRIGGER_APPLICATION
+		 */
+		virtual Logging_Error_t setLogCaptureTrigger(Logging_CaptureTrigger_t trigger, bool enable) = 0;
+
+		/**
+		 * @brief Freeze the capture ring and store the records around now into log storage.
+		 \n A trigger received while a capture is running extends its post-trigger duration.
+		 * @param[in]   reason : free text stored with the capture
+		 * @return  SUCCESS if the capture is started
+		 * \n       ERROR if the capture ring is disabled or operation is failed
+		 */
+		virtual Logging_Error_t triggerLogCapture(const std::string& reason) = 0;
+
+		/**
+		 * @brief Notify when an event capture is written to log storage.
+		*/
+		Poco::BasicEvent<const sLogCaptureInfo_t> logCaptureCompleted;
+
 		/**
 		 * @brief clearLogStorage function to clear all stored logs 
 		 * @return  SUCCESS if Log storage is cleared
          * \n       ERROR if operation is failed 
         */
 		virtual Logging_Error_t clearLogStorage() = 0; 
+
+		/**
+		 * @brief Get the buffered log channel of the logging service.
+		 \n Records written to this channel are queued in a lock-free ring owned by the calling thread and
+		 \n written to log storage in batches by the flusher thread of the service, so the writer never waits on file I/O.
+		 \n The channel can be set on a Poco::Logger in place of a file or console channel.
+		 * @return  Pointer to the channel, shared by all bundles.
+		 * \n       Null pointer if the logging service is not ready.
+		 */
+		virtual Poco::AutoPtr<Poco::Channel> getLogChannel() = 0;
+
+		/**
+		 * @brief Configure the buffered log channel (ring size, flush batching and overflow policy).
+		 \n The new ring capacity applies to rings created after the call; batching and overflow policy apply immediately.
+		 * @param[in]   config : channel configuration, see sLogChannelConfig_t
+		 * @return  SUCCESS if the configuration is applied
+		 * \n       ERROR if a value is out of range or the operation failed
+		 */
+		virtual Logging_Error_t setLogChannelConfig(const sLogChannelConfig_t& config) = 0;
+
+		/**
+		 * @brief Get the counters of the buffered log channel, including the number of dropped records.
+		 * @param[out]  stats : channel counters, see sLogChannelStats_t
+		 * @return  SUCCESS if the counters are retrieved
+		 * \n       ERROR if operation is failed
+		 */
+		virtual Logging_Error_t getLogChannelStats(sLogChannelStats_t& stats) = 0;
 				
         /**
         * @brief Returns the type information for the object's class
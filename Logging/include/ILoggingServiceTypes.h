@@ -17,6 +17,8 @@
 
 #include <string>
 #include <list>
+#include <cstdint>
+#include "Poco/Logger.h"
 #ifndef LOGGING_SERVICE_TYPES_H_
 #define LOGGING_SERVICE_TYPES_H_
 
@@ -32,9 +34,189 @@ namespace LoggingService
 enum Logging_Error_t
 {
     SUCCESS,                  /**< Returned in case of success operation */
-    ERROR                    /**< Returned in case of operation failure due to an internal communication error */    
+    ERROR,                   /**< Returned in case of operation failure due to an internal communication error */    
+    ERROR_INVALID_ARGUMENT   /**< Returned when an invalid argument is passed to the API */
 };
 
+/**
+ * \brief The Logging_OverflowPolicy_t defines the behaviour of the log channel when the per-thread buffer of the writer is full.
+ */
+//@serialize
+enum Logging_OverflowPolicy_t
+{
+    LOG_OVERFLOW_DROP_OLDEST,   /**< The oldest pending record of the writer thread is discarded to make room for the new one */
+    LOG_OVERFLOW_DROP_NEWEST,   /**< The new record is discarded, pending records are kept */
+    LOG_OVERFLOW_BLOCK          /**< The writer thread waits until the flusher has drained its buffer */
+};
+
+/**
+ *  \brief  sLogChannelConfig_t to configure the buffered log channel returned by getLogChannel().
+ *  \details Each writer thread owns a single-producer/single-consumer ring of ringCapacity records.
+ *  All rings are drained by one background flusher thread which writes at most flushBatchSize records per batch.
+ */
+typedef struct LogChannelConfig
+{
+	unsigned int ringCapacity;                /**< Number of records buffered per writer thread, rounded up to a power of two **/
+	unsigned int flushBatchSize;              /**< Maximum number of records written by the flusher in one batch **/
+	unsigned int flushIntervalMs;             /**< Maximum time in milliseconds a record stays buffered before being flushed **/
+	Logging_OverflowPolicy_t overflowPolicy;  /**< Behaviour when the ring of the writer thread is full **/
+	LogChannelConfig(): ringCapacity(256), flushBatchSize(64), flushIntervalMs(100), overflowPolicy(LOG_OVERFLOW_DROP_OLDEST) {}
+}sLogChannelConfig_t;
+
+/**
+ *  \brief  sLogChannelStats_t to retrieve the counters of the buffered log channel.
+ *  \details Counters are cumulated since the start of the logging service.
+ */
+typedef struct LogChannelStats
+{
+	uint64_t recordsWritten;       /**< Number of records written to storage by the flusher **/
+	uint64_t droppedOldest;        /**< Number of records discarded with LOG_OVERFLOW_DROP_OLDEST policy **/
+	uint64_t droppedNewest;        /**< Number of records discarded with LOG_OVERFLOW_DROP_NEWEST policy **/
+	uint64_t blockedWrites;        /**< Number of writes which had to wait with LOG_OVERFLOW_BLOCK policy **/
+	uint64_t flushBatches;         /**< Number of batches written by the flusher **/
+	unsigned int writerThreads;    /**< Number of threads currently owning a ring buffer **/
+	LogChannelStats(): recordsWritten(0), droppedOldest(0), droppedNewest(0), blockedWrites(0), flushBatches(0), writerThreads(0) {}
+}sLogChannelStats_t;
+
+
+/**
+ * \brief The Logging_Compression_t defines the compression applied to log storage segments.
+ */
+//@serialize
+enum Logging_Compression_t
+{
+    LOG_COMPRESSION_NONE,     /**< Segments are stored uncompressed */
+    LOG_COMPRESSION_LZ4,      /**< Segments are compressed with LZ4 frame format while being written */
+    LOG_COMPRESSION_ZSTD      /**< Segments are compressed with zstd frame format while being written */
+};
+
+/**
+ *  \brief  sLogStorageConfig_t to configure the segmented log storage.
+ *  \details Log storage is split into segments of at most segmentSize bytes (after compression).
+ *  When maxSegments segments exist, the oldest one is reused if rotate is true, otherwise storage stops as when LOG_STORAGE_LIMIT is reached.
+ */
+typedef struct LogStorageConfig
+{
+	unsigned int segmentSize;             /**< Maximum size of one segment in bytes **/
+	unsigned int maxSegments;             /**< Maximum number of segments kept, maxSegments * segmentSize shall not exceed LOG_STORAGE_LIMIT **/
+	Logging_Compression_t compression;    /**< Compression of new segments **/
+	bool rotate;                          /**< true to overwrite the oldest segment, false to stop log storage when full **/
+	LogStorageConfig(): segmentSize(1024 * 1024), maxSegments(8), compression(LOG_COMPRESSION_LZ4), rotate(true) {}
+}sLogStorageConfig_t;
+
+/**
+ *  \brief  sLogSegmentInfo_t to describe one log storage segment from the segment index.
+ *  \details Times are in milliseconds since epoch (UTC) of the first and last record of the segment.
+ */
+typedef struct LogSegmentInfo
+{
+	unsigned int segmentId;               /**< Identifier of the segment, increasing with time **/
+	uint64_t firstRecordTime;             /**< Time of the first record of the segment **/
+	uint64_t lastRecordTime;              /**< Time of the last record of the segment **/
+	std::list<std::string> appIds;        /**< Application identifiers having at least one record in the segment **/
+	Logging_Compression_t compression;    /**< Compression of the segment **/
+	unsigned int storedSize;              /**< Size of the segment in storage in bytes **/
+	unsigned int rawSize;                 /**< Size of the segment records before compression in bytes **/
+	LogSegmentInfo(): segmentId(0), firstRecordTime(0), lastRecordTime(0), compression(LOG_COMPRESSION_NONE), storedSize(0), rawSize(0) {}
+}sLogSegmentInfo_t;
+
+/**
+ *  \brief  sLogExportRequest_t to select the log storage range streamed by exportLogs().
+ *  \details Segments firstSegmentId to lastSegmentId (inclusive) are streamed in order. Segments already stored with the
+ *  requested compression are copied by the kernel (copy_file_range, sendfile or splice) without user-space buffering;
+ *  other segments are converted in a single pass.
+ */
+typedef struct LogExportRequest
+{
+	unsigned int firstSegmentId;          /**< First segment to export, as returned by getLogSegments() **/
+	unsigned int lastSegmentId;           /**< Last segment to export, as returned by getLogSegments() **/
+	Logging_Compression_t compression;    /**< Compression of the exported stream **/
+	LogExportRequest(): firstSegmentId(0), lastSegmentId(0), compression(LOG_COMPRESSION_NONE) {}
+}sLogExportRequest_t;
+
+/**
+ *  \brief  sLogFilterEntry_t to select the records of one (AppId, CtxID) pair with its own priority threshold.
+ *  \details appId and ctxId are DLT identifiers of at most 4 characters. An empty ctxId selects all contexts of appId.
+ */
+typedef struct LogFilterEntry
+{
+	std::string appId;          /**< Application identifier, at most 4 characters **/
+	std::string ctxId;          /**< Context identifier, at most 4 characters, empty for all contexts **/
+	Poco::Priority loglevel;    /**< Records of this pair with a lower priority than loglevel are not stored **/
+	LogFilterEntry(): loglevel(Poco::PRIO_INFORMATION) {}
+}sLogFilterEntry_t;
+
+/**
+ *  \brief  sLogVolumeEntry_t to retrieve the volume stored in log storage for one (AppId, CtxID) pair.
+ *  \details Counters are cumulated since the last call to resetLogVolume() and are not decreased by rotation.
+ */
+typedef struct LogVolumeEntry
+{
+	std::string appId;          /**< Application identifier **/
+	std::string ctxId;          /**< Context identifier **/
+	uint64_t recordsStored;     /**< Number of records written to log storage **/
+	uint64_t bytesStored;       /**< Size of the records written to log storage, before compression, in bytes **/
+	LogVolumeEntry(): recordsStored(0), bytesStored(0) {}
+}sLogVolumeEntry_t;
+
+/**
+ * \brief The Logging_CaptureTrigger_t defines the sources which can freeze the event capture ring into log storage.
+ */
+//@serialize
+enum Logging_CaptureTrigger_t
+{
+    LOG_TRIGGER_APPLICATION,      /**< Capture requested by an application with triggerLogCapture() */
+    LOG_TRIGGER_DTC_CONFIRMED,    /**< Capture started when a DTC is confirmed by the diagnosis manager */
+    LOG_TRIGGER_ECALL_STARTED     /**< Capture started when an eCall is started */
+};
+
+/**
+ *  \brief  sLogCaptureConfig_t to configure the always-on event capture ring.
+ *  \details Records with a priority of at least loglevel are kept in a memory ring of ringSize bytes.
+ *  On a trigger, the records of the last preTriggerSec seconds and of the next postTriggerSec seconds are written to log storage.
+ */
+typedef struct LogCaptureConfig
+{
+	bool enabled;                 /**< true to keep the capture ring running **/
+	Poco::Priority loglevel;      /**< Lowest priority kept in the ring **/
+	unsigned int ringSize;        /**< Size of the memory ring in bytes, bounds the effective pre-trigger duration **/
+	unsigned int preTriggerSec;   /**< Duration kept before the trigger, in seconds **/
+	unsigned int postTriggerSec;  /**< Duration captured after the trigger, in seconds **/
+	LogCaptureConfig(): enabled(false), loglevel(Poco::PRIO_DEBUG), ringSize(2 * 1024 * 1024), preTriggerSec(30), postTriggerSec(30) {}
+}sLogCaptureConfig_t;
+
+/**
+ *  \brief  sLogCaptureInfo_t to describe a completed event capture.
+ */
+typedef struct LogCaptureInfo
+{
+	Logging_CaptureTrigger_t trigger;   /**< Source of the capture **/
+	std::string reason;                 /**< Reason given to triggerLogCapture(), or DTC / eCall identification **/
+	uint64_t triggerTime;               /**< Time of the trigger in milliseconds since epoch (UTC) **/
+	unsigned int firstSegmentId;        /**< First log storage segment holding the capture **/
+	unsigned int lastSegmentId;         /**< Last log storage segment holding the capture **/
+	LogCaptureInfo(): trigger(LOG_TRIGGER_APPLICATION), triggerTime(0), firstSegmentId(0), lastSegmentId(0) {}
+}sLogCaptureInfo_t;
+
+/**
+ * \brief Packs a DLT identifier (at most 4 characters) into an integer key, padding with zero bytes.
+ * \details The logging service compiles the storage filter into a table of packed (AppId, CtxID) keys once per
+ * request, so each record is matched with integer comparisons instead of string comparisons.
+ * \return The packed identifier, or 0 if id is empty or longer than 4 characters.
+ */
+inline uint32_t packLogId(const std::string& id)
+{
+    if (id.empty() || id.size() > 4)
+    {
+        return 0;
+    }
+    uint32_t key = 0;
+    for (std::string::size_type i = 0; i < 4; ++i)
+    {
+        key = (key << 8) | (i < id.size() ? static_cast<unsigned char>(id[i]) : 0);
+    }
+    return key;
+}
 
 } // namespace LoggingService
 } // namespace Stla
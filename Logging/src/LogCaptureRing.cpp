@@ -0,0 +1,175 @@
+/**
+ * \file
+ *         LogCaptureRing.cpp
+ * \brief
+ *         Always-on memory ring of recent records, written to log storage around a trigger
+ *
+ * \par Copyright Notice:
+ * \verbatim
+ * Copyright (c) 2021 Stellantis N.V.
+ * All Rights Reserved.
+ * The reproduction, transmission or use of this document or its contents is
+ * not permitted without express written authority.
+ * Offenders will be liable for damages. All rights, including rights created
+ * by patent grant or registration of a utility model or design, are reserved.
+ * \endverbatim
+ */
+
+#include "LogCaptureRing.h"
+
+namespace Stla
+{
+namespace LoggingService
+{
+
+const unsigned int LogCaptureRing::MAX_TRIGGER_SEC;
+
+LogCaptureRing::LogCaptureRing(LogSegmentStore& store) :
+        m_store(store),
+        m_dtcEnabled(false),
+        m_ecallEnabled(false),
+        m_ringBytes(0),
+        m_capturing(false),
+        m_captureEnd(0),
+        m_captured(0)
+{
+}
+
+Logging_Error_t LogCaptureRing::setConfig(const sLogCaptureConfig_t& config)
+{
+    if ((config.ringSize == 0) || (config.loglevel < Poco::PRIO_FATAL) || (config.loglevel > Poco::PRIO_TRACE)
+            || (config.preTriggerSec > MAX_TRIGGER_SEC) || (config.postTriggerSec > MAX_TRIGGER_SEC))
+    {
+        return ERROR_INVALID_ARGUMENT;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_config = config;
+    if (!config.enabled)
+    {
+        m_ring.clear();
+        m_ringBytes = 0;
+        m_captureEnd = 0;
+    }
+    else if (!m_ring.empty())
+    {
+        evict(m_ring.back().time);
+    }
+    return SUCCESS;
+}
+
+Logging_Error_t LogCaptureRing::setTrigger(Logging_CaptureTrigger_t trigger, bool enable)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    switch (trigger)
+    {
+    case LOG_TRIGGER_DTC_CONFIRMED:
+        m_dtcEnabled = enable;
+        return SUCCESS;
+    case LOG_TRIGGER_ECALL_STARTED:
+        m_ecallEnabled = enable;
+        return SUCCESS;
+    default:
+        return ERROR_INVALID_ARGUMENT;
+    }
+}
+
+void LogCaptureRing::offer(const LogRecord& record, bool stored)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_config.enabled || stored || (record.priority > m_config.loglevel))
+    {
+        return;
+    }
+    if (m_capturing && (record.time <= m_captureEnd))
+    {
+        write(record);
+        return;
+    }
+    m_ringBytes += footprint(record);
+    m_ring.push_back(record);
+    evict(record.time);
+}
+
+bool LogCaptureRing::trigger(Logging_CaptureTrigger_t trigger, const std::string& reason, uint64_t now)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_config.enabled || ((trigger == LOG_TRIGGER_DTC_CONFIRMED) && !m_dtcEnabled)
+            || ((trigger == LOG_TRIGGER_ECALL_STARTED) && !m_ecallEnabled))
+    {
+        return false;
+    }
+    const uint64_t end = now + static_cast<uint64_t>(m_config.postTriggerSec) * 1000;
+    if (m_capturing)
+    {
+        m_captureEnd = (end > m_captureEnd) ? end : m_captureEnd;
+        return true;
+    }
+
+    m_capture = sLogCaptureInfo_t();
+    m_capture.trigger = trigger;
+    m_capture.reason = reason;
+    m_capture.triggerTime = now;
+    m_capture.firstSegmentId = m_store.getCurrentSegmentId();
+    m_capture.lastSegmentId = m_capture.firstSegmentId;
+    m_captured = 0;
+    const uint64_t preTrigger = static_cast<uint64_t>(m_config.preTriggerSec) * 1000;
+    const uint64_t start = (now > preTrigger) ? now - preTrigger : 0;
+    for (std::deque<LogRecord>::const_iterator it = m_ring.begin(); it != m_ring.end(); ++it)
+    {
+        if (it->time >= start)
+        {
+            write(*it);
+        }
+    }
+    m_ring.clear();
+    m_ringBytes = 0;
+    m_capturing = true;
+    m_captureEnd = end;
+    return true;
+}
+
+bool LogCaptureRing::poll(uint64_t now, sLogCaptureInfo_t& info)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_capturing || (now <= m_captureEnd))
+    {
+        return false;
+    }
+    m_store.flush();
+    m_capturing = false;
+    info = m_capture;
+    return true;
+}
+
+size_t LogCaptureRing::footprint(const LogRecord& record)
+{
+    return sizeof(LogRecord) + record.text.size();
+}
+
+void LogCaptureRing::write(const LogRecord& record)
+{
+    if (m_store.append(record))
+    {
+        // The segment of a record is only known once it is appended: rotation may have opened a new one.
+        const unsigned int segmentId = m_store.getCurrentSegmentId();
+        if (m_captured++ == 0)
+        {
+            m_capture.firstSegmentId = segmentId;
+        }
+        m_capture.lastSegmentId = segmentId;
+    }
+}
+
+void LogCaptureRing::evict(uint64_t newest)
+{
+    const uint64_t preTrigger = static_cast<uint64_t>(m_config.preTriggerSec) * 1000;
+    const uint64_t oldest = (newest > preTrigger) ? newest - preTrigger : 0;
+    while (!m_ring.empty() && ((m_ringBytes > m_config.ringSize) || (m_ring.front().time < oldest)))
+    {
+        m_ringBytes -= footprint(m_ring.front());
+        m_ring.pop_front();
+    }
+}
+
+} // namespace LoggingService
+} // namespace Stla
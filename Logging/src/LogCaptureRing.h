@@ -0,0 +1,110 @@
+/**
+ * \file
+ *         LogCaptureRing.h
+ * \brief
+ *         Always-on memory ring of recent records, written to log storage around a trigger
+ *
+ * \par Copyright Notice:
+ * \verbatim
+ * Copyright (c) 2021 Stellantis N.V.
+ * All Rights Reserved.
+ * The reproduction, transmission or use of this document or its contents is
+ * not permitted without express written authority.
+ * Offenders will be liable for damages. All rights, including rights created
+ * by patent grant or registration of a utility model or design, are reserved.
+ * \endverbatim
+ */
+
+#ifndef LOG_CAPTURE_RING_H_
+#define LOG_CAPTURE_RING_H_
+
+#include <deque>
+#include <mutex>
+#include <string>
+#include <cstdint>
+
+#include "ILoggingServiceTypes.h"
+#include "LogRecord.h"
+#include "LogSegmentStore.h"
+
+namespace Stla
+{
+namespace LoggingService
+{
+
+/**
+ * \brief LogCaptureRing backs setLogCaptureConfig(), setLogCaptureTrigger() and triggerLogCapture().
+ * \details While enabled, the records of at least the capture loglevel are kept in memory, at most ringSize bytes
+ * and preTriggerSec seconds back from the newest record. On a trigger, the ring is written to the store and
+ * the records of the next postTriggerSec seconds are written as they are offered; a trigger received meanwhile
+ * extends the window. Once the window has elapsed, poll() returns the capture for logCaptureCompleted.
+ *
+ * Records already written by startLogStorage() are not kept, so a capture does not store them twice.
+ * The class is thread-safe: records are offered by the flusher thread while triggers come from the service.
+ */
+class LogCaptureRing
+{
+public:
+    static const unsigned int MAX_TRIGGER_SEC = 3600;
+
+    /**
+     * \brief The store must outlive the ring.
+     */
+    explicit LogCaptureRing(LogSegmentStore& store);
+
+    /**
+     * \return ERROR_INVALID_ARGUMENT if ringSize is 0, loglevel is not a Poco::Priority or a duration exceeds
+     * MAX_TRIGGER_SEC. Disabling the ring drops its records and ends a running capture at the next poll().
+     */
+    Logging_Error_t setConfig(const sLogCaptureConfig_t& config);
+
+    /**
+     * \return ERROR_INVALID_ARGUMENT if trigger is LOG_TRIGGER_APPLICATION, which is always enabled.
+     */
+    Logging_Error_t setTrigger(Logging_CaptureTrigger_t trigger, bool enable);
+
+    /**
+     * \brief Keep a record, or write it if a capture is running.
+     * \param[in] stored : true if the record has been written by startLogStorage() already
+     */
+    void offer(const LogRecord& record, bool stored);
+
+    /**
+     * \brief Start a capture at now (milliseconds since epoch), or extend the running one.
+     * \return false if the ring is disabled or the trigger is not enabled.
+     */
+    bool trigger(Logging_CaptureTrigger_t trigger, const std::string& reason, uint64_t now);
+
+    /**
+     * \brief End the running capture once its post-trigger window has elapsed at now.
+     * \return true if a capture ended, described by info.
+     */
+    bool poll(uint64_t now, sLogCaptureInfo_t& info);
+
+private:
+    LogCaptureRing(const LogCaptureRing&);
+    LogCaptureRing& operator=(const LogCaptureRing&);
+
+    static size_t footprint(const LogRecord& record);
+    void write(const LogRecord& record);
+    void evict(uint64_t newest);
+
+    LogSegmentStore& m_store;
+
+    std::mutex m_mutex;
+    sLogCaptureConfig_t m_config;
+    bool m_dtcEnabled;
+    bool m_ecallEnabled;
+    std::deque<LogRecord> m_ring;
+    size_t m_ringBytes;
+
+    bool m_capturing;
+    uint64_t m_captureEnd;      // end of the post-trigger window
+    uint64_t m_captured;        // records of the running capture written to the store
+    sLogCaptureInfo_t m_capture;
+};
+
+} // namespace LoggingService
+} // namespace Stla
+
+#endif /* LOG_CAPTURE_RING_H_ */
@@ -0,0 +1,420 @@
+/**
+ * \file
+ *         LogChannel.cpp
+ * \brief
+ *         Buffered log channel of the logging service, with per-thread rings drained by one flusher thread
+ *
+ * \par Copyright Notice:
+ * \verbatim
+ * Copyright (c) 2021 Stellantis N.V.
+ * All Rights Reserved.
+ * The reproduction, transmission or use of this document or its contents is
+ * not permitted without express written authority.
+ * Offenders will be liable for damages. All rights, including rights created
+ * by patent grant or registration of a utility model or design, are reserved.
+ * \endverbatim
+ */
+
+#include "LogChannel.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace Stla
+{
+namespace LoggingService
+{
+
+namespace
+{
+bool byTime(const LogRecord& a, const LogRecord& b)
+{
+    return a.time < b.time;
+}
+
+void parseSource(const std::string& source, LogRecord& record)
+{
+    const std::string::size_type dot = source.find('.');
+    record.appKey = packLogId(source.substr(0, dot));
+    record.ctxKey = (dot == std::string::npos) ? 0 : packLogId(source.substr(dot + 1));
+}
+} // namespace
+
+/**
+ * \brief Ring is the bounded queue of one writer thread.
+ * \details Each slot carries a sequence number telling whether it holds a record (sequence == position + 1) or is
+ * free for the next lap (sequence == position), so the writer and the threads removing records (the flusher, or the
+ * writer itself with LOG_OVERFLOW_DROP_OLDEST) never touch the same record at the same time. Only the writer
+ * pushes; pop() claims a position with a compare-and-swap.
+ */
+class LogChannel::Ring
+{
+public:
+    explicit Ring(unsigned int capacity) :
+            m_slots(new Slot[capacity]),
+            m_mask(capacity - 1),
+            m_head(0),
+            m_tail(0),
+            writerExited(false),
+            channelGone(false)
+    {
+        for (size_t i = 0; i < capacity; ++i)
+        {
+            m_slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * \brief Move the record into the ring, unless it is full. Writer thread only.
+     */
+    bool push(LogRecord& record)
+    {
+        const size_t position = m_head.load(std::memory_order_relaxed);
+        Slot& slot = m_slots[position & m_mask];
+        if (slot.sequence.load(std::memory_order_acquire) != position)
+        {
+            return false;
+        }
+        slot.record = std::move(record);
+        slot.sequence.store(position + 1, std::memory_order_release);
+        m_head.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * \brief Move the oldest record out of the ring, unless it is empty.
+     */
+    bool pop(LogRecord& record)
+    {
+        size_t position = m_tail.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            Slot& slot = m_slots[position & m_mask];
+            const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            if (sequence == position + 1)
+            {
+                if (m_tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    record = std::move(slot.record);
+                    slot.sequence.store(position + m_mask + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (sequence == position)
+            {
+                return false;   // the writer has not filled this slot yet
+            }
+            else
+            {
+                position = m_tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    size_t size() const
+    {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        const size_t head = m_head.load(std::memory_order_acquire);
+        return (head > tail) ? head - tail : 0;
+    }
+
+private:
+    struct Slot
+    {
+        std::atomic<size_t> sequence;
+        LogRecord record;
+    };
+
+    std::unique_ptr<Slot[]> m_slots;
+    const size_t m_mask;
+    std::atomic<size_t> m_head;
+    std::atomic<size_t> m_tail;
+
+public:
+    std::atomic<bool> writerExited;     // the ring is freed once drained
+    std::atomic<bool> channelGone;      // the writer thread drops the ring on its next lookup
+};
+
+/**
+ * \brief WriterRings holds the rings of one writer thread, one per channel, and releases them when it exits.
+ */
+struct LogChannel::WriterRings
+{
+    std::vector<std::pair<unsigned long, std::shared_ptr<Ring> > > rings;
+
+    ~WriterRings()
+    {
+        for (size_t i = 0; i < rings.size(); ++i)
+        {
+            rings[i].second->writerExited.store(true);
+        }
+    }
+};
+
+const unsigned int LogChannel::MAX_RING_CAPACITY;
+std::atomic<unsigned long> LogChannel::s_nextId(1);
+
+LogChannel::LogChannel(LogRecordSink& sink) :
+        m_id(s_nextId.fetch_add(1)),
+        m_sink(sink),
+        m_wakeRequested(false),
+        m_running(false),
+        m_recordsWritten(0),
+        m_droppedOldest(0),
+        m_droppedNewest(0),
+        m_blockedWrites(0),
+        m_flushBatches(0)
+{
+    const sLogChannelConfig_t config;
+    m_ringCapacity.store(config.ringCapacity);
+    m_flushBatchSize.store(config.flushBatchSize);
+    m_flushIntervalMs.store(config.flushIntervalMs);
+    m_overflowPolicy.store(config.overflowPolicy);
+    open();
+}
+
+LogChannel::~LogChannel()
+{
+    close();
+    std::lock_guard<std::mutex> lock(m_ringsMutex);
+    for (size_t i = 0; i < m_rings.size(); ++i)
+    {
+        m_rings[i]->channelGone.store(true);
+    }
+}
+
+void LogChannel::open()
+{
+    std::lock_guard<std::mutex> lifecycle(m_lifecycleMutex);
+    std::lock_guard<std::mutex> lock(m_flushMutex);
+    if (!m_running)
+    {
+        m_running = true;
+        m_flusher = std::thread(&LogChannel::run, this);
+    }
+}
+
+void LogChannel::close()
+{
+    std::lock_guard<std::mutex> lifecycle(m_lifecycleMutex);
+    {
+        std::lock_guard<std::mutex> lock(m_flushMutex);
+        if (!m_running)
+        {
+            return;
+        }
+        m_running = false;
+    }
+    m_wakeup.notify_one();
+    m_drained.notify_all();
+    m_flusher.join();
+}
+
+void LogChannel::log(const Poco::Message& msg)
+{
+    LogRecord record;
+    record.time = static_cast<uint64_t>(msg.getTime().epochMicroseconds() / 1000);
+    record.priority = static_cast<Poco::Priority>(msg.getPriority());
+    parseSource(msg.getSource(), record);
+    record.text = msg.getText();
+
+    Ring* const writerRing = ring();
+    if (writerRing->push(record))
+    {
+        if (writerRing->size() == m_flushBatchSize.load(std::memory_order_relaxed))
+        {
+            wakeFlusher();
+        }
+        return;
+    }
+
+    switch (m_overflowPolicy.load(std::memory_order_relaxed))
+    {
+    case LOG_OVERFLOW_DROP_OLDEST:
+    {
+        LogRecord oldest;
+        while (!writerRing->push(record))
+        {
+            if (writerRing->pop(oldest))
+            {
+                m_droppedOldest.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        break;
+    }
+    case LOG_OVERFLOW_BLOCK:
+    {
+        m_blockedWrites.fetch_add(1, std::memory_order_relaxed);
+        wakeFlusher();
+        std::unique_lock<std::mutex> lock(m_flushMutex);
+        while (!writerRing->push(record))
+        {
+            if (!m_running)
+            {
+                m_droppedNewest.fetch_add(1, std::memory_order_relaxed);
+                break;
+            }
+            m_wakeRequested = true;
+            m_wakeup.notify_one();
+            m_drained.wait(lock);
+        }
+        break;
+    }
+    default:
+        m_droppedNewest.fetch_add(1, std::memory_order_relaxed);
+        break;
+    }
+}
+
+Logging_Error_t LogChannel::setConfig(const sLogChannelConfig_t& config)
+{
+    if ((config.ringCapacity == 0) || (config.ringCapacity > MAX_RING_CAPACITY) || (config.flushBatchSize == 0)
+            || (config.flushIntervalMs == 0))
+    {
+        return ERROR;
+    }
+    if ((config.overflowPolicy != LOG_OVERFLOW_DROP_OLDEST) && (config.overflowPolicy != LOG_OVERFLOW_DROP_NEWEST)
+            && (config.overflowPolicy != LOG_OVERFLOW_BLOCK))
+    {
+        return ERROR;
+    }
+    unsigned int capacity = 1;
+    while (capacity < config.ringCapacity)
+    {
+        capacity <<= 1;
+    }
+    m_ringCapacity.store(capacity);
+    m_flushBatchSize.store(config.flushBatchSize);
+    m_flushIntervalMs.store(config.flushIntervalMs);
+    m_overflowPolicy.store(config.overflowPolicy);
+    wakeFlusher();      // the new interval applies from now
+    return SUCCESS;
+}
+
+void LogChannel::getStats(sLogChannelStats_t& stats) const
+{
+    stats.recordsWritten = m_recordsWritten.load();
+    stats.droppedOldest = m_droppedOldest.load();
+    stats.droppedNewest = m_droppedNewest.load();
+    stats.blockedWrites = m_blockedWrites.load();
+    stats.flushBatches = m_flushBatches.load();
+    std::lock_guard<std::mutex> lock(m_ringsMutex);
+    stats.writerThreads = 0;
+    for (size_t i = 0; i < m_rings.size(); ++i)
+    {
+        if (!m_rings[i]->writerExited.load())
+        {
+            ++stats.writerThreads;
+        }
+    }
+}
+
+LogChannel::Ring* LogChannel::ring()
+{
+    static thread_local WriterRings writer;
+    std::vector<std::pair<unsigned long, std::shared_ptr<Ring> > >& rings = writer.rings;
+    for (size_t i = 0; i < rings.size(); ++i)
+    {
+        if (rings[i].first == m_id)
+        {
+            return rings[i].second.get();
+        }
+    }
+
+    for (size_t i = rings.size(); i > 0; --i)
+    {
+        if (rings[i - 1].second->channelGone.load())
+        {
+            rings.erase(rings.begin() + (i - 1));
+        }
+    }
+    std::shared_ptr<Ring> created(new Ring(m_ringCapacity.load()));
+    {
+        std::lock_guard<std::mutex> lock(m_ringsMutex);
+        m_rings.push_back(created);
+    }
+    rings.push_back(std::make_pair(m_id, created));
+    return created.get();
+}
+
+void LogChannel::wakeFlusher()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_flushMutex);
+        m_wakeRequested = true;
+    }
+    m_wakeup.notify_one();
+}
+
+void LogChannel::run()
+{
+    std::vector<LogRecord> batch;
+    std::unique_lock<std::mutex> lock(m_flushMutex);
+    for (;;)
+    {
+        if (m_running && !m_wakeRequested)
+        {
+            m_wakeup.wait_for(lock, std::chrono::milliseconds(m_flushIntervalMs.load()));
+        }
+        m_wakeRequested = false;
+        const bool stopping = !m_running;
+        lock.unlock();
+        flush(batch);
+        lock.lock();
+        if (stopping)
+        {
+            break;
+        }
+    }
+}
+
+void LogChannel::flush(std::vector<LogRecord>& batch)
+{
+    std::vector<std::shared_ptr<Ring> > rings;
+    {
+        std::lock_guard<std::mutex> lock(m_ringsMutex);
+        rings = m_rings;
+    }
+
+    const size_t batchSize = m_flushBatchSize.load();
+    bool pending = true;
+    while (pending)
+    {
+        pending = false;
+        batch.clear();
+        for (size_t i = 0; (i < rings.size()) && (batch.size() < batchSize); ++i)
+        {
+            LogRecord record;
+            while ((batch.size() < batchSize) && rings[i]->pop(record))
+            {
+                batch.push_back(std::move(record));
+            }
+            pending = pending || (rings[i]->size() > 0);
+        }
+        if (!batch.empty())
+        {
+            std::stable_sort(batch.begin(), batch.end(), byTime);
+            m_sink.write(batch);
+            m_recordsWritten.fetch_add(batch.size());
+            m_flushBatches.fetch_add(1);
+            {
+                std::lock_guard<std::mutex> lock(m_flushMutex);
+            }
+            m_drained.notify_all();
+            pending = true;     // look again until all the rings are empty
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(m_ringsMutex);
+    for (size_t i = m_rings.size(); i > 0; --i)
+    {
+        // A ring is only pushed by its writer: once the writer has exited and the ring is drained, it stays empty.
+        if (m_rings[i - 1]->writerExited.load() && (m_rings[i - 1]->size() == 0))
+        {
+            m_rings.erase(m_rings.begin() + (i - 1));
+        }
+    }
+}
+
+} // namespace LoggingService
+} // namespace Stla
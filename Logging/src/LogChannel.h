@@ -0,0 +1,134 @@
+/**
+ * \file
+ *         LogChannel.h
+ * \brief
+ *         Buffered log channel of the logging service, with per-thread rings drained by one flusher thread
+ *
+ * \par Copyright Notice:
+ * \verbatim
+ * Copyright (c) 2021 Stellantis N.V.
+ * All Rights Reserved.
+ * The reproduction, transmission or use of this document or its contents is
+ * not permitted without express written authority.
+ * Offenders will be liable for damages. All rights, including rights created
+ * by patent grant or registration of a utility model or design, are reserved.
+ * \endverbatim
+ */
+
+#ifndef LOG_CHANNEL_H_
+#define LOG_CHANNEL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Poco/AutoPtr.h"
+#include "Poco/Channel.h"
+#include "Poco/Message.h"
+
+#include "ILoggingServiceTypes.h"
+#include "LogRecord.h"
+
+namespace Stla
+{
+namespace LoggingService
+{
+
+/**
+ * \brief LogChannel is the channel returned by getLogChannel().
+ * \details Each writer thread gets its own ring of records on its first log() call. The writer only moves its record
+ * into a free slot, so it neither takes a lock nor waits on file I/O. One flusher thread drains all the rings by
+ * batches of flushBatchSize records, sorts each batch by time and gives it to the sink. It wakes up every
+ * flushIntervalMs, and as soon as a ring holds a full batch.
+ *
+ * When the ring of the writer is full, the overflow policy applies:
+ * - LOG_OVERFLOW_DROP_OLDEST: the writer removes the oldest record of its ring, as the flusher would.
+ * - LOG_OVERFLOW_DROP_NEWEST: the new record is discarded.
+ * - LOG_OVERFLOW_BLOCK: the writer waits for the flusher. Once the channel is closed, the record is discarded
+ *   and counted as droppedNewest.
+ *
+ * The AppId and CtxID of a record are taken from the source of the message, i.e. the name of the Poco::Logger,
+ * as "AppId.CtxID". The ring of a thread is freed by the flusher once the thread has exited and the ring is empty.
+ */
+class LogChannel : public Poco::Channel
+{
+public:
+    typedef Poco::AutoPtr<LogChannel> Ptr;
+
+    static const unsigned int MAX_RING_CAPACITY = 65536;
+
+    /**
+     * \brief Create the channel and start its flusher. The sink must outlive the channel.
+     */
+    explicit LogChannel(LogRecordSink& sink);
+
+    /**
+     * \brief Restart the flusher after close().
+     */
+    virtual void open();
+
+    /**
+     * \brief Flush all the buffered records and stop the flusher. Records logged afterwards stay buffered until
+     * open() is called.
+     */
+    virtual void close();
+
+    virtual void log(const Poco::Message& msg);
+
+    /**
+     * \return ERROR if a value is 0 or ringCapacity exceeds MAX_RING_CAPACITY.
+     */
+    Logging_Error_t setConfig(const sLogChannelConfig_t& config);
+
+    void getStats(sLogChannelStats_t& stats) const;
+
+protected:
+    virtual ~LogChannel();
+
+private:
+    class Ring;
+    struct WriterRings;
+
+    LogChannel(const LogChannel&);
+    LogChannel& operator=(const LogChannel&);
+
+    Ring* ring();
+    void wakeFlusher();
+    void run();
+    void flush(std::vector<LogRecord>& batch);
+
+    static std::atomic<unsigned long> s_nextId;
+
+    const unsigned long m_id;           // key of the rings of this channel in the writer threads
+    LogRecordSink& m_sink;
+
+    std::atomic<unsigned int> m_ringCapacity;
+    std::atomic<unsigned int> m_flushBatchSize;
+    std::atomic<unsigned int> m_flushIntervalMs;
+    std::atomic<int> m_overflowPolicy;
+
+    mutable std::mutex m_ringsMutex;
+    std::vector<std::shared_ptr<Ring> > m_rings;
+
+    std::mutex m_flushMutex;
+    std::condition_variable m_wakeup;   // flusher waits on it
+    std::condition_variable m_drained;  // blocked writers wait on it
+    bool m_wakeRequested;
+    bool m_running;
+    std::thread m_flusher;
+    std::mutex m_lifecycleMutex;        // serializes open() and close()
+
+    std::atomic<uint64_t> m_recordsWritten;
+    std::atomic<uint64_t> m_droppedOldest;
+    std::atomic<uint64_t> m_droppedNewest;
+    std::atomic<uint64_t> m_blockedWrites;
+    std::atomic<uint64_t> m_flushBatches;
+};
+
+} // namespace LoggingService
+} // namespace Stla
+
+#endif /* LOG_CHANNEL_H_ */
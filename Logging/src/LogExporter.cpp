@@ -0,0 +1,257 @@
+/**
+ * \file
+ *         LogExporter.cpp
+ * \brief
+ *         Export of log storage segments to a descriptor, copied by the kernel when possible
+ *
+ * \par Copyright Notice:
+ * \verbatim
+ * Copyright (c) 2021 Stellantis N.V.
+ * All Rights Reserved.
+ * The reproduction, transmission or use of this document or its contents is
+ * not permitted without express written authority.
+ * Offenders will be liable for damages. All rights, including rights created
+ * by patent grant or registration of a utility model or design, are reserved.
+ * \endverbatim
+ */
+
+#include "LogExporter.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/sendfile.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Stla
+{
+namespace LoggingService
+{
+
+namespace
+{
+const size_t COPY_CHUNK = 1024 * 1024;
+const size_t CONVERT_CHUNK = 64 * 1024;
+
+enum CopyMethod
+{
+    COPY_FILE_RANGE,
+    COPY_SPLICE,
+    COPY_SENDFILE,
+    COPY_READ_WRITE
+};
+
+/**
+ * \brief Tell whether the kernel refuses the method for this pair of descriptors, as opposed to an I/O error.
+ */
+bool unsupported(int error)
+{
+    return (error == EINVAL) || (error == EXDEV) || (error == ENOSYS) || (error == EOPNOTSUPP) || (error == EBADF);
+}
+
+void closeAll(std::vector<int>& fds)
+{
+    for (size_t i = 0; i < fds.size(); ++i)
+    {
+        ::close(fds[i]);
+    }
+    fds.clear();
+}
+} // namespace
+
+LogExporter::LogExporter(LogSegmentStore& store) :
+        m_store(store)
+{
+}
+
+Logging_Error_t LogExporter::exportLogs(int destFd, const sLogExportRequest_t& request, uint64_t& bytesWritten)
+{
+    bytesWritten = 0;
+    const int flags = ::fcntl(destFd, F_GETFL);
+    if ((flags < 0) || ((flags & O_ACCMODE) == O_RDONLY) || (request.lastSegmentId < request.firstSegmentId))
+    {
+        return ERROR_INVALID_ARGUMENT;
+    }
+    if ((request.compression != LOG_COMPRESSION_NONE) && (request.compression != LOG_COMPRESSION_LZ4)
+            && (request.compression != LOG_COMPRESSION_ZSTD))
+    {
+        return ERROR_INVALID_ARGUMENT;
+    }
+    if (request.lastSegmentId >= m_store.getCurrentSegmentId())
+    {
+        m_store.closeSegment();
+    }
+
+    std::vector<int> fds;
+    std::vector<Logging_Compression_t> compressions;
+    for (unsigned int segmentId = request.firstSegmentId; ; ++segmentId)
+    {
+        sLogSegmentInfo_t info;
+        const int fd = m_store.getSegment(segmentId, info) ? m_store.openSegment(segmentId) : -1;
+        if (fd < 0)
+        {
+            closeAll(fds);
+            return ERROR_INVALID_ARGUMENT;
+        }
+        fds.push_back(fd);
+        compressions.push_back(info.compression);
+        if (segmentId == request.lastSegmentId)
+        {
+            break;
+        }
+    }
+
+    bool result = true;
+    for (size_t i = 0; (i < fds.size()) && result; ++i)
+    {
+        result = (compressions[i] == request.compression) ? copySegment(fds[i], destFd, bytesWritten)
+                : convertSegment(fds[i], compressions[i], destFd, request.compression, bytesWritten);
+    }
+    closeAll(fds);
+    return result ? SUCCESS : ERROR;
+}
+
+bool LogExporter::copySegment(int srcFd, int destFd, uint64_t& bytesWritten)
+{
+    struct stat source;
+    struct stat destination;
+    if ((::fstat(srcFd, &source) != 0) || (::fstat(destFd, &destination) != 0))
+    {
+        return false;
+    }
+    CopyMethod method = S_ISREG(destination.st_mode) ? COPY_FILE_RANGE
+            : (S_ISFIFO(destination.st_mode) ? COPY_SPLICE : COPY_SENDFILE);
+
+    off_t offset = 0;
+    std::vector<char> buffer;
+    while (offset < source.st_size)
+    {
+        const size_t length = std::min(static_cast<size_t>(source.st_size - offset), COPY_CHUNK);
+        ssize_t copied = -1;
+        switch (method)
+        {
+        case COPY_FILE_RANGE:
+            copied = ::copy_file_range(srcFd, &offset, destFd, NULL, length, 0);
+            break;
+        case COPY_SPLICE:
+            copied = ::splice(srcFd, &offset, destFd, NULL, length, SPLICE_F_MOVE);
+            break;
+        case COPY_SENDFILE:
+            copied = ::sendfile(destFd, srcFd, &offset, length);
+            break;
+        default:
+            buffer.resize(length);
+            copied = ::pread(srcFd, &buffer[0], length, offset);
+            if (copied > 0)
+            {
+                if (!writeAll(destFd, &buffer[0], static_cast<size_t>(copied), bytesWritten))
+                {
+                    return false;
+                }
+                offset += copied;
+            }
+            break;
+        }
+
+        if (copied > 0)
+        {
+            if (method != COPY_READ_WRITE)
+            {
+                bytesWritten += static_cast<uint64_t>(copied);     // offset is advanced by the kernel
+            }
+        }
+        else if (copied == 0)
+        {
+            return false;       // the segment file is shorter than it was when opened
+        }
+        else if (errno == EINTR)
+        {
+            continue;
+        }
+        else if (unsupported(errno) && (method == COPY_FILE_RANGE))
+        {
+            method = COPY_SENDFILE;
+        }
+        else if (unsupported(errno) && (method != COPY_READ_WRITE))
+        {
+            method = COPY_READ_WRITE;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool LogExporter::convertSegment(int srcFd, Logging_Compression_t from, int destFd, Logging_Compression_t to,
+        uint64_t& bytesWritten)
+{
+    LogDecompressor decompressor;
+    LogCompressor compressor;
+    std::string raw;
+    std::string converted;
+    if (!decompressor.begin(from) || !compressor.begin(to, converted))
+    {
+        return false;
+    }
+    std::vector<char> buffer(CONVERT_CHUNK);
+    for (;;)
+    {
+        const ssize_t count = ::read(srcFd, &buffer[0], buffer.size());
+        if (count < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return false;
+        }
+        if (count == 0)
+        {
+            break;
+        }
+        raw.clear();
+        if (!decompressor.update(&buffer[0], static_cast<size_t>(count), raw))
+        {
+            return false;
+        }
+        if (!raw.empty() && !compressor.update(raw.data(), raw.size(), converted))
+        {
+            return false;
+        }
+        if (!writeAll(destFd, converted.data(), converted.size(), bytesWritten))
+        {
+            return false;
+        }
+        converted.clear();
+    }
+    return compressor.end(converted) && writeAll(destFd, converted.data(), converted.size(), bytesWritten);
+}
+
+bool LogExporter::writeAll(int destFd, const char* data, size_t size, uint64_t& bytesWritten)
+{
+    size_t written = 0;
+    while (written < size)
+    {
+        const ssize_t result = ::write(destFd, data + written, size - written);
+        if (result < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return false;
+        }
+        written += static_cast<size_t>(result);
+        bytesWritten += static_cast<uint64_t>(result);
+    }
+    return true;
+}
+
+} // namespace LoggingService
+} // namespace Stla
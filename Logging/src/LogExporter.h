@@ -0,0 +1,65 @@
+/**
+ * \file
+ *         LogExporter.h
+ * \brief
+ *         Export of log storage segments to a descriptor, copied by the kernel when possible
+ *
+ * \par Copyright Notice:
+ * \verbatim
+ * Copyright (c) 2021 Stellantis N.V.
+ * All Rights Reserved.
+ * The reproduction, transmission or use of this document or its contents is
+ * not permitted without express written authority.
+ * Offenders will be liable for damages. All rights, including rights created
+ * by patent grant or registration of a utility model or design, are reserved.
+ * \endverbatim
+ */
+
+#ifndef LOG_EXPORTER_H_
+#define LOG_EXPORTER_H_
+
+#include <cstdint>
+#include <sys/types.h>
+
+#include "ILoggingServiceTypes.h"
+#include "LogSegmentStore.h"
+
+namespace Stla
+{
+namespace LoggingService
+{
+
+/**
+ * \brief LogExporter implements exportLogs().
+ * \details A segment stored with the requested compression is copied from its file to the destination without
+ * user-space buffering: copy_file_range() to a regular file, splice() to a pipe, sendfile() to a socket or any other
+ * descriptor. When the kernel refuses a method for this pair of descriptors, the next one is tried from the same
+ * offset, down to pread() / write(). Other segments are decompressed and compressed again in a single pass.
+ *
+ * The segment being written is closed first, so each exported segment is a complete frame; the exported stream is
+ * the concatenation of the frames. The segment files are opened before the first byte is written, so rotation
+ * during the export does not remove a segment of the range.
+ */
+class LogExporter
+{
+public:
+    explicit LogExporter(LogSegmentStore& store);
+
+    Logging_Error_t exportLogs(int destFd, const sLogExportRequest_t& request, uint64_t& bytesWritten);
+
+private:
+    LogExporter(const LogExporter&);
+    LogExporter& operator=(const LogExporter&);
+
+    static bool copySegment(int srcFd, int destFd, uint64_t& bytesWritten);
+    static bool convertSegment(int srcFd, Logging_Compression_t from, int destFd, Logging_Compression_t to,
+            uint64_t& bytesWritten);
+    static bool writeAll(int destFd, const char* data, size_t size, uint64_t& bytesWritten);
+
+    LogSegmentStore& m_store;
+};
+
+} // namespace LoggingService
+} // namespace Stla
+
+#endif /* LOG_EXPORTER_H_ */
@@ -0,0 +1,62 @@
+/**
+ * \file
+ *         LogRecord.h
+ * \brief
+ *         Log record as buffered, stored and captured by the logging service
+ *
+ * \par Copyright Notice:
+ * \verbatim
+ * Copyright (c) 2021 Stellantis N.V.
+ * All Rights Reserved.
+ * The reproduction, transmission or use of this document or its contents is
+ * not permitted without express written authority.
+ * Offenders will be liable for damages. All rights, including rights created
+ * by patent grant or registration of a utility model or design, are reserved.
+ * \endverbatim
+ */
+
+#ifndef LOG_RECORD_H_
+#define LOG_RECORD_H_
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "ILoggingServiceTypes.h"
+
+namespace Stla
+{
+namespace LoggingService
+{
+
+/**
+ * \brief LogRecord is one record of a bundle, with its identifiers packed with packLogId().
+ */
+struct LogRecord
+{
+    uint64_t time;              /**< Milliseconds since epoch (UTC) **/
+    Poco::Priority priority;
+    uint32_t appKey;            /**< Packed AppId, 0 if unknown **/
+    uint32_t ctxKey;            /**< Packed CtxID, 0 if unknown **/
+    std::string text;
+    LogRecord(): time(0), priority(Poco::PRIO_INFORMATION), appKey(0), ctxKey(0) {}
+};
+
+/**
+ * \brief LogRecordSink receives the records drained by the flusher of the buffered log channel.
+ */
+class LogRecordSink
+{
+public:
+    virtual ~LogRecordSink() {}
+
+    /**
+     * \brief Write a batch of records, sorted by time. Called from the flusher thread only.
+     */
+    virtual void write(const std::vector<LogRecord>& batch) = 0;
+};
+
+} // namespace LoggingService
+} // namespace Stla
+
+#endif /* LOG_RECORD_H_ */
@@ -0,0 +1,288 @@
+/**
+ * \file
+ *         LogSegmentCodec.cpp
+ * \brief
+ *         Streaming compression of log storage segments (LZ4 frame, zstd frame)
+ *
+ * \par Copyright Notice:
+ * \verbatim
+ * Copyright (c) 2021 Stellantis N.V.
+ * All Rights Reserved.
+ * The reproduction, transmission or use of this document or its contents is
+ * not permitted without express written authority.
+ * Offenders will be liable for damages. All rights, including rights created
+ * by patent grant or registration of a utility model or design, are reserved.
+ * \endverbatim
+ */
+
+#include "LogSegmentCodec.h"
+
+#include <lz4frame.h>
+#include <zstd.h>
+
+namespace Stla
+{
+namespace LoggingService
+{
+
+namespace
+{
+const int ZSTD_LEVEL = 3;
+const size_t DECOMPRESS_CHUNK = 64 * 1024;
+const size_t LZ4_BLOCK_SIZE = 64 * 1024;   // default block size of the LZ4 frame preferences
+
+bool zstdCompress(ZSTD_CCtx* context, const char* data, size_t size, ZSTD_EndDirective directive,
+        std::string& out)
+{
+    ZSTD_inBuffer input = { data, size, 0 };
+    size_t remaining = 0;
+    do
+    {
+        const size_t offset = out.size();
+        out.resize(offset + ZSTD_CStreamOutSize());
+        ZSTD_outBuffer output = { &out[offset], out.size() - offset, 0 };
+        remaining = ZSTD_compressStream2(context, &output, &input, directive);
+        out.resize(offset + output.pos);
+        if (ZSTD_isError(remaining))
+        {
+            return false;
+        }
+    } while ((remaining != 0) || (input.pos < input.size));
+    return true;
+}
+} // namespace
+
+LogCompressor::LogCompressor() :
+        m_compression(LOG_COMPRESSION_NONE),
+        m_context(NULL)
+{
+}
+
+LogCompressor::~LogCompressor()
+{
+    release();
+}
+
+bool LogCompressor::begin(Logging_Compression_t compression, std::string& out)
+{
+    release();
+    m_compression = compression;
+    switch (compression)
+    {
+    case LOG_COMPRESSION_NONE:
+        return true;
+    case LOG_COMPRESSION_LZ4:
+    {
+        LZ4F_cctx* context = NULL;
+        if (LZ4F_isError(LZ4F_createCompressionContext(&context, LZ4F_VERSION)))
+        {
+            return false;
+        }
+        m_context = context;
+        const size_t offset = out.size();
+        out.resize(offset + LZ4F_HEADER_SIZE_MAX);
+        const size_t written = LZ4F_compressBegin(context, &out[offset], LZ4F_HEADER_SIZE_MAX, NULL);
+        out.resize(LZ4F_isError(written) ? offset : offset + written);
+        return !LZ4F_isError(written);
+    }
+    case LOG_COMPRESSION_ZSTD:
+    {
+        ZSTD_CCtx* context = ZSTD_createCCtx();
+        m_context = context;
+        return (context != NULL) && !ZSTD_isError(ZSTD_CCtx_setParameter(context, ZSTD_c_compressionLevel, ZSTD_LEVEL));
+    }
+    default:
+        return false;
+    }
+}
+
+bool LogCompressor::update(const char* data, size_t size, std::string& out)
+{
+    switch (m_compression)
+    {
+    case LOG_COMPRESSION_NONE:
+        out.append(data, size);
+        return true;
+    case LOG_COMPRESSION_LZ4:
+    {
+        LZ4F_cctx* context = static_cast<LZ4F_cctx*>(m_context);
+        const size_t offset = out.size();
+        out.resize(offset + LZ4F_compressBound(size, NULL));
+        size_t written = LZ4F_compressUpdate(context, &out[offset], out.size() - offset, data, size, NULL);
+        if (LZ4F_isError(written))
+        {
+            out.resize(offset);
+            return false;
+        }
+        const size_t flushed = LZ4F_flush(context, &out[offset + written], out.size() - offset - written, NULL);
+        written += LZ4F_isError(flushed) ? 0 : flushed;
+        out.resize(offset + written);
+        return !LZ4F_isError(flushed);
+    }
+    case LOG_COMPRESSION_ZSTD:
+        return zstdCompress(static_cast<ZSTD_CCtx*>(m_context), data, size, ZSTD_e_flush, out);
+    default:
+        return false;
+    }
+}
+
+bool LogCompressor::end(std::string& out)
+{
+    bool result = true;
+    switch (m_compression)
+    {
+    case LOG_COMPRESSION_LZ4:
+    {
+        const size_t offset = out.size();
+        out.resize(offset + LZ4F_compressBound(0, NULL));
+        const size_t written = LZ4F_compressEnd(static_cast<LZ4F_cctx*>(m_context), &out[offset],
+                out.size() - offset, NULL);
+        result = !LZ4F_isError(written);
+        out.resize(result ? offset + written : offset);
+        break;
+    }
+    case LOG_COMPRESSION_ZSTD:
+        result = zstdCompress(static_cast<ZSTD_CCtx*>(m_context), NULL, 0, ZSTD_e_end, out);
+        break;
+    default:
+        break;
+    }
+    release();
+    return result;
+}
+
+size_t LogCompressor::bound(Logging_Compression_t compression, size_t size)
+{
+    switch (compression)
+    {
+    case LOG_COMPRESSION_LZ4:
+        // update() flushes, so nothing stays buffered in the context: blocks which do not compress are stored as
+        // they are, after a 4 bytes header, and end() adds the 4 bytes end mark.
+        return size + ((size / LZ4_BLOCK_SIZE) + 1) * 4 + 4;
+    case LOG_COMPRESSION_ZSTD:
+        return ZSTD_compressBound(size);     // includes the frame header and the last block header
+    default:
+        return size;
+    }
+}
+
+void LogCompressor::release()
+{
+    if (m_context != NULL)
+    {
+        if (m_compression == LOG_COMPRESSION_LZ4)
+        {
+            LZ4F_freeCompressionContext(static_cast<LZ4F_cctx*>(m_context));
+        }
+        else
+        {
+            ZSTD_freeCCtx(static_cast<ZSTD_CCtx*>(m_context));
+        }
+        m_context = NULL;
+    }
+}
+
+LogDecompressor::LogDecompressor() :
+        m_compression(LOG_COMPRESSION_NONE),
+        m_context(NULL)
+{
+}
+
+LogDecompressor::~LogDecompressor()
+{
+    release();
+}
+
+bool LogDecompressor::begin(Logging_Compression_t compression)
+{
+    release();
+    m_compression = compression;
+    switch (compression)
+    {
+    case LOG_COMPRESSION_NONE:
+        return true;
+    case LOG_COMPRESSION_LZ4:
+    {
+        LZ4F_dctx* context = NULL;
+        if (LZ4F_isError(LZ4F_createDecompressionContext(&context, LZ4F_VERSION)))
+        {
+            return false;
+        }
+        m_context = context;
+        return true;
+    }
+    case LOG_COMPRESSION_ZSTD:
+        m_context = ZSTD_createDCtx();
+        return m_context != NULL;
+    default:
+        return false;
+    }
+}
+
+bool LogDecompressor::update(const char* data, size_t size, std::string& out)
+{
+    switch (m_compression)
+    {
+    case LOG_COMPRESSION_NONE:
+        out.append(data, size);
+        return true;
+    case LOG_COMPRESSION_LZ4:
+    {
+        size_t consumed = 0;
+        while (consumed < size)
+        {
+            const size_t offset = out.size();
+            out.resize(offset + DECOMPRESS_CHUNK);
+            size_t produced = DECOMPRESS_CHUNK;
+            size_t read = size - consumed;
+            const size_t hint = LZ4F_decompress(static_cast<LZ4F_dctx*>(m_context), &out[offset], &produced,
+                    data + consumed, &read, NULL);
+            out.resize(offset + produced);
+            if (LZ4F_isError(hint) || ((read == 0) && (produced == 0)))
+            {
+                return false;
+            }
+            consumed += read;
+        }
+        return true;
+    }
+    case LOG_COMPRESSION_ZSTD:
+    {
+        ZSTD_inBuffer input = { data, size, 0 };
+        while (input.pos < input.size)
+        {
+            const size_t offset = out.size();
+            out.resize(offset + ZSTD_DStreamOutSize());
+            ZSTD_outBuffer output = { &out[offset], out.size() - offset, 0 };
+            const size_t result = ZSTD_decompressStream(static_cast<ZSTD_DCtx*>(m_context), &output, &input);
+            out.resize(offset + output.pos);
+            if (ZSTD_isError(result))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+void LogDecompressor::release()
+{
+    if (m_context != NULL)
+    {
+        if (m_compression == LOG_COMPRESSION_LZ4)
+        {
+            LZ4F_freeDecompressionContext(static_cast<LZ4F_dctx*>(m_context));
+        }
+        else
+        {
+            ZSTD_freeDCtx(static_cast<ZSTD_DCtx*>(m_context));
+        }
+        m_context = NULL;
+    }
+}
+
+} // namespace LoggingService
+} // namespace Stla
@@ -0,0 +1,105 @@
+/**
+ * \file
+ *         LogSegmentCodec.h
+ * \brief
+ *         Streaming compression of log storage segments (LZ4 frame, zstd frame)
+ *
+ * \par Copyright Notice:
+ * \verbatim
+ * Copyright (c) 2021 Stellantis N.V.
+ * All Rights Reserved.
+ * The reproduction, transmission or use of this document or its contents is
+ * not permitted without express written authority.
+ * Offenders will be liable for damages. All rights, including rights created
+ * by patent grant or registration of a utility model or design, are reserved.
+ * \endverbatim
+ */
+
+#ifndef LOG_SEGMENT_CODEC_H_
+#define LOG_SEGMENT_CODEC_H_
+
+#include <string>
+#include <cstddef>
+
+#include "ILoggingServiceTypes.h"
+
+namespace Stla
+{
+namespace LoggingService
+{
+
+/**
+ * \brief LogCompressor writes one compressed frame in several steps: begin(), update() for each chunk, end().
+ * \details Each update() flushes its chunk, so the output written so far is always a valid frame prefix and
+ * the stored size of a segment is known after each chunk. LOG_COMPRESSION_NONE copies the chunks.
+ * The class is not thread-safe.
+ */
+class LogCompressor
+{
+public:
+    LogCompressor();
+    ~LogCompressor();
+
+    /**
+     * \brief Start a frame, its header is appended to out.
+     * \return false if the compression is unknown or the compression library failed.
+     */
+    bool begin(Logging_Compression_t compression, std::string& out);
+
+    /**
+     * \brief Compress a chunk, appended to out.
+     */
+    bool update(const char* data, size_t size, std::string& out);
+
+    /**
+     * \brief End the frame, its footer is appended to out.
+     */
+    bool end(std::string& out);
+
+    /**
+     * \brief Maximum size appended by update() for size bytes, plus end().
+     */
+    static size_t bound(Logging_Compression_t compression, size_t size);
+
+private:
+    LogCompressor(const LogCompressor&);
+    LogCompressor& operator=(const LogCompressor&);
+
+    void release();
+
+    Logging_Compression_t m_compression;
+    void* m_context;            // LZ4F_cctx or ZSTD_CCtx
+};
+
+/**
+ * \brief LogDecompressor reads one compressed frame given in chunks of any size.
+ * \details The class is not thread-safe.
+ */
+class LogDecompressor
+{
+public:
+    LogDecompressor();
+    ~LogDecompressor();
+
+    bool begin(Logging_Compression_t compression);
+
+    /**
+     * \brief Decompress a chunk, appended to out.
+     * \return false if the data is not a valid frame.
+     */
+    bool update(const char* data, size_t size, std::string& out);
+
+private:
+    LogDecompressor(const LogDecompressor&);
+    LogDecompressor& operator=(const LogDecompressor&);
+
+    void release();
+
+    Logging_Compression_t m_compression;
+    void* m_context;            // LZ4F_dctx or ZSTD_DCtx
+};
+
+} // namespace LoggingService
+} // namespace Stla
+
+#endif /* LOG_SEGMENT_CODEC_H_ */
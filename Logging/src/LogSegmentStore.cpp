@@ -0,0 +1,473 @@
+/**
+ * \file
+ *         LogSegmentStore.cpp
+ * \brief
+ *         Segmented log storage with compression and a time / application index
+ *
+ * \par Copyright Notice:
+ * \verbatim
+ * Copyright (c) 2021 Stellantis N.V.
+ * All Rights Reserved.
+ * The reproduction, transmission or use of this document or its contents is
+ * not permitted without express written authority.
+ * Offenders will be liable for damages. All rights, including rights created
+ * by patent grant or registration of a utility model or design, are reserved.
+ * \endverbatim
+ */
+
+#include "LogSegmentStore.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Stla
+{
+namespace LoggingService
+{
+
+namespace
+{
+const char* const EXTENSIONS[] = { ".log", ".log.lz4", ".log.zst" };
+
+std::string unpackLogId(uint32_t key)
+{
+    std::string id;
+    for (int shift = 24; (shift >= 0) && (((key >> shift) & 0xFF) != 0); shift -= 8)
+    {
+        id += static_cast<char>((key >> shift) & 0xFF);
+    }
+    return id.empty() ? "-" : id;
+}
+
+void formatRecord(const LogRecord& record, std::string& out)
+{
+    char header[64];
+    const int length = snprintf(header, sizeof(header), "%llu %d ", static_cast<unsigned long long>(record.time),
+            static_cast<int>(record.priority));
+    out.append(header, length);
+    out += unpackLogId(record.appKey);
+    out += ' ';
+    out += unpackLogId(record.ctxKey);
+    out += ' ';
+    const std::string::size_type start = out.size();
+    out += record.text;
+    for (std::string::size_type i = start; i < out.size(); ++i)
+    {
+        if ((out[i] == '\n') || (out[i] == '\r'))
+        {
+            out[i] = ' ';
+        }
+    }
+    out += '\n';
+}
+} // namespace
+
+const size_t LogSegmentStore::CHUNK_SIZE;
+const char* const LogSegmentStore::INDEX_FILE = "segments.idx";
+
+LogSegmentStore::LogSegmentStore(const std::string& directory, uint64_t storageLimit) :
+        m_directory(directory),
+        m_storageLimit(storageLimit),
+        m_nextSegmentId(1),
+        m_full(false),
+        m_fd(-1),
+        m_segmentId(0),
+        m_segmentLimit(0)
+{
+}
+
+LogSegmentStore::~LogSegmentStore()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    closeLocked();
+}
+
+bool LogSegmentStore::open()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    closeLocked();
+    m_segments.clear();
+
+    std::ifstream index((m_directory + "/" + INDEX_FILE).c_str());
+    if (index)
+    {
+        index >> m_nextSegmentId;
+        std::string line;
+        std::getline(index, line);
+        while (std::getline(index, line))
+        {
+            std::istringstream fields(line);
+            Segment segment;
+            int compression = 0;
+            fields >> segment.info.segmentId >> segment.info.firstRecordTime >> segment.info.lastRecordTime
+                    >> compression >> segment.info.storedSize >> segment.info.rawSize;
+            if (!fields || (compression < LOG_COMPRESSION_NONE) || (compression > LOG_COMPRESSION_ZSTD))
+            {
+                continue;
+            }
+            segment.info.compression = static_cast<Logging_Compression_t>(compression);
+            uint32_t appKey = 0;
+            while (fields >> std::hex >> appKey)
+            {
+                segment.appKeys.insert(appKey);
+            }
+            struct stat status;
+            if ((::stat(segmentPath(segment.info.segmentId, segment.info.compression).c_str(), &status) == 0)
+                    && (static_cast<uint64_t>(status.st_size) == segment.info.storedSize))
+            {
+                m_segments[segment.info.segmentId] = segment;
+            }
+        }
+    }
+    if (!m_segments.empty() && (m_nextSegmentId <= m_segments.rbegin()->first))
+    {
+        m_nextSegmentId = m_segments.rbegin()->first + 1;
+    }
+
+    DIR* directory = ::opendir(m_directory.c_str());
+    if (directory == NULL)
+    {
+        return false;
+    }
+    while (struct dirent* entry = ::readdir(directory))
+    {
+        const std::string name(entry->d_name);
+        char* end = NULL;
+        const unsigned long segmentId = strtoul(name.c_str(), &end, 10);
+        if ((end == name.c_str()) || (name.find(EXTENSIONS[0]) == std::string::npos))
+        {
+            continue;
+        }
+        std::map<unsigned int, Segment>::const_iterator segment = m_segments.find(segmentId);
+        if ((segment == m_segments.end())
+                || (name != segmentPath(segmentId, segment->second.info.compression).substr(m_directory.size() + 1)))
+        {
+            ::unlink((m_directory + "/" + name).c_str());
+        }
+    }
+    ::closedir(directory);
+    m_full = !m_config.rotate && (m_segments.size() >= m_config.maxSegments);
+    return saveIndex();
+}
+
+Logging_Error_t LogSegmentStore::setConfig(const sLogStorageConfig_t& config)
+{
+    if ((config.segmentSize == 0) || (config.maxSegments == 0)
+            || (static_cast<uint64_t>(config.segmentSize) * config.maxSegments > m_storageLimit))
+    {
+        return ERROR;
+    }
+    if ((config.compression != LOG_COMPRESSION_NONE) && (config.compression != LOG_COMPRESSION_LZ4)
+            && (config.compression != LOG_COMPRESSION_ZSTD))
+    {
+        return ERROR;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_config = config;
+    const size_t closed = m_segments.size() - ((m_fd >= 0) ? 1 : 0);
+    m_full = !config.rotate && (closed >= config.maxSegments);
+    return SUCCESS;
+}
+
+sLogStorageConfig_t LogSegmentStore::getConfig() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_config;
+}
+
+bool LogSegmentStore::append(const LogRecord& record)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_full || ((m_fd < 0) && !startSegment()))
+    {
+        return false;
+    }
+    std::string line;
+    formatRecord(record, line);
+
+    const Segment* current = &m_segments[m_segmentId];
+    if ((current->info.storedSize + LogCompressor::bound(current->info.compression, m_pending.size() + line.size())
+            > m_segmentLimit) && (current->info.rawSize > 0))
+    {
+        // Compress what is buffered to know the actual size, then close the segment if the record still may not fit.
+        if (!flushLocked())
+        {
+            return false;
+        }
+        if (current->info.storedSize + LogCompressor::bound(current->info.compression, line.size()) > m_segmentLimit)
+        {
+            if (!closeLocked() || !startSegment())
+            {
+                return false;
+            }
+        }
+    }
+
+    Segment& segment = m_segments[m_segmentId];
+    if (segment.info.rawSize == 0)
+    {
+        segment.info.firstRecordTime = record.time;
+    }
+    if (record.time > segment.info.lastRecordTime)
+    {
+        segment.info.lastRecordTime = record.time;
+    }
+    if (record.appKey != 0)
+    {
+        segment.appKeys.insert(record.appKey);
+    }
+    segment.info.rawSize += line.size();
+    m_pending += line;
+    return (m_pending.size() < CHUNK_SIZE) || flushLocked();
+}
+
+bool LogSegmentStore::flush()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return flushLocked();
+}
+
+bool LogSegmentStore::closeSegment()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return closeLocked();
+}
+
+bool LogSegmentStore::isFull() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_full;
+}
+
+unsigned int LogSegmentStore::getCurrentSegmentId() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return (m_fd >= 0) ? m_segmentId : m_nextSegmentId;
+}
+
+void LogSegmentStore::getSegments(uint64_t fromTime, uint64_t toTime, const std::string& appId,
+        std::list<sLogSegmentInfo_t>& segments)
+{
+    segments.clear();
+    const uint32_t appKey = packLogId(appId);
+    if (!appId.empty() && (appKey == 0))
+    {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    flushLocked();
+    for (std::map<unsigned int, Segment>::const_iterator it = m_segments.begin(); it != m_segments.end(); ++it)
+    {
+        const sLogSegmentInfo_t& info = it->second.info;
+        if ((info.rawSize == 0) || ((fromTime != 0) && (info.lastRecordTime < fromTime))
+                || ((toTime != 0) && (info.firstRecordTime > toTime))
+                || ((appKey != 0) && (it->second.appKeys.count(appKey) == 0)))
+        {
+            continue;
+        }
+        segments.push_back(sLogSegmentInfo_t());
+        fillInfo(it->second, segments.back());
+    }
+}
+
+bool LogSegmentStore::getSegment(unsigned int segmentId, sLogSegmentInfo_t& info)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::map<unsigned int, Segment>::const_iterator segment = m_segments.find(segmentId);
+    if (segment == m_segments.end())
+    {
+        return false;
+    }
+    if ((m_fd >= 0) && (segmentId == m_segmentId))
+    {
+        flushLocked();
+    }
+    fillInfo(segment->second, info);
+    return true;
+}
+
+int LogSegmentStore::openSegment(unsigned int segmentId)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::map<unsigned int, Segment>::const_iterator segment = m_segments.find(segmentId);
+    if (segment == m_segments.end())
+    {
+        return -1;
+    }
+    if ((m_fd >= 0) && (segmentId == m_segmentId))
+    {
+        flushLocked();
+    }
+    return ::open(segmentPath(segmentId, segment->second.info.compression).c_str(), O_RDONLY | O_CLOEXEC);
+}
+
+bool LogSegmentStore::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_fd >= 0)
+    {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+    m_pending.clear();
+    while (!m_segments.empty())
+    {
+        removeSegment(m_segments.begin());
+    }
+    m_full = false;
+    return saveIndex();
+}
+
+std::string LogSegmentStore::segmentPath(unsigned int segmentId, Logging_Compression_t compression) const
+{
+    std::ostringstream path;
+    path << m_directory << '/' << segmentId << EXTENSIONS[compression];
+    return path.str();
+}
+
+bool LogSegmentStore::startSegment()
+{
+    while (m_segments.size() >= m_config.maxSegments)
+    {
+        if (!m_config.rotate)
+        {
+            m_full = true;
+            return false;
+        }
+        removeSegment(m_segments.begin());
+    }
+
+    Segment segment;
+    segment.info.segmentId = m_nextSegmentId;
+    segment.info.compression = m_config.compression;
+    m_fd = ::open(segmentPath(segment.info.segmentId, segment.info.compression).c_str(),
+            O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (m_fd < 0)
+    {
+        return false;
+    }
+    ++m_nextSegmentId;
+    m_segmentId = segment.info.segmentId;
+    m_segmentLimit = m_config.segmentSize;
+    m_segments[m_segmentId] = segment;
+
+    m_output.clear();
+    if (!m_compressor.begin(segment.info.compression, m_output) || !writeAll(m_output))
+    {
+        ::close(m_fd);
+        m_fd = -1;
+        removeSegment(m_segments.find(m_segmentId));
+        return false;
+    }
+    m_segments[m_segmentId].info.storedSize = m_output.size();
+    return true;
+}
+
+bool LogSegmentStore::flushLocked()
+{
+    if ((m_fd < 0) || m_pending.empty())
+    {
+        return true;
+    }
+    m_output.clear();
+    const bool compressed = m_compressor.update(m_pending.data(), m_pending.size(), m_output);
+    m_pending.clear();
+    if (!compressed || !writeAll(m_output))
+    {
+        return false;
+    }
+    m_segments[m_segmentId].info.storedSize += m_output.size();
+    return true;
+}
+
+bool LogSegmentStore::closeLocked()
+{
+    if (m_fd < 0)
+    {
+        return true;
+    }
+    bool result = flushLocked();
+    m_output.clear();
+    result = m_compressor.end(m_output) && writeAll(m_output) && result;
+    m_segments[m_segmentId].info.storedSize += m_output.size();
+    result = (::close(m_fd) == 0) && result;
+    m_fd = -1;
+    return saveIndex() && result;
+}
+
+bool LogSegmentStore::writeAll(const std::string& data)
+{
+    size_t written = 0;
+    while (written < data.size())
+    {
+        const ssize_t result = ::write(m_fd, data.data() + written, data.size() - written);
+        if (result < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return false;
+        }
+        written += static_cast<size_t>(result);
+    }
+    return true;
+}
+
+bool LogSegmentStore::saveIndex() const
+{
+    const std::string path = m_directory + "/" + INDEX_FILE;
+    const std::string temporary = path + ".tmp";
+    {
+        std::ofstream index(temporary.c_str(), std::ios::trunc);
+        index << m_nextSegmentId << '\n';
+        for (std::map<unsigned int, Segment>::const_iterator it = m_segments.begin(); it != m_segments.end(); ++it)
+        {
+            if ((m_fd >= 0) && (it->first == m_segmentId))
+            {
+                continue;       // not described until closed, removed by open() after a shutdown
+            }
+            const sLogSegmentInfo_t& info = it->second.info;
+            index << std::dec << info.segmentId << ' ' << info.firstRecordTime << ' ' << info.lastRecordTime << ' '
+                    << static_cast<int>(info.compression) << ' ' << info.storedSize << ' ' << info.rawSize;
+            for (std::set<uint32_t>::const_iterator key = it->second.appKeys.begin();
+                    key != it->second.appKeys.end(); ++key)
+            {
+                index << ' ' << std::hex << *key;
+            }
+            index << '\n';
+        }
+        if (!index.flush())
+        {
+            return false;
+        }
+    }
+    return ::rename(temporary.c_str(), path.c_str()) == 0;
+}
+
+void LogSegmentStore::removeSegment(std::map<unsigned int, Segment>::iterator segment)
+{
+    ::unlink(segmentPath(segment->first, segment->second.info.compression).c_str());
+    m_segments.erase(segment);
+}
+
+void LogSegmentStore::fillInfo(const Segment& segment, sLogSegmentInfo_t& info) const
+{
+    info = segment.info;
+    info.appIds.clear();
+    for (std::set<uint32_t>::const_iterator key = segment.appKeys.begin(); key != segment.appKeys.end(); ++key)
+    {
+        info.appIds.push_back(unpackLogId(*key));
+    }
+}
+
+} // namespace LoggingService
+} // namespace Stla
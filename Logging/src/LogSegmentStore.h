@@ -0,0 +1,162 @@
+/**
+ * \file
+ *         LogSegmentStore.h
+ * \brief
+ *         Segmented log storage with compression and a time / application index
+ *
+ * \par Copyright Notice:
+ * \verbatim
+ * Copyright (c) 2021 Stellantis N.V.
+ * All Rights Reserved.
+ * The reproduction, transmission or use of this document or its contents is
+ * not permitted without express written authority.
+ * Offenders will be liable for damages. All rights, including rights created
+ * by patent grant or registration of a utility model or design, are reserved.
+ * \endverbatim
+ */
+
+#ifndef LOG_SEGMENT_STORE_H_
+#define LOG_SEGMENT_STORE_H_
+
+#include <string>
+#include <list>
+#include <map>
+#include <set>
+#include <mutex>
+#include <cstdint>
+
+#include "ILoggingServiceTypes.h"
+#include "LogRecord.h"
+#include "LogSegmentCodec.h"
+
+namespace Stla
+{
+namespace LoggingService
+{
+
+/**
+ * \brief LogSegmentStore writes the stored records into segment files of a directory, backs setLogStorageConfig(),
+ * getLogSegments() and getLogSegment().
+ * \details Records are written as text lines "<time> <priority> <AppId> <CtxID> <text>", compressed while being
+ * written. They are buffered up to CHUNK_SIZE bytes, then compressed and flushed to the segment file, so a segment
+ * file always holds a valid frame prefix. A segment is closed when the next chunk could exceed segmentSize.
+ *
+ * The index keeps, per segment, the time of its first and last record and the applications having records in it.
+ * It is rewritten to INDEX_FILE each time a segment is closed, and read back by open(): a segment file missing
+ * from the index (the segment being written at shutdown) is removed.
+ *
+ * The class is thread-safe: records are appended by the flusher thread while the index is read by the service.
+ */
+class LogSegmentStore
+{
+public:
+    static const size_t CHUNK_SIZE = 64 * 1024;
+    static const char* const INDEX_FILE;
+
+    /**
+     * \param[in] directory : directory of the segment files, it must exist
+     * \param[in] storageLimit : LOG_STORAGE_LIMIT, bound of maxSegments * segmentSize
+     */
+    LogSegmentStore(const std::string& directory, uint64_t storageLimit);
+    ~LogSegmentStore();
+
+    /**
+     * \brief Read the index and remove the segment files it does not describe.
+     */
+    bool open();
+
+    /**
+     * \brief The configuration applies from the next segment. When maxSegments is reduced, the oldest segments
+     * are removed at the next rotation.
+     * \return ERROR if a value is 0, the compression is unknown or maxSegments * segmentSize exceeds the storage limit.
+     */
+    Logging_Error_t setConfig(const sLogStorageConfig_t& config);
+
+    sLogStorageConfig_t getConfig() const;
+
+    /**
+     * \brief Append a record to the current segment, opening a new segment if needed.
+     * \return false if the record is not stored: maxSegments segments exist without rotation (see isFull())
+     * or a file operation failed.
+     */
+    bool append(const LogRecord& record);
+
+    /**
+     * \brief Compress the buffered records into the current segment file.
+     */
+    bool flush();
+
+    /**
+     * \brief Close the current segment and save the index. The next record opens a new segment.
+     */
+    bool closeSegment();
+
+    /**
+     * \brief Tell whether storage stopped because maxSegments segments exist without rotation.
+     */
+    bool isFull() const;
+
+    /**
+     * \return The identifier of the segment being written, or of the next one if none is open.
+     */
+    unsigned int getCurrentSegmentId() const;
+
+    /**
+     * \brief Get the segments overlapping [fromTime, toTime] (0 for no bound) having records of appId (empty for all),
+     * from the index only. The segment being written is included with its buffered records flushed.
+     */
+    void getSegments(uint64_t fromTime, uint64_t toTime, const std::string& appId,
+            std::list<sLogSegmentInfo_t>& segments);
+
+    bool getSegment(unsigned int segmentId, sLogSegmentInfo_t& info);
+
+    /**
+     * \return A read-only descriptor of the segment file, owned by the caller, or -1 if there is no such segment.
+     */
+    int openSegment(unsigned int segmentId);
+
+    /**
+     * \brief Remove all the segments and the index. Segment identifiers keep increasing.
+     */
+    bool clear();
+
+private:
+    struct Segment
+    {
+        sLogSegmentInfo_t info;
+        std::set<uint32_t> appKeys;
+    };
+
+    LogSegmentStore(const LogSegmentStore&);
+    LogSegmentStore& operator=(const LogSegmentStore&);
+
+    std::string segmentPath(unsigned int segmentId, Logging_Compression_t compression) const;
+    bool startSegment();
+    bool flushLocked();
+    bool closeLocked();
+    bool writeAll(const std::string& data);
+    bool saveIndex() const;
+    void removeSegment(std::map<unsigned int, Segment>::iterator segment);
+    void fillInfo(const Segment& segment, sLogSegmentInfo_t& info) const;
+
+    const std::string m_directory;
+    const uint64_t m_storageLimit;
+
+    mutable std::mutex m_mutex;
+    sLogStorageConfig_t m_config;
+    std::map<unsigned int, Segment> m_segments;     // the index, including the segment being written
+    unsigned int m_nextSegmentId;
+    bool m_full;
+
+    int m_fd;                   // segment being written, -1 if none
+    unsigned int m_segmentId;
+    unsigned int m_segmentLimit;
+    LogCompressor m_compressor;
+    std::string m_pending;      // records not compressed yet
+    std::string m_output;
+};
+
+} // namespace LoggingService
+} // namespace Stla
+
+#endif /* LOG_SEGMENT_STORE_H_ */
@@ -0,0 +1,147 @@
+/**
+ * \file
+ *         LogStorageFilter.cpp
+ * \brief
+ *         Storage filter of the logging service, compiled into packed (AppId, CtxID) keys
+ *
+ * \par Copyright Notice:
+ * \verbatim
+ * Copyright (c) 2021 Stellantis N.V.
+ * All Rights Reserved.
+ * The reproduction, transmission or use of this document or its contents is
+ * not permitted without express written authority.
+ * Offenders will be liable for damages. All rights, including rights created
+ * by patent grant or registration of a utility model or design, are reserved.
+ * \endverbatim
+ */
+
+#include "LogStorageFilter.h"
+
+#include <algorithm>
+#include <sstream>
+
+namespace Stla
+{
+namespace LoggingService
+{
+
+namespace
+{
+uint64_t pairKey(uint32_t appKey, uint32_t ctxKey)
+{
+    return (static_cast<uint64_t>(appKey) << 32) | ctxKey;
+}
+} // namespace
+
+LogStorageFilter::LogStorageFilter() :
+        m_defaultLevel(Poco::PRIO_INFORMATION)
+{
+}
+
+bool LogStorageFilter::compile(Poco::Priority loglevel, const std::string& filter)
+{
+    std::vector<Entry> entries;
+    if (filter.find_first_not_of(" \t") == std::string::npos)
+    {
+        install(entries, loglevel);     // no filter: all applications
+        return true;
+    }
+    std::istringstream pairs(filter);
+    std::string pair;
+    while (std::getline(pairs, pair, ','))
+    {
+        std::istringstream ids(pair);
+        std::string appId;
+        std::string ctxId;
+        std::string extra;
+        ids >> appId >> ctxId >> extra;
+        const uint32_t appKey = packLogId(appId);
+        const uint32_t ctxKey = ctxId.empty() ? 0 : packLogId(ctxId);
+        if ((appKey == 0) || (!ctxId.empty() && (ctxKey == 0)) || !extra.empty())
+        {
+            return false;
+        }
+        Entry entry;
+        entry.key = pairKey(appKey, ctxKey);
+        entry.loglevel = loglevel;
+        entries.push_back(entry);
+    }
+    install(entries, loglevel);
+    return true;
+}
+
+bool LogStorageFilter::compile(const std::list<sLogFilterEntry_t>& filter)
+{
+    std::vector<Entry> entries;
+    entries.reserve(filter.size());
+    for (std::list<sLogFilterEntry_t>::const_iterator it = filter.begin(); it != filter.end(); ++it)
+    {
+        const uint32_t appKey = packLogId(it->appId);
+        const uint32_t ctxKey = it->ctxId.empty() ? 0 : packLogId(it->ctxId);
+        if ((appKey == 0) || (!it->ctxId.empty() && (ctxKey == 0)))
+        {
+            return false;
+        }
+        Entry entry;
+        entry.key = pairKey(appKey, ctxKey);
+        entry.loglevel = it->loglevel;
+        entries.push_back(entry);
+    }
+    install(entries, Poco::PRIO_INFORMATION);
+    return true;
+}
+
+bool LogStorageFilter::match(uint32_t appKey, uint32_t ctxKey, Poco::Priority priority) const
+{
+    if (m_entries.empty())
+    {
+        return priority <= m_defaultLevel;
+    }
+    Entry probe;
+    probe.key = pairKey(appKey, ctxKey);
+    std::vector<Entry>::const_iterator it = std::lower_bound(m_entries.begin(), m_entries.end(), probe, byKey);
+    if ((it == m_entries.end()) || (it->key != probe.key))
+    {
+        probe.key = pairKey(appKey, 0);
+        it = std::lower_bound(m_entries.begin(), m_entries.end(), probe, byKey);
+        if ((it == m_entries.end()) || (it->key != probe.key))
+        {
+            return false;
+        }
+    }
+    return priority <= it->loglevel;
+}
+
+bool LogStorageFilter::match(const std::string& appId, const std::string& ctxId, Poco::Priority priority) const
+{
+    return match(packLogId(appId), packLogId(ctxId), priority);
+}
+
+bool LogStorageFilter::byKey(const Entry& a, const Entry& b)
+{
+    return a.key < b.key;
+}
+
+void LogStorageFilter::install(std::vector<Entry>& entries, Poco::Priority defaultLevel)
+{
+    std::sort(entries.begin(), entries.end(), byKey);
+    std::vector<Entry> merged;
+    merged.reserve(entries.size());
+    for (std::vector<Entry>::const_iterator it = entries.begin(); it != entries.end(); ++it)
+    {
+        if (!merged.empty() && (merged.back().key == it->key))
+        {
+            // Poco priorities grow towards PRIO_TRACE: the highest value stores the most records.
+            merged.back().loglevel = std::max(merged.back().loglevel, it->loglevel);
+        }
+        else
+        {
+            merged.push_back(*it);
+        }
+    }
+    m_entries.swap(merged);
+    m_defaultLevel = defaultLevel;
+}
+
+} // namespace LoggingService
+} // namespace Stla
@@ -0,0 +1,82 @@
+/**
+ * \file
+ *         LogStorageFilter.h
+ * \brief
+ *         Storage filter of the logging service, compiled into packed (AppId, CtxID) keys
+ *
+ * \par Copyright Notice:
+ * \verbatim
+ * Copyright (c) 2021 Stellantis N.V.
+ * All Rights Reserved.
+ * The reproduction, transmission or use of this document or its contents is
+ * not permitted without express written authority.
+ * Offenders will be liable for damages. All rights, including rights created
+ * by patent grant or registration of a utility model or design, are reserved.
+ * \endverbatim
+ */
+
+#ifndef LOG_STORAGE_FILTER_H_
+#define LOG_STORAGE_FILTER_H_
+
+#include <string>
+#include <list>
+#include <vector>
+#include <cstdint>
+
+#include "ILoggingServiceTypes.h"
+
+namespace Stla
+{
+namespace LoggingService
+{
+
+/**
+ * \brief LogStorageFilter holds the filter of a startLogStorage() request, compiled once into a table of
+ * (AppId, CtxID) keys sorted for binary search, each with its priority threshold.
+ * \details A record is matched by its exact pair first, then by the entry of its AppId for all contexts.
+ * An empty filter matches the records of all applications. The class is not thread-safe.
+ */
+class LogStorageFilter
+{
+public:
+    LogStorageFilter();
+
+    /**
+     * \brief Compile the string filter of startLogStorage(), "AppId CtxID, AppId CtxID, ...", with one threshold.
+     * A pair given with its AppId only selects all contexts of the application.
+     * \return false if the filter is malformed, the filter in place is then unchanged.
+     */
+    bool compile(Poco::Priority loglevel, const std::string& filter);
+
+    /**
+     * \brief Compile a list of entries with a threshold per pair. When a pair is given twice, the threshold
+     * storing the most records applies.
+     * \return false if an identifier is invalid, the filter in place is then unchanged.
+     */
+    bool compile(const std::list<sLogFilterEntry_t>& filter);
+
+    /**
+     * \brief Tell whether a record is stored, from the identifiers packed with packLogId().
+     */
+    bool match(uint32_t appKey, uint32_t ctxKey, Poco::Priority priority) const;
+
+    bool match(const std::string& appId, const std::string& ctxId, Poco::Priority priority) const;
+
+private:
+    struct Entry
+    {
+        uint64_t key;           // AppId in the high 32 bits, CtxID (0 for all contexts) in the low 32 bits
+        int loglevel;
+    };
+
+    static bool byKey(const Entry& a, const Entry& b);
+    void install(std::vector<Entry>& entries, Poco::Priority defaultLevel);
+
+    std::vector<Entry> m_entries;
+    int m_defaultLevel;         // threshold when m_entries is empty
+};
+
+} // namespace LoggingService
+} // namespace Stla
+
+#endif /* LOG_STORAGE_FILTER_H_ */
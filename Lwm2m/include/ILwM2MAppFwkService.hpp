@@ -96,6 +96,16 @@ public:
      */
     Poco::BasicEvent<const str_objlnk_resource_t> ObjlnkResourceChanged;
 
+    /**
+     * @brief Notification for resources modified, batched per instance.
+     *
+     * @param std::vector<str_resource_value_t> resource IDs, types & new values of all resources due for notification.
+     *
+     * @info Resources with notification attributes (see setNotificationAttributes) are notified according to their
+     * pmin / pmax / step attributes, so one event may carry several resources and intermediate values may be skipped.
+     */
+    Poco::BasicEvent<const std::vector<str_resource_value_t> > ResourcesChanged;
+
     // Getters / setters
     /**
      * @brief Getter for the object instance ID
@@ -332,6 +342,70 @@ public:
     virtual e_lwm2m_appfwk_itf_err_code_t setObjlnkResourceValue(
             const str_objlnk_resource_t resource) = 0;
 
+    /**
+     * @brief Getter for several resource values in one call
+     *
+     * @param rids list of the resource IDs to read
+     * @param values reference to an empty list - on success, contains one entry per requested rid, in the same order,
+     *               with type and value set.
+     *
+     * @return
+     * OK (0) - success <br>
+     * NOT_FOUND - at least one resource not found, values is left empty <br>
+     * BROKEN_LINK - link is broken depending on TCU architecture. For eg: usb connection is lost <br>
+     */
+    virtual e_lwm2m_appfwk_itf_err_code_t readResources(
+            const str_instance_resources_t & rids,
+            std::vector<str_resource_value_t> & values) = 0;
+
+    /**
+     * @brief Setter for several resource values in one call
+     *
+     * @param values resources to write - include rid, type and value of each resource
+     *
+     * @info The write is atomic: either all resources are written or none is.
+     * Listeners are notified with a single InstanceChanged event for the instance instead of one event per resource.
+     *
+     * @return
+     * OK (0) - success <br>
+     * OUT_OF_MEMORY - operation exceeds the available memory for AppFwk-DM object instances <br>
+     * INVALID_RID - the type of at least one resource does not match its preset type, or its ID is out of bound; nothing is written <br>
+     * BROKEN_LINK - link is broken depending on TCU architecture. For eg: usb connection is lost <br>
+     */
+    virtual e_lwm2m_appfwk_itf_err_code_t writeResources(
+            const std::vector<str_resource_value_t> & values) = 0;
+
+    /**
+     * @brief Set the notification attributes of a resource
+     *
+     * @param attributes resource ID and pmin / pmax / step attributes
+     *
+     * @info The attributes are enforced by the service for the ResourcesChanged event and for the Notify operations
+     * of the LwM2M client, so frequent writes of a resource are only propagated when the change is meaningful.
+     *
+     * @return
+     * OK (0) - success <br>
+     * NOT_FOUND - resource not found <br>
+     * INVALID_RID - step is negative, or pmax is not 0 and lower than pmin <br>
+     * BROKEN_LINK - link is broken depending on TCU architecture. For eg: usb connection is lost <br>
+     */
+    virtual e_lwm2m_appfwk_itf_err_code_t setNotificationAttributes(
+            const str_notification_attributes_t attributes) = 0;
+
+    /**
+     * @brief Getter for the notification attributes of a resource
+     *
+     * @param attributes reference to an attributes structure with the desired rid
+     *                   set - on success, pmin / pmax / step will be set (all 0 if no attribute is set).
+     *
+     * @return
+     * OK (0) - success <br>
+     * NOT_FOUND - resource not found <br>
+     * BROKEN_LINK - link is broken depending on TCU architecture. For eg: usb connection is lost <br>
+     */
+    virtual e_lwm2m_appfwk_itf_err_code_t getNotificationAttributes(
+            str_notification_attributes_t & attributes) = 0;
+
     /**
      * @brief Removes a resource from the object
      *
@@ -363,6 +437,37 @@ public:
     virtual e_lwm2m_appfwk_itf_err_code_t registerExecuteOpHandler(
             const lwm2m_appfwk_itf_rid_t rid) = 0;
 
+    /**
+     * @brief Set the scheduling of the Execute operations of a registered executable resource
+     *
+     * @param config resource ID, concurrency, queue size and timeout
+     *
+     * @info Without configuration, a resource runs 1 operation at a time, queues up to 8 operations, and uses the client timeout.
+     * When the timeout elapses, the operation is failed on behalf of the application, and a later setExecuteOperationResult for it is ignored.
+     *
+     * @return
+     * OK (0) - success <br>
+     * NOT_FOUND - resource not registered with registerExecuteOpHandler <br>
+     * INVALID_RID - max_concurrent is 0 <br>
+     * BROKEN_LINK - link is broken depending on TCU architecture. For eg: usb connection is lost <br>
+     */
+    virtual e_lwm2m_appfwk_itf_err_code_t setExecuteConfig(
+            const str_execute_config_t config) = 0;
+
+    /**
+     * @brief Getter for the Execute operation counters of an executable resource
+     *
+     * @param statistics reference to a statistics structure with the desired rid
+     *                   set - on success, the counters will be set.
+     *
+     * @return
+     * OK (0) - success <br>
+     * NOT_FOUND - resource not registered with registerExecuteOpHandler <br>
+     * BROKEN_LINK - link is broken depending on TCU architecture. For eg: usb connection is lost <br>
+     */
+    virtual e_lwm2m_appfwk_itf_err_code_t getExecuteStatistics(
+            str_execute_statistics_t & statistics) = 0;
+
     /**
      * @brief Notification for new Execute operation from the server.
      *
@@ -377,16 +482,36 @@ public:
      * @param success set to True if the Execute operation was successful, and to False otherwise
      *
      * @warning if the result is not sent in a timely manner (around 60 seconds), the client will consider the operation failed.
+     * @info Only valid while one operation of the resource may run (max_concurrent of 1, see setExecuteConfig);
+     * otherwise use setExecuteOperationResult to answer a given operation.
      *
      * @return
      * OK (0) - success <br>
      * NOT_FOUND - resource not found <br>
+     * METHOD_NOT_ALLOWED - more than one operation of the resource may run, the result is not applied <br>
      * INVALID_RID - the resource ID is out of bound of Executable resource's ID <br>
      * BROKEN_LINK - link is broken depending on TCU architecture. For eg: usb connection is lost <br>
      */
     virtual e_lwm2m_appfwk_itf_err_code_t setExecuteResult(
             const lwm2m_appfwk_itf_rid_t rid, const bool success) = 0;
 
+    /**
+     * @brief Send the result of a given Execute operation (Failed or Success) to the local LwM2M client.
+     *
+     * @param rid the ID of the execute operation
+     * @param operation_id the operation_id received with the ExecuteOperation event
+     * @param success set to True if the Execute operation was successful, and to False otherwise
+     *
+     * @return
+     * OK (0) - success <br>
+     * NOT_FOUND - resource not found, or the operation is not running anymore (e.g. it timed out) <br>
+     * INVALID_RID - the resource ID is out of bound of Executable resource's ID <br>
+     * BROKEN_LINK - link is broken depending on TCU architecture. For eg: usb connection is lost <br>
+     */
+    virtual e_lwm2m_appfwk_itf_err_code_t setExecuteOperationResult(
+            const lwm2m_appfwk_itf_rid_t rid, const uint32_t operation_id,
+            const bool success) = 0;
+
 };
 
 #ifdef DOXYGEN_WORKING
@@ -427,6 +552,9 @@ public:
      * @param oiid the object instance ID to be retrieved.
      *
      * @return a pointer to the requested object instance handler, or nullptr if no such object.
+     *
+     * @info Instances are persisted by the service and only kept in memory while recently used:
+     * the first access to an instance may load it from persistence.
      */
     virtual ILwM2MInstanceHandler::Ptr getLwM2MAppFwkObjectInstance(
             const lwm2m_appfwk_itf_oiid_t oiid) = 0;
@@ -479,7 +607,8 @@ public:
     Poco::BasicEvent<const lwm2m_appfwk_itf_oiid_t> InstanceDeleted;
 
     /**
-     * @brief Notification for existing object instance change (following a write object instance operation from server).
+     * @brief Notification for existing object instance change (following a write object instance operation from server,
+     *        or a writeResources call on the instance handler).
      *
      * @param lwm2m_appfwk_itf_oiid_t object instance ID modified.
      *
@@ -555,6 +684,27 @@ public:
     virtual ILwM2MObjectHandler::Ptr getObjectHandler(
             Poco::OSP::BundleContext::Ptr pAppBndlContext) = 0;
 
+    /**
+     * @brief Getter for the operation statistics of the service, for all applications
+     *
+     * @param statistics reference to an empty list - on success, contains one entry per operation type.
+     *
+     * @return
+     * OK (0) - success <br>
+     * BROKEN_LINK - link is broken depending on TCU architecture. For eg: usb connection is lost <br>
+     */
+    virtual e_lwm2m_appfwk_itf_err_code_t getOperationStatistics(
+            std::vector<str_operation_statistics_t> & statistics) = 0;
+
+    /**
+     * @brief Reset the operation statistics of the service
+     *
+     * @return
+     * OK (0) - success <br>
+     * BROKEN_LINK - link is broken depending on TCU architecture. For eg: usb connection is lost <br>
+     */
+    virtual e_lwm2m_appfwk_itf_err_code_t resetOperationStatistics() = 0;
+
     /**
      * @brief       Returns the service information for the object's class.
      */
@@ -96,13 +96,92 @@ typedef struct str_objlnk_resource
 
 /**
  * @brief Resource ID and value.
+ *        operation_id identifies the Execute operation (set by the service, never 0).
  */
 typedef struct str_executable_parameters
 {
     lwm2m_appfwk_itf_rid_t rid;
     std::vector<std::string> parameters;
+    uint32_t operation_id;
 } str_executable_parameters_t;
 
+/**
+ * @brief Type of the value carried by str_resource_value_t.
+ */
+ //@serialize
+typedef enum e_lwm2m_appfwk_itf_res_type
+{
+    RES_TYPE_STRING = 0,    // string_value is set
+    RES_TYPE_INTEGER,       // integer_value is set
+    RES_TYPE_FLOAT,         // float_value is set
+    RES_TYPE_BOOLEAN,       // boolean_value is set
+    RES_TYPE_OPAQUE,        // opaque_value is set
+    RES_TYPE_TIME,          // integer_value is set, seconds since epoch
+    RES_TYPE_OBJLNK         // lnk_oid and lnk_oiid are set
+} e_lwm2m_appfwk_itf_res_type_t;
+
+/**
+ * @brief Resource ID and value of any type, used by bulk read / write operations.
+ *        Only the value field(s) matching type are meaningful.
+ */
+typedef struct str_resource_value
+{
+    lwm2m_appfwk_itf_rid_t rid;
+    e_lwm2m_appfwk_itf_res_type_t type;
+    std::string string_value;
+    int64_t integer_value;
+    double float_value;
+    bool boolean_value;
+    std::vector<unsigned char> opaque_value;
+    lwm2m_appfwk_itf_oid_t lnk_oid;
+    lwm2m_appfwk_itf_oiid_t lnk_oiid;
+} str_resource_value_t;
+
+/**
+ * @brief Notification attributes of a resource, with LwM2M observe semantics.
+ *        pmin - minimum period in seconds between two notifications, 0 for no minimum
+ *        pmax - maximum period in seconds without notification, the current value is notified again when it elapses, 0 for no maximum
+ *        step - minimum change of a numeric value (integer, float, time) since the last notified value, 0 for any change
+ */
+typedef struct str_notification_attributes
+{
+    lwm2m_appfwk_itf_rid_t rid;
+    uint32_t pmin;
+    uint32_t pmax;
+    double step;
+} str_notification_attributes_t;
+
+/**
+ * @brief Scheduling of the Execute operations of an executable resource.
+ *        max_concurrent - number of operations delivered with ExecuteOperation and not yet answered with setExecuteResult (at least 1)
+ *        max_queued - number of operations waiting for delivery, further operations fail immediately
+ *        timeout_ms - time from reception of the operation after which it fails automatically, 0 for the client default (around 60 seconds)
+ */
+typedef struct str_execute_config
+{
+    lwm2m_appfwk_itf_rid_t rid;
+    uint32_t max_concurrent;
+    uint32_t max_queued;
+    uint32_t timeout_ms;
+} str_execute_config_t;
+
+/**
+ * @brief Execute operation counters of an executable resource, since registration.
+ *        Latencies are in milliseconds, from reception of the operation to setExecuteResult.
+ */
+typedef struct str_execute_statistics
+{
+    lwm2m_appfwk_itf_rid_t rid;
+    uint32_t running;
+    uint32_t queued;
+    uint64_t succeeded;
+    uint64_t failed;
+    uint64_t timed_out;
+    uint64_t rejected;
+    uint64_t latency_avg_ms;
+    uint64_t latency_max_ms;
+} str_execute_statistics_t;
+
 /**
  * @brief List (vector) of resource IDs.
  */
@@ -113,6 +192,7 @@ typedef struct str_instance_resources
 
 /**
  * @brief Instance's all values, lists (vectors) with resource IDs and values.
+ *        Import / export format of a whole instance, the service does not keep instances in this layout.
  */
 typedef struct str_instance
 {
@@ -134,6 +214,32 @@ typedef struct str_instance
 } str_instance_t;
 
 
+/**
+ * @brief LwM2M server operations on the AppFwk object instances, as counted by the service statistics.
+ */
+ //@serialize
+typedef enum e_lwm2m_appfwk_itf_operation
+{
+    OPERATION_READ = 0,     // Read of a resource or of an instance
+    OPERATION_WRITE,        // Write of a resource or of an instance
+    OPERATION_EXECUTE,      // Execute, from ExecuteOperation event to setExecuteResult
+    OPERATION_NOTIFY        // Notify sent for an observed resource or instance
+} e_lwm2m_appfwk_itf_operation_t;
+
+/**
+ * @brief Statistics of one operation type since the start of the service or the last reset.
+ *        Latencies are in microseconds, from the reception of the request by the service to the reply to the LwM2M client.
+ */
+typedef struct str_operation_statistics
+{
+    e_lwm2m_appfwk_itf_operation_t operation;
+    uint64_t count;
+    uint64_t failed;
+    uint64_t latency_min_us;
+    uint64_t latency_avg_us;
+    uint64_t latency_max_us;
+} str_operation_statistics_t;
+
 /**
  * @brief The possible communication error codes:
  * OK - success
@@ -0,0 +1,770 @@
+/**
+ * \file
+ *         LwM2MCborCodec.cpp
+ * \brief
+ *         SenML-CBOR and LwM2M-CBOR encoding / decoding of LwM2M object instances.
+ *
+ * \par Copyright Notice:
+ * \verbatim
+ * Copyright (c) 2021 Stellantis N.V.
+ * All Rights Reserved.
+ * The reproduction, transmission or use of this document or its contents is
+ * not permitted without express written authority.
+ * Offenders will be liable for damages. All rights, including rights created
+ * by patent grant or registration of a utility model or design, are reserved.
+ * \endverbatim
+ */
+
+#include "LwM2MCborCodec.hpp"
+
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+namespace Stla
+{
+namespace Connectivity
+{
+namespace
+{
+// CBOR major types
+const uint8_t CBOR_UINT = 0;
+const uint8_t CBOR_NEGINT = 1;
+const uint8_t CBOR_BYTES = 2;
+const uint8_t CBOR_TEXT = 3;
+const uint8_t CBOR_ARRAY = 4;
+const uint8_t CBOR_MAP = 5;
+const uint8_t CBOR_TAG = 6;
+const uint8_t CBOR_SIMPLE = 7;
+
+// CBOR simple values / float additional information
+const uint8_t CBOR_FALSE = 20;
+const uint8_t CBOR_TRUE = 21;
+const uint8_t CBOR_HALF = 25;
+const uint8_t CBOR_SINGLE = 26;
+const uint8_t CBOR_DOUBLE = 27;
+
+// CBOR tag for epoch-based date / time
+const uint64_t CBOR_TAG_EPOCH = 1;
+
+// SenML labels (RFC 8428, table 6)
+const int64_t SENML_BASE_NAME = -2;
+const int64_t SENML_NAME = 0;
+const int64_t SENML_VALUE = 2;
+const int64_t SENML_STRING_VALUE = 3;
+const int64_t SENML_BOOLEAN_VALUE = 4;
+const int64_t SENML_DATA_VALUE = 8;
+const char SENML_OBJLNK_VALUE[] = "vlo";
+
+const int MAX_NESTING = 16;
+
+/**
+ * Whether a decoded float holds an integer which converts to int64_t exactly (false for NaN and infinities)
+ */
+bool isInt64Value(const double value)
+{
+    return (value == std::floor(value)) && (std::fabs(value) < 9.2e18);
+}
+
+/* ---------------------------------------------------------------- encoder */
+
+void writeHead(std::vector<unsigned char> & out, const uint8_t major, const uint64_t value)
+{
+    const uint8_t type = static_cast<uint8_t>(major << 5);
+    if (value < 24)
+    {
+        out.push_back(static_cast<unsigned char>(type | value));
+        return;
+    }
+
+    int bytes;
+    if (value <= 0xFF)
+    {
+        out.push_back(type | 24);
+        bytes = 1;
+    }
+    else if (value <= 0xFFFF)
+    {
+        out.push_back(type | 25);
+        bytes = 2;
+    }
+    else if (value <= 0xFFFFFFFF)
+    {
+        out.push_back(type | 26);
+        bytes = 4;
+    }
+    else
+    {
+        out.push_back(type | 27);
+        bytes = 8;
+    }
+    for (int shift = (bytes - 1) * 8; shift >= 0; shift -= 8)
+    {
+        out.push_back(static_cast<unsigned char>(value >> shift));
+    }
+}
+
+void writeInt(std::vector<unsigned char> & out, const int64_t value)
+{
+    if (value >= 0)
+    {
+        writeHead(out, CBOR_UINT, static_cast<uint64_t>(value));
+    }
+    else
+    {
+        writeHead(out, CBOR_NEGINT, ~static_cast<uint64_t>(value));
+    }
+}
+
+void writeDouble(std::vector<unsigned char> & out, const double value)
+{
+    // Use single precision when it is lossless, it saves 4 bytes per value. A finite value out of the float range
+    // must not be converted: the conversion is undefined.
+    const bool inRange = !std::isfinite(value) || (std::fabs(value) <= FLT_MAX);
+    const float single = inRange ? static_cast<float>(value) : 0.0f;
+    if (inRange && (static_cast<double>(single) == value))
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &single, sizeof(bits));
+        out.push_back((CBOR_SIMPLE << 5) | CBOR_SINGLE);
+        for (int shift = 24; shift >= 0; shift -= 8)
+        {
+            out.push_back(static_cast<unsigned char>(bits >> shift));
+        }
+        return;
+    }
+
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    out.push_back((CBOR_SIMPLE << 5) | CBOR_DOUBLE);
+    for (int shift = 56; shift >= 0; shift -= 8)
+    {
+        out.push_back(static_cast<unsigned char>(bits >> shift));
+    }
+}
+
+void writeString(std::vector<unsigned char> & out, const uint8_t major, const void * data, const size_t size)
+{
+    writeHead(out, major, size);
+    const unsigned char * bytes = static_cast<const unsigned char *>(data);
+    out.insert(out.end(), bytes, bytes + size);
+}
+
+void writeObjlnk(std::vector<unsigned char> & out, const LwM2MInstanceStore::Slot & slot)
+{
+    char text[12];
+    const int size = std::snprintf(text, sizeof(text), "%u:%u", slot.value.lnk.oid, slot.value.lnk.oiid);
+    writeString(out, CBOR_TEXT, text, static_cast<size_t>(size));
+}
+
+/**
+ * Value of a slot in its natural CBOR type; time is tagged only in LwM2M-CBOR.
+ */
+void writeSlotValue(std::vector<unsigned char> & out, const LwM2MInstanceStore & store,
+        const LwM2MInstanceStore::Slot & slot, const bool tagTime)
+{
+    switch (slot.type)
+    {
+    case RES_TYPE_STRING:
+        writeString(out, CBOR_TEXT, store.data(slot), slot.size);
+        break;
+    case RES_TYPE_OPAQUE:
+        writeString(out, CBOR_BYTES, store.data(slot), slot.size);
+        break;
+    case RES_TYPE_FLOAT:
+        writeDouble(out, slot.value.real);
+        break;
+    case RES_TYPE_BOOLEAN:
+        out.push_back(static_cast<unsigned char>((CBOR_SIMPLE << 5) | (slot.value.boolean ? CBOR_TRUE : CBOR_FALSE)));
+        break;
+    case RES_TYPE_OBJLNK:
+        writeObjlnk(out, slot);
+        break;
+    case RES_TYPE_TIME:
+        if (tagTime)
+        {
+            writeHead(out, CBOR_TAG, CBOR_TAG_EPOCH);
+        }
+        writeInt(out, slot.value.integer);
+        break;
+    default:
+        writeInt(out, slot.value.integer);
+        break;
+    }
+}
+
+int64_t senmlValueLabel(const uint8_t type)
+{
+    switch (type)
+    {
+    case RES_TYPE_STRING:
+        return SENML_STRING_VALUE;
+    case RES_TYPE_BOOLEAN:
+        return SENML_BOOLEAN_VALUE;
+    case RES_TYPE_OPAQUE:
+        return SENML_DATA_VALUE;
+    default:
+        return SENML_VALUE;
+    }
+}
+
+/* ---------------------------------------------------------------- decoder */
+
+class Reader
+{
+public:
+    Reader(const unsigned char * data, const size_t size) :
+            m_pos(data), m_end(data + size)
+    {
+    }
+
+    bool atEnd() const
+    {
+        return m_pos == m_end;
+    }
+
+    /**
+     * Read the initial byte and argument of an item. For major type 7, value holds the raw float bits.
+     */
+    bool readHead(uint8_t & major, uint8_t & info, uint64_t & value)
+    {
+        if (m_pos == m_end)
+        {
+            return false;
+        }
+        major = static_cast<uint8_t>(*m_pos >> 5);
+        info = static_cast<uint8_t>(*m_pos & 0x1F);
+        ++m_pos;
+
+        if (info < 24)
+        {
+            value = info;
+            return true;
+        }
+        if (info > 27)
+        {
+            return false;   // reserved or indefinite length
+        }
+        const size_t bytes = static_cast<size_t>(1) << (info - 24);
+        if (static_cast<size_t>(m_end - m_pos) < bytes)
+        {
+            return false;
+        }
+        value = 0;
+        for (size_t i = 0; i < bytes; ++i)
+        {
+            value = (value << 8) | *m_pos++;
+        }
+        return true;
+    }
+
+    bool readPayload(const uint64_t size, const unsigned char * & data)
+    {
+        if (static_cast<uint64_t>(m_end - m_pos) < size)
+        {
+            return false;
+        }
+        data = m_pos;
+        m_pos += size;
+        return true;
+    }
+
+    bool skipItem(const int depth)
+    {
+        uint8_t major;
+        uint8_t info;
+        uint64_t value;
+        const unsigned char * data;
+        if ((depth > MAX_NESTING) || !readHead(major, info, value))
+        {
+            return false;
+        }
+        switch (major)
+        {
+        case CBOR_BYTES:
+        case CBOR_TEXT:
+            return readPayload(value, data);
+        case CBOR_ARRAY:
+        case CBOR_MAP:
+        {
+            const uint64_t items = (major == CBOR_MAP) ? value * 2 : value;
+            for (uint64_t i = 0; i < items; ++i)
+            {
+                if (!skipItem(depth + 1))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+        case CBOR_TAG:
+            return skipItem(depth + 1);
+        default:
+            return true;
+        }
+    }
+
+private:
+    const unsigned char * m_pos;
+    const unsigned char * m_end;
+};
+
+double halfToDouble(const uint16_t half)
+{
+    const int exponent = (half >> 10) & 0x1F;
+    const int mantissa = half & 0x3FF;
+    double value;
+    if (exponent == 0)
+    {
+        value = std::ldexp(mantissa, -24);
+    }
+    else if (exponent != 31)
+    {
+        value = std::ldexp(mantissa + 1024, exponent - 25);
+    }
+    else
+    {
+        value = (mantissa == 0) ? INFINITY : NAN;
+    }
+    return (half & 0x8000) ? -value : value;
+}
+
+bool floatValue(const uint8_t info, const uint64_t bits, double & value)
+{
+    if (info == CBOR_HALF)
+    {
+        value = halfToDouble(static_cast<uint16_t>(bits));
+    }
+    else if (info == CBOR_SINGLE)
+    {
+        const uint32_t single = static_cast<uint32_t>(bits);
+        float f;
+        std::memcpy(&f, &single, sizeof(f));
+        value = f;
+    }
+    else if (info == CBOR_DOUBLE)
+    {
+        std::memcpy(&value, &bits, sizeof(value));
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+bool parseUnsigned(const char * & pos, const char * end, uint16_t & value)
+{
+    uint32_t result = 0;
+    const char * start = pos;
+    while ((pos != end) && (*pos >= '0') && (*pos <= '9'))
+    {
+        result = (result * 10) + static_cast<uint32_t>(*pos - '0');
+        if (result > 0xFFFF)
+        {
+            return false;
+        }
+        ++pos;
+    }
+    value = static_cast<uint16_t>(result);
+    return pos != start;
+}
+
+bool parseObjlnk(const char * text, const size_t size, str_resource_value_t & resource)
+{
+    const char * pos = text;
+    const char * end = text + size;
+    if (!parseUnsigned(pos, end, resource.lnk_oid) || (pos == end) || (*pos++ != ':')
+            || !parseUnsigned(pos, end, resource.lnk_oiid) || (pos != end))
+    {
+        return false;
+    }
+    resource.type = RES_TYPE_OBJLNK;
+    return true;
+}
+
+/**
+ * Read one resource value. Integers, tagged times, floats, booleans, text and byte strings are accepted.
+ */
+bool readValue(Reader & reader, str_resource_value_t & resource)
+{
+    uint8_t major;
+    uint8_t info;
+    uint64_t value;
+    const unsigned char * data;
+    if (!reader.readHead(major, info, value))
+    {
+        return false;
+    }
+
+    bool tagged = false;
+    if ((major == CBOR_TAG) && (value == CBOR_TAG_EPOCH))
+    {
+        tagged = true;
+        if (!reader.readHead(major, info, value))
+        {
+            return false;
+        }
+    }
+
+    switch (major)
+    {
+    case CBOR_UINT:
+        resource.type = tagged ? RES_TYPE_TIME : RES_TYPE_INTEGER;
+        resource.integer_value = static_cast<int64_t>(value);
+        return value <= static_cast<uint64_t>(INT64_MAX);
+    case CBOR_NEGINT:
+        resource.type = tagged ? RES_TYPE_TIME : RES_TYPE_INTEGER;
+        resource.integer_value = static_cast<int64_t>(~value);
+        return value <= static_cast<uint64_t>(INT64_MAX);
+    case CBOR_BYTES:
+        if (tagged || !reader.readPayload(value, data))
+        {
+            return false;
+        }
+        resource.type = RES_TYPE_OPAQUE;
+        resource.opaque_value.assign(data, data + value);
+        return true;
+    case CBOR_TEXT:
+        if (tagged || !reader.readPayload(value, data))
+        {
+            return false;
+        }
+        resource.type = RES_TYPE_STRING;
+        resource.string_value.assign(reinterpret_cast<const char *>(data), value);
+        return true;
+    case CBOR_SIMPLE:
+        if ((info == CBOR_FALSE) || (info == CBOR_TRUE))
+        {
+            resource.type = RES_TYPE_BOOLEAN;
+            resource.boolean_value = (info == CBOR_TRUE);
+            return !tagged;
+        }
+        resource.type = RES_TYPE_FLOAT;
+        if (!floatValue(info, value, resource.float_value))
+        {
+            return false;
+        }
+        if (tagged)
+        {
+            if (!isInt64Value(resource.float_value))
+            {
+                return false;
+            }
+            resource.type = RES_TYPE_TIME;
+            resource.integer_value = static_cast<int64_t>(resource.float_value);
+        }
+        return true;
+    default:
+        return false;
+    }
+}
+
+/**
+ * Align the decoded type on the type of the existing resource, when the encoding is ambiguous
+ * (integer / time, integral float, object link sent as text).
+ */
+void resolveType(const LwM2MInstanceStore * store, str_resource_value_t & resource)
+{
+    const LwM2MInstanceStore::Slot * slot = (store != nullptr) ? store->find(resource.rid) : nullptr;
+    if ((slot == nullptr) || (slot->type == resource.type))
+    {
+        return;
+    }
+
+    const bool slotIsInteger = (slot->type == RES_TYPE_INTEGER) || (slot->type == RES_TYPE_TIME);
+    if (slotIsInteger && ((resource.type == RES_TYPE_INTEGER) || (resource.type == RES_TYPE_TIME)))
+    {
+        resource.type = static_cast<e_lwm2m_appfwk_itf_res_type_t>(slot->type);
+    }
+    else if (slotIsInteger && (resource.type == RES_TYPE_FLOAT)
+            && isInt64Value(resource.float_value))
+    {
+        resource.type = static_cast<e_lwm2m_appfwk_itf_res_type_t>(slot->type);
+        resource.integer_value = static_cast<int64_t>(resource.float_value);
+    }
+    else if ((slot->type == RES_TYPE_FLOAT) && (resource.type == RES_TYPE_INTEGER))
+    {
+        resource.type = RES_TYPE_FLOAT;
+        resource.float_value = static_cast<double>(resource.integer_value);
+    }
+    else if ((slot->type == RES_TYPE_OBJLNK) && (resource.type == RES_TYPE_STRING))
+    {
+        str_resource_value_t objlnk = resource;
+        if (parseObjlnk(resource.string_value.data(), resource.string_value.size(), objlnk))
+        {
+            objlnk.string_value.clear();
+            resource = objlnk;
+        }
+    }
+}
+
+bool readKey(Reader & reader, int64_t & label, const unsigned char * & text, uint64_t & textSize)
+{
+    uint8_t major;
+    uint8_t info;
+    uint64_t value;
+    if (!reader.readHead(major, info, value))
+    {
+        return false;
+    }
+    text = nullptr;
+    textSize = 0;
+    if ((major == CBOR_UINT) && (value <= static_cast<uint64_t>(INT64_MAX)))
+    {
+        label = static_cast<int64_t>(value);
+        return true;
+    }
+    if ((major == CBOR_NEGINT) && (value <= static_cast<uint64_t>(INT64_MAX)))
+    {
+        label = static_cast<int64_t>(~value);
+        return true;
+    }
+    if (major == CBOR_TEXT)
+    {
+        textSize = value;
+        return reader.readPayload(value, text);
+    }
+    return false;
+}
+
+/**
+ * Parse "/oid/oiid/rid" and check it targets the expected instance.
+ */
+bool parsePath(const std::string & path, const lwm2m_appfwk_itf_oid_t oid,
+        const lwm2m_appfwk_itf_oiid_t oiid, lwm2m_appfwk_itf_rid_t & rid)
+{
+    const char * pos = path.data();
+    const char * end = pos + path.size();
+    uint16_t pathOid;
+    uint16_t pathOiid;
+    if ((pos == end) || (*pos++ != '/') || !parseUnsigned(pos, end, pathOid)
+            || (pos == end) || (*pos++ != '/') || !parseUnsigned(pos, end, pathOiid)
+            || (pos == end) || (*pos++ != '/') || !parseUnsigned(pos, end, rid) || (pos != end))
+    {
+        return false;
+    }
+    return (pathOid == oid) && (pathOiid == oiid);
+}
+} // namespace
+
+void LwM2MCborCodec::encodeSenml(const lwm2m_appfwk_itf_oid_t oid,
+        const lwm2m_appfwk_itf_oiid_t oiid, const LwM2MInstanceStore & store,
+        std::vector<unsigned char> & out)
+{
+    const std::vector<LwM2MInstanceStore::Slot> & slots = store.slots();
+    char baseName[16];
+    const int baseNameSize = std::snprintf(baseName, sizeof(baseName), "/%u/%u/", oid, oiid);
+    char name[8];
+
+    writeHead(out, CBOR_ARRAY, slots.size());
+    for (size_t i = 0; i < slots.size(); ++i)
+    {
+        const LwM2MInstanceStore::Slot & slot = slots[i];
+        writeHead(out, CBOR_MAP, (i == 0) ? 3 : 2);
+        if (i == 0)
+        {
+            writeInt(out, SENML_BASE_NAME);
+            writeString(out, CBOR_TEXT, baseName, static_cast<size_t>(baseNameSize));
+        }
+        writeInt(out, SENML_NAME);
+        const int nameSize = std::snprintf(name, sizeof(name), "%u", slot.rid);
+        writeString(out, CBOR_TEXT, name, static_cast<size_t>(nameSize));
+
+        if (slot.type == RES_TYPE_OBJLNK)
+        {
+            writeString(out, CBOR_TEXT, SENML_OBJLNK_VALUE, sizeof(SENML_OBJLNK_VALUE) - 1);
+        }
+        else
+        {
+            writeInt(out, senmlValueLabel(slot.type));
+        }
+        writeSlotValue(out, store, slot, false);
+    }
+}
+
+void LwM2MCborCodec::encodeLwm2mCbor(const lwm2m_appfwk_itf_oid_t oid,
+        const lwm2m_appfwk_itf_oiid_t oiid, const LwM2MInstanceStore & store,
+        std::vector<unsigned char> & out)
+{
+    const std::vector<LwM2MInstanceStore::Slot> & slots = store.slots();
+
+    writeHead(out, CBOR_MAP, 1);
+    writeHead(out, CBOR_UINT, oid);
+    writeHead(out, CBOR_MAP, 1);
+    writeHead(out, CBOR_UINT, oiid);
+    writeHead(out, CBOR_MAP, slots.size());
+    for (size_t i = 0; i < slots.size(); ++i)
+    {
+        writeHead(out, CBOR_UINT, slots[i].rid);
+        writeSlotValue(out, store, slots[i], true);
+    }
+}
+
+namespace
+{
+
+bool readSenml(const unsigned char * data, const size_t size,
+        const lwm2m_appfwk_itf_oid_t oid, const lwm2m_appfwk_itf_oiid_t oiid,
+        const LwM2MInstanceStore * store, std::vector<str_resource_value_t> & values)
+{
+    Reader reader(data, size);
+    uint8_t major;
+    uint8_t info;
+    uint64_t records;
+    if (!reader.readHead(major, info, records) || (major != CBOR_ARRAY))
+    {
+        return false;
+    }
+
+    std::string baseName;
+    for (uint64_t record = 0; record < records; ++record)
+    {
+        uint64_t pairs;
+        if (!reader.readHead(major, info, pairs) || (major != CBOR_MAP))
+        {
+            return false;
+        }
+
+        std::string name;
+        str_resource_value_t resource = str_resource_value_t();
+        bool hasValue = false;
+        for (uint64_t pair = 0; pair < pairs; ++pair)
+        {
+            int64_t label = 0;
+            const unsigned char * text;
+            uint64_t textSize;
+            if (!readKey(reader, label, text, textSize))
+            {
+                return false;
+            }
+
+            if (text != nullptr)
+            {
+                if ((textSize != sizeof(SENML_OBJLNK_VALUE) - 1)
+                        || (std::memcmp(text, SENML_OBJLNK_VALUE, textSize) != 0))
+                {
+                    if (!reader.skipItem(0))
+                    {
+                        return false;
+                    }
+                    continue;
+                }
+                if (!readValue(reader, resource) || (resource.type != RES_TYPE_STRING)
+                        || !parseObjlnk(resource.string_value.data(), resource.string_value.size(), resource))
+                {
+                    return false;
+                }
+                resource.string_value.clear();
+                hasValue = true;
+            }
+            else if ((label == SENML_BASE_NAME) || (label == SENML_NAME))
+            {
+                str_resource_value_t nameValue = str_resource_value_t();
+                if (!readValue(reader, nameValue) || (nameValue.type != RES_TYPE_STRING))
+                {
+                    return false;
+                }
+                (label == SENML_BASE_NAME ? baseName : name) = nameValue.string_value;
+            }
+            else if ((label == SENML_VALUE) || (label == SENML_STRING_VALUE)
+                    || (label == SENML_BOOLEAN_VALUE) || (label == SENML_DATA_VALUE))
+            {
+                if (!readValue(reader, resource))
+                {
+                    return false;
+                }
+                const bool expected =
+                        ((label == SENML_VALUE) && ((resource.type == RES_TYPE_INTEGER) || (resource.type == RES_TYPE_FLOAT)))
+                        || ((label == SENML_STRING_VALUE) && (resource.type == RES_TYPE_STRING))
+                        || ((label == SENML_BOOLEAN_VALUE) && (resource.type == RES_TYPE_BOOLEAN))
+                        || ((label == SENML_DATA_VALUE) && (resource.type == RES_TYPE_OPAQUE));
+                if (!expected)
+                {
+                    return false;
+                }
+                hasValue = true;
+            }
+            else if (!reader.skipItem(0))
+            {
+                return false;
+            }
+        }
+
+        if (!hasValue || !parsePath(baseName + name, oid, oiid, resource.rid))
+        {
+            return false;
+        }
+        resolveType(store, resource);
+        values.push_back(resource);
+    }
+    return reader.atEnd();
+}
+
+bool readLwm2mCbor(const unsigned char * data, const size_t size,
+        const lwm2m_appfwk_itf_oid_t oid, const lwm2m_appfwk_itf_oiid_t oiid,
+        const LwM2MInstanceStore * store, std::vector<str_resource_value_t> & values)
+{
+    Reader reader(data, size);
+    uint8_t major;
+    uint8_t info;
+    uint64_t value;
+
+    // {oid: {oiid: {rid: value, ...}}}
+    if (!reader.readHead(major, info, value) || (major != CBOR_MAP) || (value != 1)
+            || !reader.readHead(major, info, value) || (major != CBOR_UINT) || (value != oid)
+            || !reader.readHead(major, info, value) || (major != CBOR_MAP) || (value != 1)
+            || !reader.readHead(major, info, value) || (major != CBOR_UINT) || (value != oiid))
+    {
+        return false;
+    }
+
+    uint64_t resources;
+    if (!reader.readHead(major, info, resources) || (major != CBOR_MAP))
+    {
+        return false;
+    }
+    for (uint64_t i = 0; i < resources; ++i)
+    {
+        str_resource_value_t resource = str_resource_value_t();
+        if (!reader.readHead(major, info, value) || (major != CBOR_UINT) || (value > 0xFFFF)
+                || !readValue(reader, resource))
+        {
+            return false;
+        }
+        resource.rid = static_cast<lwm2m_appfwk_itf_rid_t>(value);
+        resolveType(store, resource);
+        values.push_back(resource);
+    }
+    return reader.atEnd();
+}
+
+} // namespace
+
+bool LwM2MCborCodec::decodeSenml(const unsigned char * data, const size_t size,
+        const lwm2m_appfwk_itf_oid_t oid, const lwm2m_appfwk_itf_oiid_t oiid,
+        const LwM2MInstanceStore * store, std::vector<str_resource_value_t> & values)
+{
+    if (!readSenml(data, size, oid, oiid, store, values))
+    {
+        values.clear();     // no partial result on a malformed payload
+        return false;
+    }
+    return true;
+}
+
+bool LwM2MCborCodec::decodeLwm2mCbor(const unsigned char * data, const size_t size,
+        const lwm2m_appfwk_itf_oid_t oid, const lwm2m_appfwk_itf_oiid_t oiid,
+        const LwM2MInstanceStore * store, std::vector<str_resource_value_t> & values)
+{
+    if (!readLwm2mCbor(data, size, oid, oiid, store, values))
+    {
+        values.clear();
+        return false;
+    }
+    return true;
+}
+
+} /* namespace Connectivity */
+} /* namespace Stla */
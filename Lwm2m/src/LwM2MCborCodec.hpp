@@ -0,0 +1,86 @@
+/**
+ * \file
+ *         LwM2MCborCodec.hpp
+ * \brief
+ *         SenML-CBOR and LwM2M-CBOR encoding / decoding of LwM2M object instances.
+ *
+ * \par Copyright Notice:
+ * \verbatim
+ * Copyright (c) 2021 Stellantis N.V.
+ * All Rights Reserved.
+ * The reproduction, transmission or use of this document or its contents is
+ * not permitted without express written authority.
+ * Offenders will be liable for damages. All rights, including rights created
+ * by patent grant or registration of a utility model or design, are reserved.
+ * \endverbatim
+ */
+
+#ifndef LWM2MCBORCODEC_H_
+#define LWM2MCBORCODEC_H_
+
+#include <vector>
+#include <cstdint>
+
+#include "ILwM2MAppFwkTypes.hpp"
+#include "LwM2MInstanceStore.hpp"
+
+namespace Stla
+{
+namespace Connectivity
+{
+/**
+ * LwM2MCborCodec encodes an instance directly from the slots of its LwM2MInstanceStore, without building
+ * intermediate strings, and decodes payloads into resource values ready for LwM2MInstanceStore::set().
+ *
+ * Supported formats:
+ * - SenML-CBOR (RFC 8428, content format 112): one record per resource, base name "/oid/oiid/" on the first record.
+ *   Object links use the "vlo" label of LwM2M 1.1.
+ * - LwM2M-CBOR (LwM2M 1.2, content format 11544): nested maps {oid: {oiid: {rid: value}}}.
+ *   Time resources are encoded as integers with tag 1, object links as "oid:oiid" text strings.
+ *
+ * Indefinite length items are not supported by the decoder.
+ */
+class LwM2MCborCodec
+{
+public:
+    /**
+     * @brief Append the SenML-CBOR encoding of an instance to out.
+     */
+    static void encodeSenml(const lwm2m_appfwk_itf_oid_t oid, const lwm2m_appfwk_itf_oiid_t oiid,
+            const LwM2MInstanceStore & store, std::vector<unsigned char> & out);
+
+    /**
+     * @brief Append the LwM2M-CBOR encoding of an instance to out.
+     */
+    static void encodeLwm2mCbor(const lwm2m_appfwk_itf_oid_t oid, const lwm2m_appfwk_itf_oiid_t oiid,
+            const LwM2MInstanceStore & store, std::vector<unsigned char> & out);
+
+    /**
+     * @brief Decode a SenML-CBOR payload targeting one instance.
+     *
+     * @param store if not null, used to resolve the integer / time type of existing resources.
+     * @param values decoded resources, in payload order.
+     *
+     * @return false if the payload is malformed or contains records of another instance, values is then empty.
+     */
+    static bool decodeSenml(const unsigned char * data, const size_t size,
+            const lwm2m_appfwk_itf_oid_t oid, const lwm2m_appfwk_itf_oiid_t oiid,
+            const LwM2MInstanceStore * store, std::vector<str_resource_value_t> & values);
+
+    /**
+     * @brief Decode a LwM2M-CBOR payload targeting one instance.
+     *
+     * @param store if not null, used to resolve the integer / time type of existing resources.
+     * @param values decoded resources, in payload order.
+     *
+     * @return false if the payload is malformed or contains resources of another instance, values is then empty.
+     */
+    static bool decodeLwm2mCbor(const unsigned char * data, const size_t size,
+            const lwm2m_appfwk_itf_oid_t oid, const lwm2m_appfwk_itf_oiid_t oiid,
+            const LwM2MInstanceStore * store, std::vector<str_resource_value_t> & values);
+};
+
+} /* namespace Connectivity */
+} /* namespace Stla */
+
+#endif /* LWM2MCBORCODEC_H_ */
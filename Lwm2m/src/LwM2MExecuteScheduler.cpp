@@ -0,0 +1,214 @@
+/**
+ * \file
+ *         LwM2MExecuteScheduler.cpp
+ * \brief
+ *         Queueing, concurrency limits and deadlines of the Execute operations of one object instance.
+ *
+ * \par Copyright Notice:
+ * \verbatim
+ * Copyright (c) 2021 Stellantis N.V.
+ * All Rights Reserved.
+ * The reproduction, transmission or use of this document or its contents is
+ * not permitted without express written authority.
+ * Offenders will be liable for damages. All rights, including rights created
+ * by patent grant or registration of a utility model or design, are reserved.
+ * \endverbatim
+ */
+
+#include "LwM2MExecuteScheduler.hpp"
+
+namespace Stla
+{
+namespace Connectivity
+{
+const uint64_t LwM2MExecuteScheduler::NO_DEADLINE;
+const uint32_t LwM2MExecuteScheduler::DEFAULT_MAX_CONCURRENT;
+const uint32_t LwM2MExecuteScheduler::DEFAULT_MAX_QUEUED;
+const uint32_t LwM2MExecuteScheduler::DEFAULT_TIMEOUT_MS;
+
+LwM2MExecuteScheduler::Queue::Queue() :
+        config(), statistics(), latencySumMs(0)
+{
+    config.max_concurrent = DEFAULT_MAX_CONCURRENT;
+    config.max_queued = DEFAULT_MAX_QUEUED;
+    config.timeout_ms = 0;
+}
+
+LwM2MExecuteScheduler::LwM2MExecuteScheduler() :
+        m_lastOperationId(0)
+{
+}
+
+void LwM2MExecuteScheduler::registerResource(const lwm2m_appfwk_itf_rid_t rid)
+{
+    Queue & queue = m_queues[rid];
+    queue.config.rid = rid;
+    queue.statistics.rid = rid;
+}
+
+e_lwm2m_appfwk_itf_err_code_t LwM2MExecuteScheduler::configure(
+        const str_execute_config_t & config,
+        std::vector<str_executable_parameters_t> & dispatch)
+{
+    std::map<lwm2m_appfwk_itf_rid_t, Queue>::iterator it = m_queues.find(config.rid);
+    if (it == m_queues.end())
+    {
+        return NOT_FOUND;
+    }
+    if (config.max_concurrent == 0)
+    {
+        return INVALID_RID;
+    }
+    it->second.config = config;
+
+    // A higher concurrency may allow queued operations to start now.
+    startWaiting(it->second, dispatch);
+    return OK;
+}
+
+e_lwm2m_appfwk_itf_err_code_t LwM2MExecuteScheduler::submit(
+        const str_executable_parameters_t & parameters, const uint64_t nowMs,
+        uint32_t & operationId, std::vector<str_executable_parameters_t> & dispatch)
+{
+    std::map<lwm2m_appfwk_itf_rid_t, Queue>::iterator it = m_queues.find(parameters.rid);
+    if (it == m_queues.end())
+    {
+        return NOT_FOUND;
+    }
+    Queue & queue = it->second;
+
+    if ((queue.running.size() >= queue.config.max_concurrent) && (queue.waiting.size() >= queue.config.max_queued))
+    {
+        ++queue.statistics.rejected;
+        return OUT_OF_MEMORY;
+    }
+
+    Operation operation;
+    operation.parameters = parameters;
+    if (++m_lastOperationId == 0)
+    {
+        m_lastOperationId = 1;
+    }
+    operation.parameters.operation_id = m_lastOperationId;
+    operationId = m_lastOperationId;
+    operation.receivedMs = nowMs;
+    queue.waiting.push_back(operation);
+    startWaiting(queue, dispatch);
+    return OK;
+}
+
+e_lwm2m_appfwk_itf_err_code_t LwM2MExecuteScheduler::complete(
+        const lwm2m_appfwk_itf_rid_t rid, const uint32_t operationId, const bool success,
+        const uint64_t nowMs, std::vector<str_executable_parameters_t> & dispatch)
+{
+    std::map<lwm2m_appfwk_itf_rid_t, Queue>::iterator it = m_queues.find(rid);
+    if (it == m_queues.end())
+    {
+        return NOT_FOUND;
+    }
+    Queue & queue = it->second;
+    if ((operationId == 0) && ((queue.config.max_concurrent > 1) || (queue.running.size() > 1)))
+    {
+        return METHOD_NOT_ALLOWED;  // the result could be credited to another operation than the answered one
+    }
+
+    std::deque<Operation>::iterator operation = queue.running.begin();
+    while ((operation != queue.running.end()) && (operationId != 0)
+            && (operation->parameters.operation_id != operationId))
+    {
+        ++operation;
+    }
+    if (operation == queue.running.end())
+    {
+        return NOT_FOUND;
+    }
+
+    const uint64_t latencyMs = (nowMs > operation->receivedMs) ? nowMs - operation->receivedMs : 0;
+    queue.running.erase(operation);
+    if (success)
+    {
+        ++queue.statistics.succeeded;
+    }
+    else
+    {
+        ++queue.statistics.failed;
+    }
+    queue.latencySumMs += latencyMs;
+    if (latencyMs > queue.statistics.latency_max_ms)
+    {
+        queue.statistics.latency_max_ms = latencyMs;
+    }
+
+    startWaiting(queue, dispatch);
+    return OK;
+}
+
+uint64_t LwM2MExecuteScheduler::expire(const uint64_t nowMs,
+        std::vector<str_executable_parameters_t> & timedOut,
+        std::vector<str_executable_parameters_t> & dispatch)
+{
+    uint64_t next = NO_DEADLINE;
+    for (std::map<lwm2m_appfwk_itf_rid_t, Queue>::iterator it = m_queues.begin(); it != m_queues.end(); ++it)
+    {
+        Queue & queue = it->second;
+        std::deque<Operation> * lists[] = { &queue.running, &queue.waiting };
+        for (size_t i = 0; i < 2; ++i)
+        {
+            // Operations are sorted by reception time in each list, so expired ones are at the front.
+            std::deque<Operation> & operations = *lists[i];
+            while (!operations.empty() && (deadline(queue, operations.front()) <= nowMs))
+            {
+                timedOut.push_back(operations.front().parameters);
+                operations.pop_front();
+                ++queue.statistics.timed_out;
+            }
+        }
+        startWaiting(queue, dispatch);
+
+        for (size_t i = 0; i < 2; ++i)
+        {
+            if (!lists[i]->empty() && (deadline(queue, lists[i]->front()) < next))
+            {
+                next = deadline(queue, lists[i]->front());
+            }
+        }
+    }
+    return next;
+}
+
+e_lwm2m_appfwk_itf_err_code_t LwM2MExecuteScheduler::getStatistics(
+        str_execute_statistics_t & statistics) const
+{
+    std::map<lwm2m_appfwk_itf_rid_t, Queue>::const_iterator it = m_queues.find(statistics.rid);
+    if (it == m_queues.end())
+    {
+        return NOT_FOUND;
+    }
+    const Queue & queue = it->second;
+    statistics = queue.statistics;
+    statistics.running = static_cast<uint32_t>(queue.running.size());
+    statistics.queued = static_cast<uint32_t>(queue.waiting.size());
+    const uint64_t completed = queue.statistics.succeeded + queue.statistics.failed;
+    statistics.latency_avg_ms = (completed > 0) ? queue.latencySumMs / completed : 0;
+    return OK;
+}
+
+void LwM2MExecuteScheduler::startWaiting(Queue & queue,
+        std::vector<str_executable_parameters_t> & dispatch)
+{
+    while (!queue.waiting.empty() && (queue.running.size() < queue.config.max_concurrent))
+    {
+        dispatch.push_back(queue.waiting.front().parameters);
+        queue.running.push_back(queue.waiting.front());
+        queue.waiting.pop_front();
+    }
+}
+
+uint64_t LwM2MExecuteScheduler::deadline(const Queue & queue, const Operation & operation)
+{
+    const uint32_t timeoutMs = (queue.config.timeout_ms != 0) ? queue.config.timeout_ms : DEFAULT_TIMEOUT_MS;
+    return operation.receivedMs + timeoutMs;
+}
+
+} /* namespace Connectivity */
+} /* namespace Stla */
@@ -0,0 +1,149 @@
+/**
+ * \file
+ *         LwM2MExecuteScheduler.hpp
+ * \brief
+ *         Queueing, concurrency limits and deadlines of the Execute operations of one object instance.
+ *
+ * \par Copyright Notice:
+ * \verbatim
+ * Copyright (c) 2021 Stellantis N.V.
+ * All Rights Reserved.
+ * The reproduction, transmission or use of this document or its contents is
+ * not permitted without express written authority.
+ * Offenders will be liable for damages. All rights, including rights created
+ * by patent grant or registration of a utility model or design, are reserved.
+ * \endverbatim
+ */
+
+#ifndef LWM2MEXECUTESCHEDULER_H_
+#define LWM2MEXECUTESCHEDULER_H_
+
+#include <deque>
+#include <map>
+#include <vector>
+#include <cstdint>
+
+#include "ILwM2MAppFwkTypes.hpp"
+
+namespace Stla
+{
+namespace Connectivity
+{
+/**
+ * LwM2MExecuteScheduler keeps one queue per executable resource.
+ *
+ * Operations received from the LwM2M client are given to submit(). The operations returned in dispatch
+ * are delivered to the application with the ExecuteOperation event, outside of any lock. complete() is
+ * called for setExecuteResult / setExecuteOperationResult, and expire() when the deadline returned by the
+ * previous call is reached; the operations returned in timedOut are failed towards the client on behalf of
+ * the application.
+ *
+ * Times are monotonic, in milliseconds. The class is not thread-safe.
+ */
+class LwM2MExecuteScheduler
+{
+public:
+    /**
+     * @brief Value returned by expire() when no operation is pending.
+     */
+    static const uint64_t NO_DEADLINE = UINT64_MAX;
+
+    static const uint32_t DEFAULT_MAX_CONCURRENT = 1;
+    static const uint32_t DEFAULT_MAX_QUEUED = 8;
+    static const uint32_t DEFAULT_TIMEOUT_MS = 55000;   // below the ~60 s timeout of the LwM2M client
+
+    LwM2MExecuteScheduler();
+
+    /**
+     * @brief Start scheduling a resource, with the default configuration.
+     */
+    void registerResource(const lwm2m_appfwk_itf_rid_t rid);
+
+    /**
+     * @brief Set the configuration of a registered resource. Running and queued operations are kept.
+     *
+     * @return
+     * OK (0) - success <br>
+     * NOT_FOUND - resource not registered <br>
+     * INVALID_RID - max_concurrent is 0 <br>
+     */
+    e_lwm2m_appfwk_itf_err_code_t configure(const str_execute_config_t & config,
+            std::vector<str_executable_parameters_t> & dispatch);
+
+    /**
+     * @brief Accept a new operation, and assign its operation_id.
+     *
+     * @param operationId on success, the operation_id assigned, also when the operation is queued.
+     * @param dispatch operations to deliver now, possibly including this one.
+     *
+     * @return
+     * OK (0) - the operation is running or queued <br>
+     * NOT_FOUND - resource not registered <br>
+     * OUT_OF_MEMORY - the queue of the resource is full, the operation must be failed now <br>
+     */
+    e_lwm2m_appfwk_itf_err_code_t submit(const str_executable_parameters_t & parameters, const uint64_t nowMs,
+            uint32_t & operationId, std::vector<str_executable_parameters_t> & dispatch);
+
+    /**
+     * @brief Record the result of a running operation of a resource.
+     *
+     * @param operationId operation to complete, or 0 for the running operation when only one may run.
+     * @param dispatch queued operations to deliver now.
+     *
+     * @return
+     * OK (0) - success, the result must be forwarded to the client <br>
+     * NOT_FOUND - no such running operation (e.g. it already timed out), the result must be ignored <br>
+     * METHOD_NOT_ALLOWED - operationId is 0 while max_concurrent, or the number of running operations, exceeds 1 <br>
+     */
+    e_lwm2m_appfwk_itf_err_code_t complete(const lwm2m_appfwk_itf_rid_t rid, const uint32_t operationId,
+            const bool success, const uint64_t nowMs, std::vector<str_executable_parameters_t> & dispatch);
+
+    /**
+     * @brief Fail the running and queued operations whose deadline is reached.
+     *
+     * @param timedOut one entry per failed operation, with its rid and operation_id.
+     * @param dispatch queued operations to deliver now, in place of the failed running ones.
+     *
+     * @return the next deadline, or NO_DEADLINE.
+     */
+    uint64_t expire(const uint64_t nowMs, std::vector<str_executable_parameters_t> & timedOut,
+            std::vector<str_executable_parameters_t> & dispatch);
+
+    /**
+     * @brief Counters of a resource.
+     *
+     * @return
+     * OK (0) - success <br>
+     * NOT_FOUND - resource not registered <br>
+     */
+    e_lwm2m_appfwk_itf_err_code_t getStatistics(str_execute_statistics_t & statistics) const;
+
+private:
+    struct Operation
+    {
+        str_executable_parameters_t parameters;
+        uint64_t receivedMs;
+    };
+
+    struct Queue
+    {
+        Queue();
+
+        str_execute_config_t config;
+        std::deque<Operation> running;     // delivered, oldest first
+        std::deque<Operation> waiting;     // not delivered yet, oldest first
+        str_execute_statistics_t statistics;
+        uint64_t latencySumMs;
+    };
+
+    static void startWaiting(Queue & queue, std::vector<str_executable_parameters_t> & dispatch);
+    static uint64_t deadline(const Queue & queue, const Operation & operation);
+
+    std::map<lwm2m_appfwk_itf_rid_t, Queue> m_queues;
+    uint32_t m_lastOperationId;
+};
+
+} /* namespace Connectivity */
+} /* namespace Stla */
+
+#endif /* LWM2MEXECUTESCHEDULER_H_ */
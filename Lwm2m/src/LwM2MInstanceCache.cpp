@@ -0,0 +1,186 @@
+/**
+ * \file
+ *         LwM2MInstanceCache.cpp
+ * \brief
+ *         Resident set of LwM2M object instances, paged in from persistence on first access.
+ *
+ * \par Copyright Notice:
+ * \verbatim
+ * Copyright (c) 2021 Stellantis N.V.
+ * All Rights Reserved.
+ * The reproduction, transmission or use of this document or its contents is
+ * not permitted without express written authority.
+ * Offenders will be liable for damages. All rights, including rights created
+ * by patent grant or registration of a utility model or design, are reserved.
+ * \endverbatim
+ */
+
+#include "LwM2MInstanceCache.hpp"
+
+namespace Stla
+{
+namespace Connectivity
+{
+LwM2MInstanceCache::LwM2MInstanceCache(ILwM2MInstanceBackingStore & backing,
+        const size_t maxResident) :
+        m_backing(backing), m_maxResident((maxResident > 0) ? maxResident : 1)
+{
+}
+
+bool LwM2MInstanceCache::open()
+{
+    std::vector<lwm2m_appfwk_itf_oiid_t> instance_list;
+    if (!m_backing.list(instance_list))
+    {
+        return false;
+    }
+    m_known.insert(instance_list.begin(), instance_list.end());
+    return true;
+}
+
+void LwM2MInstanceCache::getInstanceList(
+        std::vector<lwm2m_appfwk_itf_oiid_t> & instance_list) const
+{
+    instance_list.assign(m_known.begin(), m_known.end());
+}
+
+LwM2MInstanceStore * LwM2MInstanceCache::acquire(const lwm2m_appfwk_itf_oiid_t oiid)
+{
+    std::map<lwm2m_appfwk_itf_oiid_t, Entry>::iterator it = m_resident.find(oiid);
+    if (it != m_resident.end())
+    {
+        touch(it->second);
+        return &it->second.store;
+    }
+    if (m_known.find(oiid) == m_known.end())
+    {
+        return nullptr;
+    }
+
+    std::vector<unsigned char> image;
+    LwM2MInstanceStore store;
+    if (!m_backing.load(oiid, image) || !store.deserialize(image.empty() ? nullptr : &image[0], image.size()))
+    {
+        return nullptr;
+    }
+
+    evict();
+    Entry & entry = m_resident[oiid];
+    entry.store = store;
+    entry.dirty = false;
+    entry.lru = m_lru.insert(m_lru.begin(), oiid);
+    return &entry.store;
+}
+
+void LwM2MInstanceCache::markDirty(const lwm2m_appfwk_itf_oiid_t oiid)
+{
+    std::map<lwm2m_appfwk_itf_oiid_t, Entry>::iterator it = m_resident.find(oiid);
+    if (it != m_resident.end())
+    {
+        it->second.dirty = true;
+    }
+}
+
+e_lwm2m_appfwk_itf_err_code_t LwM2MInstanceCache::create(
+        const lwm2m_appfwk_itf_oiid_t oiid, const str_instance_t & instance)
+{
+    if (m_known.find(oiid) != m_known.end())
+    {
+        return ALREADY_CREATED;
+    }
+
+    LwM2MInstanceStore store;
+    const e_lwm2m_appfwk_itf_err_code_t result = store.importInstance(instance);
+    if (result != OK)
+    {
+        return result;
+    }
+
+    // Persist first, so an instance is never listed without its image.
+    std::vector<unsigned char> image;
+    store.serialize(image);
+    if (!m_backing.save(oiid, image))
+    {
+        return OUT_OF_MEMORY;
+    }
+
+    evict();
+    m_known.insert(oiid);
+    Entry & entry = m_resident[oiid];
+    entry.store = store;
+    entry.dirty = false;
+    entry.lru = m_lru.insert(m_lru.begin(), oiid);
+    return OK;
+}
+
+e_lwm2m_appfwk_itf_err_code_t LwM2MInstanceCache::remove(const lwm2m_appfwk_itf_oiid_t oiid)
+{
+    if (m_known.erase(oiid) == 0)
+    {
+        return ID_INVALID;
+    }
+    std::map<lwm2m_appfwk_itf_oiid_t, Entry>::iterator it = m_resident.find(oiid);
+    if (it != m_resident.end())
+    {
+        m_lru.erase(it->second.lru);
+        m_resident.erase(it);
+    }
+    m_backing.remove(oiid);
+    return OK;
+}
+
+bool LwM2MInstanceCache::flush()
+{
+    bool result = true;
+    for (std::map<lwm2m_appfwk_itf_oiid_t, Entry>::iterator it = m_resident.begin(); it != m_resident.end(); ++it)
+    {
+        if (it->second.dirty && !writeBack(it->first, it->second))
+        {
+            result = false;
+        }
+    }
+    return result;
+}
+
+size_t LwM2MInstanceCache::residentCount() const
+{
+    return m_resident.size();
+}
+
+bool LwM2MInstanceCache::writeBack(const lwm2m_appfwk_itf_oiid_t oiid, Entry & entry)
+{
+    std::vector<unsigned char> image;
+    entry.store.serialize(image);
+    if (!m_backing.save(oiid, image))
+    {
+        return false;
+    }
+    entry.dirty = false;
+    return true;
+}
+
+void LwM2MInstanceCache::touch(Entry & entry)
+{
+    m_lru.splice(m_lru.begin(), m_lru, entry.lru);
+}
+
+void LwM2MInstanceCache::evict()
+{
+    // Make room for one more instance. An instance that cannot be written back is kept resident,
+    // so the resident set may exceed maxResident rather than lose modifications.
+    std::list<lwm2m_appfwk_itf_oiid_t>::iterator candidate = m_lru.end();
+    while ((m_resident.size() >= m_maxResident) && (candidate != m_lru.begin()))
+    {
+        --candidate;
+        std::map<lwm2m_appfwk_itf_oiid_t, Entry>::iterator it = m_resident.find(*candidate);
+        if (it->second.dirty && !writeBack(it->first, it->second))
+        {
+            continue;
+        }
+        candidate = m_lru.erase(candidate);
+        m_resident.erase(it);
+    }
+}
+
+} /* namespace Connectivity */
+} /* namespace Stla */
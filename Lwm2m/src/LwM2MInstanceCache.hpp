@@ -0,0 +1,144 @@
+/**
+ * \file
+ *         LwM2MInstanceCache.hpp
+ * \brief
+ *         Resident set of LwM2M object instances, paged in from persistence on first access.
+ *
+ * \par Copyright Notice:
+ * \verbatim
+ * Copyright (c) 2021 Stellantis N.V.
+ * All Rights Reserved.
+ * The reproduction, transmission or use of this document or its contents is
+ * not permitted without express written authority.
+ * Offenders will be liable for damages. All rights, including rights created
+ * by patent grant or registration of a utility model or design, are reserved.
+ * \endverbatim
+ */
+
+#ifndef LWM2MINSTANCECACHE_H_
+#define LWM2MINSTANCECACHE_H_
+
+#include <list>
+#include <map>
+#include <set>
+#include <vector>
+
+#include "ILwM2MAppFwkTypes.hpp"
+#include "LwM2MInstanceStore.hpp"
+
+namespace Stla
+{
+namespace Connectivity
+{
+/**
+ * ILwM2MInstanceBackingStore persists the binary image of instances (see LwM2MInstanceStore::serialize).
+ * The service implements it on top of the data storage service, one file per instance.
+ */
+class ILwM2MInstanceBackingStore
+{
+public:
+    virtual ~ILwM2MInstanceBackingStore()
+    {
+    }
+
+    /**
+     * @brief List the instances present in persistence.
+     */
+    virtual bool list(std::vector<lwm2m_appfwk_itf_oiid_t> & instance_list) = 0;
+
+    virtual bool load(const lwm2m_appfwk_itf_oiid_t oiid, std::vector<unsigned char> & image) = 0;
+
+    virtual bool save(const lwm2m_appfwk_itf_oiid_t oiid, const std::vector<unsigned char> & image) = 0;
+
+    virtual bool remove(const lwm2m_appfwk_itf_oiid_t oiid) = 0;
+};
+
+/**
+ * LwM2MInstanceCache keeps at most maxResident instances in memory, least recently used first out.
+ *
+ * All instance IDs are known at all times, but an instance's resources are only loaded when it is acquired.
+ * Modified instances are written back when evicted or on flush(). The class is not thread-safe.
+ */
+class LwM2MInstanceCache
+{
+public:
+    LwM2MInstanceCache(ILwM2MInstanceBackingStore & backing, const size_t maxResident);
+
+    /**
+     * @brief Read the list of persisted instances. Nothing is paged in.
+     */
+    bool open();
+
+    /**
+     * @brief IDs of all instances, resident or not, sorted.
+     */
+    void getInstanceList(std::vector<lwm2m_appfwk_itf_oiid_t> & instance_list) const;
+
+    /**
+     * @brief Get an instance, paging it in if needed.
+     *
+     * @return the instance, or nullptr if it does not exist or cannot be loaded.
+     * The pointer is valid until the next call to acquire(), create() or remove().
+     */
+    LwM2MInstanceStore * acquire(const lwm2m_appfwk_itf_oiid_t oiid);
+
+    /**
+     * @brief Mark a resident instance as modified, so it is written back before being evicted.
+     */
+    void markDirty(const lwm2m_appfwk_itf_oiid_t oiid);
+
+    /**
+     * @brief Create an instance, resident and persisted.
+     *
+     * @return
+     * OK (0) - success <br>
+     * ALREADY_CREATED - the instance exists <br>
+     * INVALID_RID - the same rid is present twice in instance <br>
+     * OUT_OF_MEMORY - the instance cannot be persisted <br>
+     */
+    e_lwm2m_appfwk_itf_err_code_t create(const lwm2m_appfwk_itf_oiid_t oiid, const str_instance_t & instance);
+
+    /**
+     * @brief Delete an instance from memory and persistence.
+     *
+     * @return
+     * OK (0) - success <br>
+     * ID_INVALID - the instance does not exist <br>
+     */
+    e_lwm2m_appfwk_itf_err_code_t remove(const lwm2m_appfwk_itf_oiid_t oiid);
+
+    /**
+     * @brief Write back all modified resident instances.
+     *
+     * @return false if at least one instance could not be written; it stays dirty.
+     */
+    bool flush();
+
+    /**
+     * @brief Number of instances currently in memory.
+     */
+    size_t residentCount() const;
+
+private:
+    struct Entry
+    {
+        LwM2MInstanceStore store;
+        bool dirty;
+        std::list<lwm2m_appfwk_itf_oiid_t>::iterator lru;
+    };
+
+    bool writeBack(const lwm2m_appfwk_itf_oiid_t oiid, Entry & entry);
+    void touch(Entry & entry);
+    void evict();
+
+    ILwM2MInstanceBackingStore & m_backing;
+    const size_t m_maxResident;
+    std::set<lwm2m_appfwk_itf_oiid_t> m_known;
+    std::map<lwm2m_appfwk_itf_oiid_t, Entry> m_resident;
+    std::list<lwm2m_appfwk_itf_oiid_t> m_lru;        // most recently used first
+};
+
+} /* namespace Connectivity */
+} /* namespace Stla */
+
+#endif /* LWM2MINSTANCECACHE_H_ */
@@ -0,0 +1,625 @@
+/**
+ * \file
+ *         LwM2MInstanceStore.cpp
+ * \brief
+ *         Compact in-memory representation of one LwM2M General Purpose object instance.
+ *
+ * \par Copyright Notice:
+ * \verbatim
+ * Copyright (c) 2021 Stellantis N.V.
+ * All Rights Reserved.
+ * The reproduction, transmission or use of this document or its contents is
+ * not permitted without express written authority.
+ * Offenders will be liable for damages. All rights, including rights created
+ * by patent grant or registration of a utility model or design, are reserved.
+ * \endverbatim
+ */
+
+#include "LwM2MInstanceStore.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+namespace Stla
+{
+namespace Connectivity
+{
+namespace
+{
+bool slotLess(const LwM2MInstanceStore::Slot & slot, const lwm2m_appfwk_itf_rid_t rid)
+{
+    return slot.rid < rid;
+}
+
+bool slotRidLess(const LwM2MInstanceStore::Slot & lhs, const LwM2MInstanceStore::Slot & rhs)
+{
+    return lhs.rid < rhs.rid;
+}
+
+bool hasBytes(const uint8_t type)
+{
+    return (type == RES_TYPE_STRING) || (type == RES_TYPE_OPAQUE);
+}
+
+// Binary image: magic, symbolic name (rid, size, bytes), slot count, slots, arena size, arena.
+const uint32_t IMAGE_MAGIC = 0x4C4D3201;
+
+template<typename T>
+void append(std::vector<unsigned char> & out, const T & value)
+{
+    const unsigned char * bytes = reinterpret_cast<const unsigned char *>(&value);
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+template<typename T>
+bool extract(const unsigned char * & pos, const unsigned char * end, T & value)
+{
+    if (static_cast<size_t>(end - pos) < sizeof(T))
+    {
+        return false;
+    }
+    std::memcpy(&value, pos, sizeof(T));
+    pos += sizeof(T);
+    return true;
+}
+
+// A bool object holding another byte than 0 or 1 is undefined behaviour: the bool members of a slot image
+// are checked before the image is copied into a Slot.
+bool hasValidBools(const unsigned char * slot)
+{
+    const bool boolean = slot[offsetof(LwM2MInstanceStore::Slot, type)] == RES_TYPE_BOOLEAN;
+    return (slot[offsetof(LwM2MInstanceStore::Slot, readOnly)] <= 1)
+            && (!boolean || (slot[offsetof(LwM2MInstanceStore::Slot, value)] <= 1));
+}
+} // namespace
+
+const uint32_t LwM2MInstanceStore::INLINE_SIZE;
+
+LwM2MInstanceStore::LwM2MInstanceStore() :
+        m_arenaGarbage(0)
+{
+    m_symbolicName.rid = 0;
+}
+
+e_lwm2m_appfwk_itf_err_code_t LwM2MInstanceStore::importInstance(
+        const str_instance_t & instance)
+{
+    clear();
+    m_symbolicName = instance.symbolic_name;
+
+    std::vector<str_resource_value_t> values;
+    str_resource_value_t value = str_resource_value_t();
+    std::vector<bool> access;
+
+    for (int ro = 1; ro >= 0; --ro)
+    {
+        const std::vector<str_string_resource_t> & strings = ro ? instance.read_only_string_list : instance.read_write_string_list;
+        value.type = RES_TYPE_STRING;
+        for (size_t i = 0; i < strings.size(); ++i)
+        {
+            value.rid = strings[i].rid;
+            value.string_value = strings[i].value;
+            values.push_back(value);
+            access.push_back(ro);
+        }
+        value.string_value.clear();
+
+        const std::vector<str_integer_resource_t> & integers = ro ? instance.read_only_integer_list : instance.read_write_integer_list;
+        value.type = RES_TYPE_INTEGER;
+        for (size_t i = 0; i < integers.size(); ++i)
+        {
+            value.rid = integers[i].rid;
+            value.integer_value = integers[i].value;
+            values.push_back(value);
+            access.push_back(ro);
+        }
+
+        const std::vector<str_float_resource_t> & floats = ro ? instance.read_only_float_list : instance.read_write_float_list;
+        value.type = RES_TYPE_FLOAT;
+        for (size_t i = 0; i < floats.size(); ++i)
+        {
+            value.rid = floats[i].rid;
+            value.float_value = floats[i].value;
+            values.push_back(value);
+            access.push_back(ro);
+        }
+
+        const std::vector<str_boolean_resource_t> & booleans = ro ? instance.read_only_boolean_list : instance.read_write_boolean_list;
+        value.type = RES_TYPE_BOOLEAN;
+        for (size_t i = 0; i < booleans.size(); ++i)
+        {
+            value.rid = booleans[i].rid;
+            value.boolean_value = booleans[i].value;
+            values.push_back(value);
+            access.push_back(ro);
+        }
+
+        const std::vector<str_opaque_resource_t> & opaques = ro ? instance.read_only_opaque_list : instance.read_write_opaque_list;
+        value.type = RES_TYPE_OPAQUE;
+        for (size_t i = 0; i < opaques.size(); ++i)
+        {
+            value.rid = opaques[i].rid;
+            value.opaque_value = opaques[i].value;
+            values.push_back(value);
+            access.push_back(ro);
+        }
+        value.opaque_value.clear();
+
+        const std::vector<str_integer_resource_t> & times = ro ? instance.read_only_time_list : instance.read_write_time_list;
+        value.type = RES_TYPE_TIME;
+        for (size_t i = 0; i < times.size(); ++i)
+        {
+            value.rid = times[i].rid;
+            value.integer_value = times[i].value;
+            values.push_back(value);
+            access.push_back(ro);
+        }
+
+        const std::vector<str_objlnk_resource_t> & objlnks = ro ? instance.read_only_objlnk_list : instance.read_write_objlnk_list;
+        value.type = RES_TYPE_OBJLNK;
+        for (size_t i = 0; i < objlnks.size(); ++i)
+        {
+            value.rid = objlnks[i].rid;
+            value.lnk_oid = objlnks[i].lnk_oid;
+            value.lnk_oiid = objlnks[i].lnk_oiid;
+            values.push_back(value);
+            access.push_back(ro);
+        }
+    }
+
+    // Build the table in one pass and sort it once, instead of inserting each slot at its place.
+    m_slots.reserve(values.size());
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        Slot slot;
+        std::memset(&slot, 0, sizeof(slot));
+        slot.rid = values[i].rid;
+        slot.type = static_cast<uint8_t>(values[i].type);
+        slot.readOnly = access[i];
+        switch (values[i].type)
+        {
+        case RES_TYPE_STRING:
+            storeBytes(slot, reinterpret_cast<const unsigned char *>(values[i].string_value.data()),
+                    static_cast<uint32_t>(values[i].string_value.size()));
+            break;
+        case RES_TYPE_OPAQUE:
+            storeBytes(slot, values[i].opaque_value.empty() ? nullptr : &values[i].opaque_value[0],
+                    static_cast<uint32_t>(values[i].opaque_value.size()));
+            break;
+        case RES_TYPE_FLOAT:
+            slot.value.real = values[i].float_value;
+            break;
+        case RES_TYPE_BOOLEAN:
+            slot.value.boolean = values[i].boolean_value;
+            break;
+        case RES_TYPE_OBJLNK:
+            slot.value.lnk.oid = values[i].lnk_oid;
+            slot.value.lnk.oiid = values[i].lnk_oiid;
+            break;
+        default:
+            slot.value.integer = values[i].integer_value;
+            break;
+        }
+        m_slots.push_back(slot);
+    }
+    std::sort(m_slots.begin(), m_slots.end(), slotRidLess);
+
+    for (size_t i = 1; i < m_slots.size(); ++i)
+    {
+        if (m_slots[i - 1].rid == m_slots[i].rid)
+        {
+            clear();
+            return INVALID_RID;
+        }
+    }
+    return OK;
+}
+
+void LwM2MInstanceStore::exportInstance(str_instance_t & instance) const
+{
+    instance = str_instance_t();
+    instance.symbolic_name = m_symbolicName;
+
+    for (std::vector<Slot>::const_iterator it = m_slots.begin(); it != m_slots.end(); ++it)
+    {
+        const Slot & slot = *it;
+        switch (slot.type)
+        {
+        case RES_TYPE_STRING:
+        {
+            str_string_resource_t resource;
+            resource.rid = slot.rid;
+            resource.value.assign(reinterpret_cast<const char *>(data(slot)), slot.size);
+            (slot.readOnly ? instance.read_only_string_list : instance.read_write_string_list).push_back(resource);
+            break;
+        }
+        case RES_TYPE_INTEGER:
+        case RES_TYPE_TIME:
+        {
+            str_integer_resource_t resource;
+            resource.rid = slot.rid;
+            resource.value = slot.value.integer;
+            if (slot.type == RES_TYPE_INTEGER)
+            {
+                (slot.readOnly ? instance.read_only_integer_list : instance.read_write_integer_list).push_back(resource);
+            }
+            else
+            {
+                (slot.readOnly ? instance.read_only_time_list : instance.read_write_time_list).push_back(resource);
+            }
+            break;
+        }
+        case RES_TYPE_FLOAT:
+        {
+            str_float_resource_t resource;
+            resource.rid = slot.rid;
+            resource.value = slot.value.real;
+            (slot.readOnly ? instance.read_only_float_list : instance.read_write_float_list).push_back(resource);
+            break;
+        }
+        case RES_TYPE_BOOLEAN:
+        {
+            str_boolean_resource_t resource;
+            resource.rid = slot.rid;
+            resource.value = slot.value.boolean;
+            (slot.readOnly ? instance.read_only_boolean_list : instance.read_write_boolean_list).push_back(resource);
+            break;
+        }
+        case RES_TYPE_OPAQUE:
+        {
+            str_opaque_resource_t resource;
+            resource.rid = slot.rid;
+            resource.value.assign(data(slot), data(slot) + slot.size);
+            (slot.readOnly ? instance.read_only_opaque_list : instance.read_write_opaque_list).push_back(resource);
+            break;
+        }
+        case RES_TYPE_OBJLNK:
+        {
+            str_objlnk_resource_t resource;
+            resource.rid = slot.rid;
+            resource.lnk_oid = slot.value.lnk.oid;
+            resource.lnk_oiid = slot.value.lnk.oiid;
+            (slot.readOnly ? instance.read_only_objlnk_list : instance.read_write_objlnk_list).push_back(resource);
+            break;
+        }
+        default:
+            break;
+        }
+    }
+}
+
+const str_string_resource_t & LwM2MInstanceStore::symbolicName() const
+{
+    return m_symbolicName;
+}
+
+void LwM2MInstanceStore::setSymbolicName(const str_string_resource_t & symbolic_name)
+{
+    m_symbolicName = symbolic_name;
+}
+
+const LwM2MInstanceStore::Slot * LwM2MInstanceStore::find(
+        const lwm2m_appfwk_itf_rid_t rid) const
+{
+    std::vector<Slot>::const_iterator it = lowerBound(rid);
+    if ((it == m_slots.end()) || (it->rid != rid))
+    {
+        return nullptr;
+    }
+    return &(*it);
+}
+
+e_lwm2m_appfwk_itf_err_code_t LwM2MInstanceStore::get(
+        str_resource_value_t & resource) const
+{
+    const Slot * slot = find(resource.rid);
+    if (slot == nullptr)
+    {
+        return NOT_FOUND;
+    }
+
+    resource.type = static_cast<e_lwm2m_appfwk_itf_res_type_t>(slot->type);
+    switch (slot->type)
+    {
+    case RES_TYPE_STRING:
+        resource.string_value.assign(reinterpret_cast<const char *>(data(*slot)), slot->size);
+        break;
+    case RES_TYPE_OPAQUE:
+        resource.opaque_value.assign(data(*slot), data(*slot) + slot->size);
+        break;
+    case RES_TYPE_FLOAT:
+        resource.float_value = slot->value.real;
+        break;
+    case RES_TYPE_BOOLEAN:
+        resource.boolean_value = slot->value.boolean;
+        break;
+    case RES_TYPE_OBJLNK:
+        resource.lnk_oid = slot->value.lnk.oid;
+        resource.lnk_oiid = slot->value.lnk.oiid;
+        break;
+    default:
+        resource.integer_value = slot->value.integer;
+        break;
+    }
+    return OK;
+}
+
+e_lwm2m_appfwk_itf_err_code_t LwM2MInstanceStore::check(
+        const str_resource_value_t & resource) const
+{
+    if (resource.type > RES_TYPE_OBJLNK)
+    {
+        return INVALID_RID;
+    }
+    const Slot * slot = find(resource.rid);
+    if ((slot != nullptr) && (slot->type != resource.type))
+    {
+        return INVALID_RID;
+    }
+    return OK;
+}
+
+e_lwm2m_appfwk_itf_err_code_t LwM2MInstanceStore::set(
+        const str_resource_value_t & resource, const bool readOnly)
+{
+    e_lwm2m_appfwk_itf_err_code_t result = check(resource);
+    if (result != OK)
+    {
+        return result;
+    }
+
+    std::vector<Slot>::iterator it = lowerBound(resource.rid);
+    if ((it == m_slots.end()) || (it->rid != resource.rid))
+    {
+        Slot slot;
+        std::memset(&slot, 0, sizeof(slot));
+        slot.rid = resource.rid;
+        slot.type = static_cast<uint8_t>(resource.type);
+        slot.readOnly = readOnly;
+        it = m_slots.insert(it, slot);
+    }
+
+    Slot & slot = *it;
+    switch (resource.type)
+    {
+    case RES_TYPE_STRING:
+        storeBytes(slot, reinterpret_cast<const unsigned char *>(resource.string_value.data()),
+                static_cast<uint32_t>(resource.string_value.size()));
+        break;
+    case RES_TYPE_OPAQUE:
+        storeBytes(slot, resource.opaque_value.empty() ? nullptr : &resource.opaque_value[0],
+                static_cast<uint32_t>(resource.opaque_value.size()));
+        break;
+    case RES_TYPE_FLOAT:
+        slot.value.real = resource.float_value;
+        break;
+    case RES_TYPE_BOOLEAN:
+        slot.value.boolean = resource.boolean_value;
+        break;
+    case RES_TYPE_OBJLNK:
+        slot.value.lnk.oid = resource.lnk_oid;
+        slot.value.lnk.oiid = resource.lnk_oiid;
+        break;
+    default:
+        slot.value.integer = resource.integer_value;
+        break;
+    }
+    compactArena();
+    return OK;
+}
+
+e_lwm2m_appfwk_itf_err_code_t LwM2MInstanceStore::remove(
+        const lwm2m_appfwk_itf_rid_t rid)
+{
+    std::vector<Slot>::iterator it = lowerBound(rid);
+    if ((it == m_slots.end()) || (it->rid != rid))
+    {
+        return NOT_FOUND;
+    }
+    releaseBytes(*it);
+    m_slots.erase(it);
+    compactArena();
+    return OK;
+}
+
+void LwM2MInstanceStore::getResourceIds(
+        str_instance_resources_t & instance_rids) const
+{
+    instance_rids.rids.clear();
+    instance_rids.rids.reserve(m_slots.size());
+    for (std::vector<Slot>::const_iterator it = m_slots.begin(); it != m_slots.end(); ++it)
+    {
+        instance_rids.rids.push_back(it->rid);
+    }
+}
+
+const std::vector<LwM2MInstanceStore::Slot> & LwM2MInstanceStore::slots() const
+{
+    return m_slots;
+}
+
+const unsigned char * LwM2MInstanceStore::data(const Slot & slot) const
+{
+    if (slot.size <= INLINE_SIZE)
+    {
+        return slot.value.bytes;
+    }
+    return &m_arena[slot.value.offset];
+}
+
+void LwM2MInstanceStore::serialize(std::vector<unsigned char> & out) const
+{
+    append(out, IMAGE_MAGIC);
+    append(out, m_symbolicName.rid);
+    append(out, static_cast<uint32_t>(m_symbolicName.value.size()));
+    out.insert(out.end(), m_symbolicName.value.begin(), m_symbolicName.value.end());
+
+    // Slots are written with arena offsets relative to a compacted arena.
+    append(out, static_cast<uint32_t>(m_slots.size()));
+    uint32_t arenaSize = 0;
+    for (std::vector<Slot>::const_iterator it = m_slots.begin(); it != m_slots.end(); ++it)
+    {
+        Slot slot = *it;
+        if (hasBytes(slot.type) && (slot.size > INLINE_SIZE))
+        {
+            slot.value.offset = arenaSize;
+            arenaSize += slot.size;
+        }
+        append(out, slot);
+    }
+    append(out, arenaSize);
+    for (std::vector<Slot>::const_iterator it = m_slots.begin(); it != m_slots.end(); ++it)
+    {
+        if (hasBytes(it->type) && (it->size > INLINE_SIZE))
+        {
+            out.insert(out.end(), data(*it), data(*it) + it->size);
+        }
+    }
+}
+
+bool LwM2MInstanceStore::deserialize(const unsigned char * data, const size_t size)
+{
+    clear();
+    const unsigned char * pos = data;
+    const unsigned char * end = data + size;
+
+    uint32_t magic;
+    uint32_t nameSize;
+    if (!extract(pos, end, magic) || (magic != IMAGE_MAGIC) || !extract(pos, end, m_symbolicName.rid)
+            || !extract(pos, end, nameSize) || (static_cast<size_t>(end - pos) < nameSize))
+    {
+        clear();
+        return false;
+    }
+    m_symbolicName.value.assign(reinterpret_cast<const char *>(pos), nameSize);
+    pos += nameSize;
+
+    uint32_t slotCount;
+    if (!extract(pos, end, slotCount) || ((static_cast<size_t>(end - pos) / sizeof(Slot)) < slotCount))
+    {
+        clear();
+        return false;
+    }
+    m_slots.resize(slotCount);
+    for (uint32_t i = 0; i < slotCount; ++i)
+    {
+        if (!hasValidBools(pos))
+        {
+            clear();
+            return false;
+        }
+        extract(pos, end, m_slots[i]);
+    }
+
+    uint32_t arenaSize;
+    if (!extract(pos, end, arenaSize) || (static_cast<size_t>(end - pos) != arenaSize))
+    {
+        clear();
+        return false;
+    }
+    m_arena.assign(pos, end);
+
+    for (uint32_t i = 0; i < slotCount; ++i)
+    {
+        const Slot & slot = m_slots[i];
+        const bool sorted = (i == 0) || (m_slots[i - 1].rid < slot.rid);
+        const bool inArena = !hasBytes(slot.type) || (slot.size <= INLINE_SIZE)
+                || ((slot.value.offset <= arenaSize) && (slot.size <= arenaSize - slot.value.offset));
+        if (!sorted || (slot.type > RES_TYPE_OBJLNK) || !inArena)
+        {
+            clear();
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t LwM2MInstanceStore::memoryUsage() const
+{
+    return (m_slots.capacity() * sizeof(Slot)) + m_arena.capacity() + m_symbolicName.value.capacity();
+}
+
+std::vector<LwM2MInstanceStore::Slot>::iterator LwM2MInstanceStore::lowerBound(
+        const lwm2m_appfwk_itf_rid_t rid)
+{
+    return std::lower_bound(m_slots.begin(), m_slots.end(), rid, slotLess);
+}
+
+std::vector<LwM2MInstanceStore::Slot>::const_iterator LwM2MInstanceStore::lowerBound(
+        const lwm2m_appfwk_itf_rid_t rid) const
+{
+    return std::lower_bound(m_slots.begin(), m_slots.end(), rid, slotLess);
+}
+
+void LwM2MInstanceStore::storeBytes(Slot & slot, const unsigned char * bytes,
+        const uint32_t size)
+{
+    if ((slot.size > INLINE_SIZE) && (size > INLINE_SIZE) && (size <= slot.size))
+    {
+        // Overwrite in place, the tail of the previous value becomes garbage.
+        std::memcpy(&m_arena[slot.value.offset], bytes, size);
+        m_arenaGarbage += slot.size - size;
+        slot.size = size;
+        return;
+    }
+
+    releaseBytes(slot);
+    if (size <= INLINE_SIZE)
+    {
+        if (size > 0)
+        {
+            std::memcpy(slot.value.bytes, bytes, size);
+        }
+    }
+    else
+    {
+        slot.value.offset = static_cast<uint32_t>(m_arena.size());
+        m_arena.insert(m_arena.end(), bytes, bytes + size);
+    }
+    slot.size = size;
+}
+
+void LwM2MInstanceStore::releaseBytes(Slot & slot)
+{
+    if (hasBytes(slot.type) && (slot.size > INLINE_SIZE))
+    {
+        m_arenaGarbage += slot.size;
+    }
+    slot.size = 0;
+}
+
+void LwM2MInstanceStore::clear()
+{
+    m_slots.clear();
+    m_arena.clear();
+    m_arenaGarbage = 0;
+    m_symbolicName.rid = 0;
+    m_symbolicName.value.clear();
+}
+
+void LwM2MInstanceStore::compactArena()
+{
+    if ((m_arenaGarbage == 0) || (m_arenaGarbage * 2 < m_arena.size()))
+    {
+        return;
+    }
+
+    std::vector<unsigned char> arena;
+    arena.reserve(m_arena.size() - m_arenaGarbage);
+    for (std::vector<Slot>::iterator it = m_slots.begin(); it != m_slots.end(); ++it)
+    {
+        if (hasBytes(it->type) && (it->size > INLINE_SIZE))
+        {
+            const uint32_t offset = static_cast<uint32_t>(arena.size());
+            arena.insert(arena.end(), m_arena.begin() + it->value.offset,
+                    m_arena.begin() + it->value.offset + it->size);
+            it->value.offset = offset;
+        }
+    }
+    m_arena.swap(arena);
+    m_arenaGarbage = 0;
+}
+
+} /* namespace Connectivity */
+} /* namespace Stla */
@@ -0,0 +1,187 @@
+/**
+ * \file
+ *         LwM2MInstanceStore.hpp
+ * \brief
+ *         Compact in-memory representation of one LwM2M General Purpose object instance.
+ *
+ * \par Copyright Notice:
+ * \verbatim
+ * Copyright (c) 2021 Stellantis N.V.
+ * All Rights Reserved.
+ * The reproduction, transmission or use of this document or its contents is
+ * not permitted without express written authority.
+ * Offenders will be liable for damages. All rights, including rights created
+ * by patent grant or registration of a utility model or design, are reserved.
+ * \endverbatim
+ */
+
+#ifndef LWM2MINSTANCESTORE_H_
+#define LWM2MINSTANCESTORE_H_
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "ILwM2MAppFwkTypes.hpp"
+
+namespace Stla
+{
+namespace Connectivity
+{
+/**
+ * LwM2MInstanceStore holds the resources of one object instance in a single table of slots sorted by rid.
+ *
+ * Scalar values (integer, float, boolean, time, objlnk) and strings / opaques of up to INLINE_SIZE bytes
+ * are stored inside the slot. Longer strings and opaques are stored in one byte arena shared by the instance.
+ * Lookup by rid is a binary search, and an instance costs two allocations whatever its number of resources.
+ *
+ * str_instance_t is only used to import and export a whole instance.
+ */
+class LwM2MInstanceStore
+{
+public:
+    /**
+     * @brief Maximum size of a string or opaque value stored inside its slot.
+     */
+    static const uint32_t INLINE_SIZE = 8;
+
+    /**
+     * @brief One resource of the instance.
+     */
+    struct Slot
+    {
+        lwm2m_appfwk_itf_rid_t rid;
+        uint8_t type;                   // e_lwm2m_appfwk_itf_res_type_t
+        bool readOnly;
+        uint32_t size;                  // size of string / opaque values
+        union
+        {
+            int64_t integer;            // RES_TYPE_INTEGER, RES_TYPE_TIME
+            double real;                // RES_TYPE_FLOAT
+            bool boolean;               // RES_TYPE_BOOLEAN
+            struct
+            {
+                lwm2m_appfwk_itf_oid_t oid;
+                lwm2m_appfwk_itf_oiid_t oiid;
+            } lnk;                      // RES_TYPE_OBJLNK
+            uint32_t offset;            // RES_TYPE_STRING, RES_TYPE_OPAQUE when size > INLINE_SIZE
+            unsigned char bytes[INLINE_SIZE]; // RES_TYPE_STRING, RES_TYPE_OPAQUE when size <= INLINE_SIZE
+        } value;
+    };
+
+    LwM2MInstanceStore();
+
+    /**
+     * @brief Replace the content of the store with the resources of instance.
+     *
+     * @return
+     * OK (0) - success <br>
+     * INVALID_RID - the same rid is present twice in instance; the store is left empty <br>
+     */
+    e_lwm2m_appfwk_itf_err_code_t importInstance(const str_instance_t & instance);
+
+    /**
+     * @brief Fill instance with the resources of the store, sorted by rid in each list.
+     */
+    void exportInstance(str_instance_t & instance) const;
+
+    /**
+     * @brief Symbolic Name resource of the instance.
+     */
+    const str_string_resource_t & symbolicName() const;
+    void setSymbolicName(const str_string_resource_t & symbolic_name);
+
+    /**
+     * @brief Find the slot of a resource.
+     *
+     * @return the slot, or nullptr if rid is not set. The pointer is valid until the next modification of the store.
+     */
+    const Slot * find(const lwm2m_appfwk_itf_rid_t rid) const;
+
+    /**
+     * @brief Read a resource value.
+     *
+     * @param resource resource structure with the desired rid set - on success, type and value are set.
+     *
+     * @return
+     * OK (0) - success <br>
+     * NOT_FOUND - resource not found <br>
+     */
+    e_lwm2m_appfwk_itf_err_code_t get(str_resource_value_t & resource) const;
+
+    /**
+     * @brief Write a resource value, creating the resource if needed.
+     *
+     * @param resource rid, type and value to write.
+     * @param readOnly access of the resource when it is created; ignored for an existing resource.
+     *
+     * @return
+     * OK (0) - success <br>
+     * INVALID_RID - the resource exists with another type <br>
+     */
+    e_lwm2m_appfwk_itf_err_code_t set(const str_resource_value_t & resource, const bool readOnly);
+
+    /**
+     * @brief Check that set() would accept resource, without writing it.
+     */
+    e_lwm2m_appfwk_itf_err_code_t check(const str_resource_value_t & resource) const;
+
+    /**
+     * @brief Remove a resource.
+     *
+     * @return
+     * OK (0) - success <br>
+     * NOT_FOUND - resource not found <br>
+     */
+    e_lwm2m_appfwk_itf_err_code_t remove(const lwm2m_appfwk_itf_rid_t rid);
+
+    /**
+     * @brief Resource IDs of the instance, sorted.
+     */
+    void getResourceIds(str_instance_resources_t & instance_rids) const;
+
+    /**
+     * @brief All slots of the instance, sorted by rid.
+     */
+    const std::vector<Slot> & slots() const;
+
+    /**
+     * @brief Pointer to the bytes of a string or opaque slot.
+     */
+    const unsigned char * data(const Slot & slot) const;
+
+    /**
+     * @brief Append the binary image of the store to out, for local persistence (host byte order).
+     */
+    void serialize(std::vector<unsigned char> & out) const;
+
+    /**
+     * @brief Replace the content of the store with a binary image produced by serialize().
+     *
+     * @return false if the image is malformed (including a boolean byte other than 0 or 1); the store is left empty.
+     */
+    bool deserialize(const unsigned char * data, const size_t size);
+
+    /**
+     * @brief Approximate heap memory used by the store, in bytes.
+     */
+    size_t memoryUsage() const;
+
+private:
+    std::vector<Slot>::iterator lowerBound(const lwm2m_appfwk_itf_rid_t rid);
+    std::vector<Slot>::const_iterator lowerBound(const lwm2m_appfwk_itf_rid_t rid) const;
+    void storeBytes(Slot & slot, const unsigned char * bytes, const uint32_t size);
+    void releaseBytes(Slot & slot);
+    void compactArena();
+    void clear();
+
+    std::vector<Slot> m_slots;
+    std::vector<unsigned char> m_arena;
+    uint32_t m_arenaGarbage;
+    str_string_resource_t m_symbolicName;
+};
+
+} /* namespace Connectivity */
+} /* namespace Stla */
+
+#endif /* LWM2MINSTANCESTORE_H_ */
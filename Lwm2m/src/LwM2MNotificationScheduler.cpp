@@ -0,0 +1,149 @@
+/**
+ * \file
+ *         LwM2MNotificationScheduler.cpp
+ * \brief
+ *         Enforcement of pmin / pmax / step notification attributes for the resources of one object instance.
+ *
+ * \par Copyright Notice:
+ * \verbatim
+ * Copyright (c) 2021 Stellantis N.V.
+ * All Rights Reserved.
+ * The reproduction, transmission or use of this document or its contents is
+ * not permitted without express written authority.
+ * Offenders will be liable for damages. All rights, including rights created
+ * by patent grant or registration of a utility model or design, are reserved.
+ * \endverbatim
+ */
+
+#include "LwM2MNotificationScheduler.hpp"
+
+#include <cmath>
+
+namespace Stla
+{
+namespace Connectivity
+{
+namespace
+{
+const uint64_t MS_PER_SECOND = 1000;
+
+bool isNumeric(const e_lwm2m_appfwk_itf_res_type_t type)
+{
+    return (type == RES_TYPE_INTEGER) || (type == RES_TYPE_FLOAT) || (type == RES_TYPE_TIME);
+}
+
+double numericValue(const str_resource_value_t & value)
+{
+    return (value.type == RES_TYPE_FLOAT) ? value.float_value : static_cast<double>(value.integer_value);
+}
+} // namespace
+
+const uint64_t LwM2MNotificationScheduler::NO_DEADLINE;
+
+LwM2MNotificationScheduler::State::State() :
+        attributes(), current(), notified(), notifiedMs(0), hasCurrent(false), hasNotified(false), pending(false)
+{
+}
+
+LwM2MNotificationScheduler::LwM2MNotificationScheduler()
+{
+}
+
+e_lwm2m_appfwk_itf_err_code_t LwM2MNotificationScheduler::setAttributes(
+        const str_notification_attributes_t & attributes)
+{
+    if ((attributes.step < 0) || ((attributes.pmax != 0) && (attributes.pmax < attributes.pmin)))
+    {
+        return INVALID_RID;
+    }
+    m_states[attributes.rid].attributes = attributes;
+    return OK;
+}
+
+void LwM2MNotificationScheduler::getAttributes(
+        str_notification_attributes_t & attributes) const
+{
+    std::map<lwm2m_appfwk_itf_rid_t, State>::const_iterator it = m_states.find(attributes.rid);
+    if (it == m_states.end())
+    {
+        attributes.pmin = 0;
+        attributes.pmax = 0;
+        attributes.step = 0;
+        return;
+    }
+    attributes = it->second.attributes;
+}
+
+void LwM2MNotificationScheduler::removeResource(const lwm2m_appfwk_itf_rid_t rid)
+{
+    m_states.erase(rid);
+}
+
+bool LwM2MNotificationScheduler::resourceChanged(
+        const str_resource_value_t & value)
+{
+    State & state = m_states[value.rid];
+    state.attributes.rid = value.rid;
+    state.current = value;
+    state.hasCurrent = true;
+
+    // A value coming back within step of the last notified one cancels the pending notification.
+    state.pending = isMeaningful(state, value);
+    return state.pending;
+}
+
+uint64_t LwM2MNotificationScheduler::collect(const uint64_t nowMs,
+        std::vector<str_resource_value_t> & batch)
+{
+    uint64_t deadline = NO_DEADLINE;
+    for (std::map<lwm2m_appfwk_itf_rid_t, State>::iterator it = m_states.begin(); it != m_states.end(); ++it)
+    {
+        State & state = it->second;
+        const uint64_t due = nextDeadline(state);
+        if (due <= nowMs)
+        {
+            batch.push_back(state.current);
+            state.notified = state.current;
+            state.notifiedMs = nowMs;
+            state.hasNotified = true;
+            state.pending = false;
+        }
+        const uint64_t next = nextDeadline(state);
+        if (next < deadline)
+        {
+            deadline = next;
+        }
+    }
+    return deadline;
+}
+
+bool LwM2MNotificationScheduler::isMeaningful(const State & state,
+        const str_resource_value_t & value)
+{
+    if (!state.hasNotified || (state.attributes.step <= 0) || !isNumeric(value.type) || (value.type != state.notified.type))
+    {
+        return true;
+    }
+    return std::fabs(numericValue(value) - numericValue(state.notified)) >= state.attributes.step;
+}
+
+uint64_t LwM2MNotificationScheduler::nextDeadline(const State & state)
+{
+    uint64_t deadline = NO_DEADLINE;
+    if (state.pending)
+    {
+        deadline = state.hasNotified ? state.notifiedMs + (state.attributes.pmin * MS_PER_SECOND) : 0;
+    }
+    if (state.hasCurrent && state.hasNotified && (state.attributes.pmax != 0))
+    {
+        const uint64_t pmaxDeadline = state.notifiedMs + (state.attributes.pmax * MS_PER_SECOND);
+        if (pmaxDeadline < deadline)
+        {
+            deadline = pmaxDeadline;
+        }
+    }
+    return deadline;
+}
+
+} /* namespace Connectivity */
+} /* namespace Stla */
@@ -0,0 +1,106 @@
+/**
+ * \file
+ *         LwM2MNotificationScheduler.hpp
+ * \brief
+ *         Enforcement of pmin / pmax / step notification attributes for the resources of one object instance.
+ *
+ * \par Copyright Notice:
+ * \verbatim
+ * Copyright (c) 2021 Stellantis N.V.
+ * All Rights Reserved.
+ * The reproduction, transmission or use of this document or its contents is
+ * not permitted without express written authority.
+ * Offenders will be liable for damages. All rights, including rights created
+ * by patent grant or registration of a utility model or design, are reserved.
+ * \endverbatim
+ */
+
+#ifndef LWM2MNOTIFICATIONSCHEDULER_H_
+#define LWM2MNOTIFICATIONSCHEDULER_H_
+
+#include <map>
+#include <vector>
+#include <cstdint>
+
+#include "ILwM2MAppFwkTypes.hpp"
+
+namespace Stla
+{
+namespace Connectivity
+{
+/**
+ * LwM2MNotificationScheduler decides which resource changes of an instance are notified, and when.
+ *
+ * Each change is recorded with resourceChanged(). The owner calls collect() when the deadline returned
+ * by the previous call is reached (or after a change), and sends the collected resources as one batch.
+ * Resources without attributes are notified at the next collect() after each change.
+ *
+ * Times are monotonic, in milliseconds. The class is not thread-safe.
+ */
+class LwM2MNotificationScheduler
+{
+public:
+    /**
+     * @brief Value returned by collect() when no notification is scheduled.
+     */
+    static const uint64_t NO_DEADLINE = UINT64_MAX;
+
+    LwM2MNotificationScheduler();
+
+    /**
+     * @brief Set the attributes of a resource, replacing the previous ones.
+     *
+     * @return
+     * OK (0) - success <br>
+     * INVALID_RID - step is negative, or pmax is not 0 and lower than pmin <br>
+     */
+    e_lwm2m_appfwk_itf_err_code_t setAttributes(const str_notification_attributes_t & attributes);
+
+    /**
+     * @brief Get the attributes of a resource, all 0 if none are set.
+     */
+    void getAttributes(str_notification_attributes_t & attributes) const;
+
+    /**
+     * @brief Forget a resource (e.g. resource deleted).
+     */
+    void removeResource(const lwm2m_appfwk_itf_rid_t rid);
+
+    /**
+     * @brief Record a new value of a resource.
+     *
+     * @return true if the change is meaningful and a notification is now pending for the resource.
+     */
+    bool resourceChanged(const str_resource_value_t & value);
+
+    /**
+     * @brief Append to batch the resources due for notification at nowMs, and mark them as notified.
+     *
+     * @return the time of the next scheduled notification, or NO_DEADLINE.
+     */
+    uint64_t collect(const uint64_t nowMs, std::vector<str_resource_value_t> & batch);
+
+private:
+    struct State
+    {
+        State();
+
+        str_notification_attributes_t attributes;
+        str_resource_value_t current;       // last value written
+        str_resource_value_t notified;      // last value notified
+        uint64_t notifiedMs;
+        bool hasCurrent;
+        bool hasNotified;
+        bool pending;
+    };
+
+    static bool isMeaningful(const State & state, const str_resource_value_t & value);
+    static uint64_t nextDeadline(const State & state);
+
+    std::map<lwm2m_appfwk_itf_rid_t, State> m_states;
+};
+
+} /* namespace Connectivity */
+} /* namespace Stla */
+
+#endif /* LWM2MNOTIFICATIONSCHEDULER_H_ */
@@ -0,0 +1,309 @@
+/**
+ * \file
+ *         LwM2MLoadDriver.cpp
+ * \brief
+ *         Scripted load of LwM2M server operations against LwM2MServerStandIn, for load runs on a X86 PC target
+ *
+ * \par Copyright Notice:
+ * \verbatim
+ * Copyright (c) 2021 Stellantis N.V.
+ * All Rights Reserved.
+ * The reproduction, transmission or use of this document or its contents is
+ * not permitted without express written authority.
+ * Offenders will be liable for damages. All rights, including rights created
+ * by patent grant or registration of a utility model or design, are reserved.
+ * \endverbatim
+ */
+
+#include "LwM2MLoadDriver.hpp"
+
+#include <sstream>
+
+#include <Poco/Delegate.h>
+
+namespace Stla
+{
+namespace Connectivity
+{
+
+namespace
+{
+struct ProfileKey
+{
+    const char * name;
+    uint32_t str_load_profile_t::*field;
+};
+
+const ProfileKey PROFILE_KEYS[] =
+{
+    { "instances", &str_load_profile_t::instances },
+    { "resources", &str_load_profile_t::resources },
+    { "observed", &str_load_profile_t::observed },
+    { "read", &str_load_profile_t::readWeight },
+    { "write", &str_load_profile_t::writeWeight },
+    { "execute", &str_load_profile_t::executeWeight },
+    { "appwrite", &str_load_profile_t::appWriteWeight },
+    { "executeDelayMs", &str_load_profile_t::executeDelayMs },
+    { "executeConcurrency", &str_load_profile_t::executeConcurrency },
+    { "durationMs", &str_load_profile_t::durationMs },
+    { "seed", &str_load_profile_t::seed }
+};
+
+const lwm2m_appfwk_itf_oiid_t MAX_INSTANCES = 0xFFFF;    // 0xFFFF is reserved by LwM2M
+const lwm2m_appfwk_itf_rid_t MAX_RESOURCES = 0xFFFE;     // keeps a rid for the executable resource
+} // namespace
+
+const lwm2m_appfwk_itf_rid_t LwM2MLoadDriver::SYMBOLIC_NAME_RID;
+
+str_load_profile_t LwM2MLoadDriver::defaultProfile()
+{
+    str_load_profile_t profile;
+    profile.instances = 10;
+    profile.resources = 20;
+    profile.observed = 5;
+    profile.readWeight = 60;
+    profile.writeWeight = 20;
+    profile.executeWeight = 5;
+    profile.appWriteWeight = 15;
+    profile.executeDelayMs = 0;
+    profile.executeConcurrency = 1;
+    profile.durationMs = 10000;
+    profile.seed = 1;
+    return profile;
+}
+
+bool LwM2MLoadDriver::parseProfile(std::istream & script, str_load_profile_t & profile, std::string & error)
+{
+    str_load_profile_t parsed = profile;
+    std::string line;
+    while (std::getline(script, line))
+    {
+        std::istringstream fields(line.substr(0, line.find('#')));
+        std::string key;
+        if (!(fields >> key))
+        {
+            continue;
+        }
+        const ProfileKey * entry = nullptr;
+        for (size_t i = 0; i < (sizeof(PROFILE_KEYS) / sizeof(PROFILE_KEYS[0])); ++i)
+        {
+            if (key == PROFILE_KEYS[i].name)
+            {
+                entry = &PROFILE_KEYS[i];
+            }
+        }
+        uint64_t value = 0;
+        std::string extra;
+        if ((entry == nullptr) || (fields.peek() == '-') || !(fields >> value) || (fields >> extra)
+                || (value > UINT32_MAX))
+        {
+            error = line;
+            return false;
+        }
+        parsed.*(entry->field) = static_cast<uint32_t>(value);
+    }
+
+    const uint64_t weights = static_cast<uint64_t>(parsed.readWeight) + parsed.writeWeight + parsed.executeWeight
+            + parsed.appWriteWeight;
+    if ((parsed.instances == 0) || (parsed.instances > MAX_INSTANCES) || (parsed.resources == 0)
+            || (parsed.resources > MAX_RESOURCES) || (parsed.observed > parsed.resources)
+            || (parsed.executeConcurrency == 0) || (parsed.durationMs == 0) || (weights == 0) || (weights > UINT32_MAX))
+    {
+        error = "inconsistent profile";
+        return false;
+    }
+    profile = parsed;
+    return true;
+}
+
+LwM2MLoadDriver::Application::Application(LwM2MLoadDriver & driver, const ILwM2MInstanceHandler::Ptr & handler) :
+        m_driver(driver),
+        m_handler(handler)
+{
+}
+
+void LwM2MLoadDriver::Application::onExecuteOperation(const void * pSender,
+        const str_executable_parameters_t & operation)
+{
+    (void) pSender;
+    m_driver.answer(m_handler, operation);
+}
+
+LwM2MLoadDriver::LwM2MLoadDriver(LwM2MServerStandIn & server) :
+        m_server(server),
+        m_objects(server.getObjectHandler(Poco::OSP::BundleContext::Ptr())),
+        m_profile(defaultProfile()),
+        m_notifications(0)
+{
+    m_server.NotifyReceived += Poco::delegate(this, &LwM2MLoadDriver::onNotifyReceived);
+}
+
+LwM2MLoadDriver::~LwM2MLoadDriver()
+{
+    teardown();
+    m_server.NotifyReceived -= Poco::delegate(this, &LwM2MLoadDriver::onNotifyReceived);
+}
+
+e_lwm2m_appfwk_itf_err_code_t LwM2MLoadDriver::setup(const str_load_profile_t & profile)
+{
+    teardown();
+    m_profile = profile;
+    m_random.seed(profile.seed);
+
+    str_instance_t instance;
+    instance.symbolic_name.rid = SYMBOLIC_NAME_RID;
+    for (lwm2m_appfwk_itf_rid_t rid = 1; rid <= profile.resources; ++rid)
+    {
+        const str_integer_resource_t resource = { rid, 0 };
+        instance.read_write_integer_list.push_back(resource);
+    }
+    str_execute_config_t config;
+    config.rid = executeRid();
+    config.max_concurrent = profile.executeConcurrency;
+    config.max_queued = LwM2MExecuteScheduler::DEFAULT_MAX_QUEUED;
+    config.timeout_ms = LwM2MExecuteScheduler::DEFAULT_TIMEOUT_MS;
+
+    for (lwm2m_appfwk_itf_oiid_t oiid = 0; oiid < profile.instances; ++oiid)
+    {
+        e_lwm2m_appfwk_itf_err_code_t result = m_objects->createNewInstance(oiid, instance);
+        const ILwM2MInstanceHandler::Ptr handler = m_objects->getLwM2MAppFwkObjectInstance(oiid);
+        if ((result == OK) && handler.isNull())
+        {
+            result = NOT_FOUND;
+        }
+        if (result == OK)
+        {
+            m_applications.emplace_back(*this, handler);
+            handler->ExecuteOperation += Poco::delegate(&m_applications.back(), &Application::onExecuteOperation);
+            result = handler->registerExecuteOpHandler(config.rid);
+        }
+        if (result == OK)
+        {
+            result = handler->setExecuteConfig(config);
+        }
+        for (lwm2m_appfwk_itf_rid_t rid = 1; (result == OK) && (rid <= profile.observed); ++rid)
+        {
+            result = m_server.serverObserve(oiid, rid, true);
+        }
+        if (result != OK)
+        {
+            teardown();
+            return result;
+        }
+    }
+    return OK;
+}
+
+void LwM2MLoadDriver::run(str_load_report_t & report)
+{
+    report.operations = 0;
+    report.failed = 0;
+    m_notifications = 0;
+    m_server.resetOperationStatistics();
+
+    const uint32_t weights = m_profile.readWeight + m_profile.writeWeight + m_profile.executeWeight
+            + m_profile.appWriteWeight;
+    const uint64_t start = LwM2MServerStandIn::nowMs();
+    uint64_t now = start;
+    while ((now - start) < m_profile.durationMs)
+    {
+        answerDue(now);
+        if (!issue(static_cast<uint32_t>(m_random() % weights)))
+        {
+            ++report.failed;
+        }
+        ++report.operations;
+        m_server.poll();
+        now = LwM2MServerStandIn::nowMs();
+    }
+    report.elapsedMs = now - start;
+
+    // The pending Execute operations are answered, so that they are counted with their real latency.
+    answerDue(LwM2MServerStandIn::NO_DEADLINE);
+    m_server.poll();
+
+    report.notifications = m_notifications;
+    report.operationsPerSec = (report.elapsedMs != 0) ? (report.operations * 1000.0) / report.elapsedMs : 0.0;
+    m_server.getOperationStatistics(report.statistics);
+}
+
+void LwM2MLoadDriver::teardown()
+{
+    m_pending.clear();
+    for (std::list<Application>::iterator application = m_applications.begin(); application != m_applications.end();
+            ++application)
+    {
+        application->m_handler->ExecuteOperation -= Poco::delegate(&*application, &Application::onExecuteOperation);
+        m_objects->deleteInstance(application->m_handler->getInstanceId());
+    }
+    m_applications.clear();
+}
+
+lwm2m_appfwk_itf_rid_t LwM2MLoadDriver::executeRid() const
+{
+    return static_cast<lwm2m_appfwk_itf_rid_t>(m_profile.resources + 1);
+}
+
+void LwM2MLoadDriver::answer(const ILwM2MInstanceHandler::Ptr & handler, const str_executable_parameters_t & operation)
+{
+    if (m_profile.executeDelayMs == 0)
+    {
+        handler->setExecuteOperationResult(operation.rid, operation.operation_id, true);
+        return;
+    }
+    PendingResult pending;
+    pending.dueMs = LwM2MServerStandIn::nowMs() + m_profile.executeDelayMs;
+    pending.handler = handler;
+    pending.rid = operation.rid;
+    pending.operationId = operation.operation_id;
+    m_pending.push_back(pending);
+}
+
+void LwM2MLoadDriver::answerDue(const uint64_t nowMs)
+{
+    // Answering may deliver queued operations, which are appended with a later due time.
+    while (!m_pending.empty() && (m_pending.front().dueMs <= nowMs))
+    {
+        const PendingResult pending = m_pending.front();
+        m_pending.pop_front();
+        pending.handler->setExecuteOperationResult(pending.rid, pending.operationId, true);
+    }
+}
+
+bool LwM2MLoadDriver::issue(const uint32_t pick)
+{
+    const lwm2m_appfwk_itf_oiid_t oiid = static_cast<lwm2m_appfwk_itf_oiid_t>(m_random() % m_profile.instances);
+    const lwm2m_appfwk_itf_rid_t rid = static_cast<lwm2m_appfwk_itf_rid_t>(1 + (m_random() % m_profile.resources));
+    str_resource_value_t value = str_resource_value_t();
+    value.rid = rid;
+    value.type = RES_TYPE_INTEGER;
+    value.integer_value = static_cast<int64_t>(m_random());
+
+    if (pick < m_profile.readWeight)
+    {
+        std::vector<str_resource_value_t> values;
+        return m_server.serverRead(oiid, std::vector<lwm2m_appfwk_itf_rid_t>(1, rid), values) == OK;
+    }
+    if (pick < (m_profile.readWeight + m_profile.writeWeight))
+    {
+        return m_server.serverWrite(oiid, std::vector<str_resource_value_t>(1, value)) == OK;
+    }
+    if (pick < (m_profile.readWeight + m_profile.writeWeight + m_profile.executeWeight))
+    {
+        uint32_t operationId = 0;
+        return m_server.serverExecute(oiid, executeRid(), std::vector<std::string>(), operationId) == OK;
+    }
+    const ILwM2MInstanceHandler::Ptr handler = m_objects->getLwM2MAppFwkObjectInstance(oiid);
+    const str_integer_resource_t resource = { rid, value.integer_value };
+    return !handler.isNull() && (handler->setIntegerResourceValue(resource) == OK);
+}
+
+void LwM2MLoadDriver::onNotifyReceived(const void * pSender, const str_server_notification_t & notification)
+{
+    (void) pSender;
+    (void) notification;
+    ++m_notifications;
+}
+
+} /* namespace Connectivity */
+} /* namespace Stla */
@@ -0,0 +1,167 @@
+/**
+ * \file
+ *         LwM2MLoadDriver.hpp
+ * \brief
+ *         Scripted load of LwM2M server operations against LwM2MServerStandIn, for load runs on a X86 PC target
+ *
+ * \par Copyright Notice:
+ * \verbatim
+ * Copyright (c) 2021 Stellantis N.V.
+ * All Rights Reserved.
+ * The reproduction, transmission or use of this document or its contents is
+ * not permitted without express written authority.
+ * Offenders will be liable for damages. All rights, including rights created
+ * by patent grant or registration of a utility model or design, are reserved.
+ * \endverbatim
+ */
+
+#ifndef LWM2MLOADDRIVER_H_
+#define LWM2MLOADDRIVER_H_
+
+#include <deque>
+#include <istream>
+#include <list>
+#include <random>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "LwM2MServerStandIn.hpp"
+
+namespace Stla
+{
+namespace Connectivity
+{
+/**
+ * @brief Load profile, read from a script of "<key> <value>" lines ('#' starts a comment):
+ *        instances - object instances created through createNewInstance
+ *        resources - read-write integer resources per instance, rids 1 to resources
+ *        observed - resources observed by the server per instance, rids 1 to observed
+ *        read / write / execute / appwrite - relative weights of server Read, server Write, server Execute and
+ *        application write (setIntegerResourceValue) in the operation mix
+ *        executeDelayMs - delay of the application before answering an Execute operation, 0 to answer at once
+ *        executeConcurrency - max_concurrent of the executable resource
+ *        durationMs - duration of the run
+ *        seed - seed of the operation mix, runs with the same seed issue the same operations
+ */
+typedef struct str_load_profile
+{
+    uint32_t instances;
+    uint32_t resources;
+    uint32_t observed;
+    uint32_t readWeight;
+    uint32_t writeWeight;
+    uint32_t executeWeight;
+    uint32_t appWriteWeight;
+    uint32_t executeDelayMs;
+    uint32_t executeConcurrency;
+    uint32_t durationMs;
+    uint32_t seed;
+} str_load_profile_t;
+
+/**
+ * @brief Result of a load run.
+ *        operations / failed - operations issued by the driver, and those which failed
+ *        notifications - Notify received by the server
+ *        statistics - getOperationStatistics() of the stand-in at the end of the run
+ */
+typedef struct str_load_report
+{
+    uint64_t operations;
+    uint64_t failed;
+    uint64_t notifications;
+    uint64_t elapsedMs;
+    double operationsPerSec;
+    std::vector<str_operation_statistics_t> statistics;
+} str_load_report_t;
+
+/**
+ * LwM2MLoadDriver plays both the applications and the LwM2M server against a LwM2MServerStandIn: it creates the
+ * instances of the profile through the object handler, registers their executable resource and answers its
+ * ExecuteOperation events with setExecuteOperationResult(), and has the server observe, read, write and execute them
+ * in a pseudo-random mix.
+ *
+ * Operations are issued back to back from the calling thread, the stand-in being polled between them, so the run
+ * measures the throughput of the service code paths; getOperationStatistics() gives the end-to-end latencies.
+ */
+class LwM2MLoadDriver
+{
+public:
+    static const lwm2m_appfwk_itf_rid_t SYMBOLIC_NAME_RID = 0;
+
+    /**
+     * @brief Default profile: 10 instances of 20 resources, 5 observed, a read heavy mix, for 10 seconds.
+     */
+    static str_load_profile_t defaultProfile();
+
+    /**
+     * @brief Read a profile script over profile. Unknown keys and invalid values are errors.
+     *
+     * @param error on failure, the line in error.
+     */
+    static bool parseProfile(std::istream & script, str_load_profile_t & profile, std::string & error);
+
+    explicit LwM2MLoadDriver(LwM2MServerStandIn & server);
+    ~LwM2MLoadDriver();
+
+    /**
+     * @brief Create the instances of the profile and subscribe to their events. The instances of a previous setup
+     * are deleted first.
+     *
+     * @return
+     * OK (0) - success <br>
+     * other - the error of the first operation which failed <br>
+     */
+    e_lwm2m_appfwk_itf_err_code_t setup(const str_load_profile_t & profile);
+
+    /**
+     * @brief Reset the statistics of the stand-in, then issue the operation mix for durationMs.
+     */
+    void run(str_load_report_t & report);
+
+private:
+    /**
+     * Application side of an instance: answers its Execute operations.
+     */
+    class Application
+    {
+    public:
+        Application(LwM2MLoadDriver & driver, const ILwM2MInstanceHandler::Ptr & handler);
+
+        void onExecuteOperation(const void * pSender, const str_executable_parameters_t & operation);
+
+        LwM2MLoadDriver & m_driver;
+        ILwM2MInstanceHandler::Ptr m_handler;
+    };
+
+    struct PendingResult
+    {
+        uint64_t dueMs;
+        ILwM2MInstanceHandler::Ptr handler;
+        lwm2m_appfwk_itf_rid_t rid;
+        uint32_t operationId;
+    };
+
+    LwM2MLoadDriver(const LwM2MLoadDriver &);
+    LwM2MLoadDriver & operator=(const LwM2MLoadDriver &);
+
+    void teardown();
+    lwm2m_appfwk_itf_rid_t executeRid() const;
+    void answer(const ILwM2MInstanceHandler::Ptr & handler, const str_executable_parameters_t & operation);
+    void answerDue(const uint64_t nowMs);
+    bool issue(const uint32_t pick);
+    void onNotifyReceived(const void * pSender, const str_server_notification_t & notification);
+
+    LwM2MServerStandIn & m_server;
+    ILwM2MObjectHandler::Ptr m_objects;
+    str_load_profile_t m_profile;
+    std::list<Application> m_applications;
+    std::deque<PendingResult> m_pending;
+    std::minstd_rand m_random;
+    uint64_t m_notifications;
+};
+
+} /* namespace Connectivity */
+} /* namespace Stla */
+
+#endif /* LWM2MLOADDRIVER_H_ */
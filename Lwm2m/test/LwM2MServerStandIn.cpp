@@ -0,0 +1,1018 @@
+/**
+ * \file
+ *         LwM2MServerStandIn.cpp
+ * \brief
+ *         LwM2M AppFwk service driven by a local stand-in of the LwM2M server, for load runs on a X86 PC target
+ *
+ * \par Copyright Notice:
+ * \verbatim
+ * Copyright (c) 2021 Stellantis N.V.
+ * All Rights Reserved.
+ * The reproduction, transmission or use of this document or its contents is
+ * not permitted without express written authority.
+ * Offenders will be liable for damages. All rights, including rights created
+ * by patent grant or registration of a utility model or design, are reserved.
+ * \endverbatim
+ */
+
+#include "LwM2MServerStandIn.hpp"
+
+#include <chrono>
+
+namespace Stla
+{
+namespace Connectivity
+{
+
+namespace
+{
+str_resource_value_t makeValue(const lwm2m_appfwk_itf_rid_t rid, const e_lwm2m_appfwk_itf_res_type_t type)
+{
+    str_resource_value_t value = str_resource_value_t();
+    value.rid = rid;
+    value.type = type;
+    return value;
+}
+} // namespace
+
+/**
+ * Object handler given to the applications. It forwards to the stand-in until the stand-in is destroyed.
+ */
+class LwM2MServerStandIn::Objects: public ILwM2MObjectHandler
+{
+public:
+    explicit Objects(LwM2MServerStandIn * service) :
+            m_service(service)
+    {
+    }
+
+    void detach()
+    {
+        m_service = nullptr;
+    }
+
+    virtual e_lwm2m_appfwk_itf_err_code_t getLwM2MAppFwkObjectInstanceList(
+            std::vector<lwm2m_appfwk_itf_oiid_t> & instance_list)
+    {
+        return (m_service != nullptr) ? m_service->getInstanceList(instance_list) : BROKEN_LINK;
+    }
+
+    virtual ILwM2MInstanceHandler::Ptr getLwM2MAppFwkObjectInstance(const lwm2m_appfwk_itf_oiid_t oiid)
+    {
+        return (m_service != nullptr) ? m_service->getInstance(oiid) : ILwM2MInstanceHandler::Ptr();
+    }
+
+    virtual e_lwm2m_appfwk_itf_err_code_t createNewInstance(const lwm2m_appfwk_itf_oiid_t oiid,
+            const str_instance_t instance)
+    {
+        return (m_service != nullptr) ? m_service->createInstance(oiid, instance) : BROKEN_LINK;
+    }
+
+    virtual e_lwm2m_appfwk_itf_err_code_t deleteInstance(const lwm2m_appfwk_itf_oiid_t oiid)
+    {
+        return (m_service != nullptr) ? m_service->deleteInstance(oiid) : BROKEN_LINK;
+    }
+
+private:
+    LwM2MServerStandIn * m_service;
+};
+
+/**
+ * Instance handler given to the applications, one per instance. It forwards to the stand-in until the instance is
+ * deleted or the stand-in is destroyed.
+ */
+class LwM2MServerStandIn::Instance: public ILwM2MInstanceHandler
+{
+public:
+    Instance(LwM2MServerStandIn * service, const lwm2m_appfwk_itf_oiid_t oiid) :
+            m_service(service),
+            m_oiid(oiid)
+    {
+    }
+
+    void detach()
+    {
+        m_service = nullptr;
+    }
+
+    virtual lwm2m_appfwk_itf_oiid_t getInstanceId()
+    {
+        return m_oiid;
+    }
+
+    virtual e_lwm2m_appfwk_itf_err_code_t getInstance(str_instance_t & instance)
+    {
+        return (m_service != nullptr) ? m_service->exportInstance(m_oiid, instance) : BROKEN_LINK;
+    }
+
+    virtual e_lwm2m_appfwk_itf_err_code_t getInstanceResourceIds(str_instance_resources_t & instance_rids)
+    {
+        return (m_service != nullptr) ? m_service->getResourceIds(m_oiid, instance_rids) : BROKEN_LINK;
+    }
+
+    virtual e_lwm2m_appfwk_itf_err_code_t getSymbolicNameResourceValue(str_string_resource_t & resource)
+    {
+        return (m_service != nullptr) ? m_service->getSymbolicName(m_oiid, resource) : BROKEN_LINK;
+    }
+
+    virtual e_lwm2m_appfwk_itf_err_code_t getStringResourceValue(str_string_resource_t & resource)
+    {
+        str_resource_value_t value = makeValue(resource.rid, RES_TYPE_STRING);
+        const e_lwm2m_appfwk_itf_err_code_t result = get(value);
+        resource.value = value.string_value;
+        return result;
+    }
+
+    virtual e_lwm2m_appfwk_itf_err_code_t getIntegerResourceValue(str_integer_resource_t & resource)
+    {
+        str_resource_value_t value = makeValue(resource.rid, RES_TYPE_INTEGER);
+        const e_lwm2m_appfwk_itf_err_code_t result = get(value);
+        resource.value = value.integer_value;
+        return result;
+    }
+
+    virtual e_lwm2m_appfwk_itf_err_code_t getFloatResourceValue(str_float_resource_t & resource)
+    {
+        str_resource_value_t value = makeValue(resource.rid, RES_TYPE_FLOAT);
+        const e_lwm2m_appfwk_itf_err_code_t result = get(value);
+        resource.value = value.float_value;
+        return result;
+    }
+
+    virtual e_lwm2m_appfwk_itf_err_code_t getBooleanResourceValue(str_boolean_resource_t & resource)
+    {
+        str_resource_value_t value = makeValue(resource.rid, RES_TYPE_BOOLEAN);
+        const e_lwm2m_appfwk_itf_err_code_t result = get(value);
+        resource.value = value.boolean_value;
+        return result;
+    }
+
+    virtual e_lwm2m_appfwk_itf_err_code_t getOpaqueResourceValue(str_opaque_resource_t & resource)
+    {
+        str_resource_value_t value = makeValue(resource.rid, RES_TYPE_OPAQUE);
+        const e_lwm2m_appfwk_itf_err_code_t result = get(value);
+        resource.value.swap(value.opaque_value);
+        return result;
+    }
+
+    virtual e_lwm2m_appfwk_itf_err_code_t getTimeResourceValue(str_integer_resource_t & resource)
+    {
+        str_resource_value_t value = makeValue(resource.rid, RES_TYPE_TIME);
+        const e_lwm2m_appfwk_itf_err_code_t result = get(value);
+        resource.value = value.integer_value;
+        return result;
+    }
+
+    virtual e_lwm2m_appfwk_itf_err_code_t getObjlnkResourceValue(str_objlnk_resource_t & resource)
+    {
+        str_resource_value_t value = makeValue(resource.rid, RES_TYPE_OBJLNK);
+        const e_lwm2m_appfwk_itf_err_code_t result = get(value);
+        resource.lnk_oid = value.lnk_oid;
+        resource.lnk_oiid = value.lnk_oiid;
+        return result;
+    }
+
+    virtual e_lwm2m_appfwk_itf_err_code_t setStringResourceValue(const str_string_resource_t resource)
+    {
+        str_resource_value_t value = makeValue(resource.rid, RES_TYPE_STRING);
+        value.string_value = resource.value;
+        return set(value);
+    }
+
+    virtual e_lwm2m_appfwk_itf_err_code_t setIntegerResourceValue(const str_integer_resource_t resource)
+    {
+        str_resource_value_t value = makeValue(resource.rid, RES_TYPE_INTEGER);
+        value.integer_value = resource.value;
+        return set(value);
+    }
+
+    virtual e_lwm2m_appfwk_itf_err_code_t setFloatResourceValue(const str_float_resource_t resource)
+    {
+        str_resource_value_t value = makeValue(resource.rid, RES_TYPE_FLOAT);
+        value.float_value = resource.value;
+        return set(value);
+    }
+
+    virtual e_lwm2m_appfwk_itf_err_code_t setBooleanResourceValue(const str_boolean_resource_t resource)
+    {
+        str_resource_value_t value = makeValue(resource.rid, RES_TYPE_BOOLEAN);
+        value.boolean_value = resource.value;
+        return set(value);
+    }
+
+    virtual e_lwm2m_appfwk_itf_err_code_t setOpaqueResourceValue(const str_opaque_resource_t resource)
+    {
+        str_resource_value_t value = makeValue(resource.rid, RES_TYPE_OPAQUE);
+        value.opaque_value = resource.value;
+        return set(value);
+    }
+
+    virtual e_lwm2m_appfwk_itf_err_code_t setTimeResourceValue(const str_integer_resource_t resource)
+    {
+        str_resource_value_t value = makeValue(resource.rid, RES_TYPE_TIME);
+        value.integer_value = resource.value;
+        return set(value);
+    }
+
+    virtual e_lwm2m_appfwk_itf_err_code_t setObjlnkResourceValue(const str_objlnk_resource_t resource)
+    {
+        str_resource_value_t value = makeValue(resource.rid, RES_TYPE_OBJLNK);
+        value.lnk_oid = resource.lnk_oid;
+        value.lnk_oiid = resource.lnk_oiid;
+        return set(value);
+    }
+
+    virtual e_lwm2m_appfwk_itf_err_code_t readResources(const str_instance_resources_t & rids,
+            std::vector<str_resource_value_t> & values)
+    {
+        return (m_service != nullptr) ? m_service->readValues(m_oiid, rids, values) : BROKEN_LINK;
+    }
+
+    virtual e_lwm2m_appfwk_itf_err_code_t writeResources(const std::vector<str_resource_value_t> & values)
+    {
+        return (m_service != nullptr) ? m_service->writeValues(m_oiid, values) : BROKEN_LINK;
+    }
+
+    virtual e_lwm2m_appfwk_itf_err_code_t setNotificationAttributes(const str_notification_attributes_t attributes)
+    {
+        return (m_service != nullptr) ? m_service->setAttributes(m_oiid, attributes) : BROKEN_LINK;
+    }
+
+    virtual e_lwm2m_appfwk_itf_err_code_t getNotificationAttributes(str_notification_attributes_t & attributes)
+    {
+        return (m_service != nullptr) ? m_service->getAttributes(m_oiid, attributes) : BROKEN_LINK;
+    }
+
+    virtual e_lwm2m_appfwk_itf_err_code_t deleteResource(const lwm2m_appfwk_itf_rid_t rid)
+    {
+        return (m_service != nullptr) ? m_service->deleteResource(m_oiid, rid) : BROKEN_LINK;
+    }
+
+    virtual e_lwm2m_appfwk_itf_err_code_t registerExecuteOpHandler(const lwm2m_appfwk_itf_rid_t rid)
+    {
+        return (m_service != nullptr) ? m_service->registerExecute(m_oiid, rid) : BROKEN_LINK;
+    }
+
+    virtual e_lwm2m_appfwk_itf_err_code_t setExecuteConfig(const str_execute_config_t config)
+    {
+        return (m_service != nullptr) ? m_service->configureExecute(m_oiid, config) : BROKEN_LINK;
+    }
+
+    virtual e_lwm2m_appfwk_itf_err_code_t getExecuteStatistics(str_execute_statistics_t & statistics)
+    {
+        return (m_service != nullptr) ? m_service->getExecuteStatistics(m_oiid, statistics) : BROKEN_LINK;
+    }
+
+    virtual e_lwm2m_appfwk_itf_err_code_t setExecuteResult(const lwm2m_appfwk_itf_rid_t rid, const bool success)
+    {
+        return (m_service != nullptr) ? m_service->completeExecute(m_oiid, rid, 0, success) : BROKEN_LINK;
+    }
+
+    virtual e_lwm2m_appfwk_itf_err_code_t setExecuteOperationResult(const lwm2m_appfwk_itf_rid_t rid,
+            const uint32_t operation_id, const bool success)
+    {
+        if (operation_id == 0)
+        {
+            return NOT_FOUND;   // 0 is never given to an operation
+        }
+        return (m_service != nullptr) ? m_service->completeExecute(m_oiid, rid, operation_id, success) : BROKEN_LINK;
+    }
+
+private:
+    e_lwm2m_appfwk_itf_err_code_t get(str_resource_value_t & value)
+    {
+        return (m_service != nullptr) ? m_service->getValue(m_oiid, value.type, value) : BROKEN_LINK;
+    }
+
+    e_lwm2m_appfwk_itf_err_code_t set(const str_resource_value_t & value)
+    {
+        return (m_service != nullptr) ? m_service->setValue(m_oiid, value) : BROKEN_LINK;
+    }
+
+    LwM2MServerStandIn * m_service;
+    const lwm2m_appfwk_itf_oiid_t m_oiid;
+};
+
+const uint64_t LwM2MServerStandIn::NO_DEADLINE;
+
+LwM2MServerStandIn::Counter::Counter() :
+        count(0),
+        failed(0),
+        minUs(0),
+        sumUs(0),
+        maxUs(0)
+{
+}
+
+LwM2MServerStandIn::LwM2MServerStandIn(const std::string & symbolicName, const size_t maxInstances) :
+        m_symbolicName(symbolicName),
+        m_maxInstances(maxInstances),
+        m_objects(new Objects(this))
+{
+}
+
+LwM2MServerStandIn::~LwM2MServerStandIn()
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    m_objects->detach();
+    for (std::map<lwm2m_appfwk_itf_oiid_t, InstanceState>::iterator it = m_instances.begin();
+            it != m_instances.end(); ++it)
+    {
+        it->second.handler->detach();
+    }
+}
+
+e_lwm2m_appfwk_itf_err_code_t LwM2MServerStandIn::serverRead(const lwm2m_appfwk_itf_oiid_t oiid,
+        const std::vector<lwm2m_appfwk_itf_rid_t> & rids, std::vector<str_resource_value_t> & values)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    const uint64_t start = nowUs();
+    values.clear();
+    InstanceState * state = find(oiid);
+    e_lwm2m_appfwk_itf_err_code_t result = (state != nullptr) ? OK : NOT_FOUND;
+    if (state != nullptr)
+    {
+        str_instance_resources_t all;
+        if (rids.empty())
+        {
+            state->store.getResourceIds(all);
+        }
+        const std::vector<lwm2m_appfwk_itf_rid_t> & read = rids.empty() ? all.rids : rids;
+        for (size_t i = 0; (i < read.size()) && (result == OK); ++i)
+        {
+            values.push_back(makeValue(read[i], RES_TYPE_STRING));
+            result = state->store.get(values.back());
+        }
+        if (result != OK)
+        {
+            values.clear();
+        }
+    }
+    record(OPERATION_READ, result == OK, nowUs() - start);
+    return result;
+}
+
+e_lwm2m_appfwk_itf_err_code_t LwM2MServerStandIn::serverWrite(const lwm2m_appfwk_itf_oiid_t oiid,
+        const std::vector<str_resource_value_t> & values)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    const uint64_t start = nowUs();
+    InstanceState * state = find(oiid);
+    e_lwm2m_appfwk_itf_err_code_t result = (state != nullptr) ? OK : NOT_FOUND;
+    for (size_t i = 0; (result == OK) && (i < values.size()); ++i)
+    {
+        const LwM2MInstanceStore::Slot * slot = state->store.find(values[i].rid);
+        result = ((slot != nullptr) && slot->readOnly) ? METHOD_NOT_ALLOWED : state->store.check(values[i]);
+    }
+    if (result != OK)
+    {
+        record(OPERATION_WRITE, false, nowUs() - start);
+        return result;
+    }
+
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        state->store.set(values[i], false);
+        changed(*state, values[i], true);
+    }
+    record(OPERATION_WRITE, true, nowUs() - start);
+
+    // The application is told after the reply to the server, as the LwM2M client does.
+    const Poco::AutoPtr<Instance> handler = state->handler;
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        const str_resource_value_t & value = values[i];
+        switch (value.type)
+        {
+        case RES_TYPE_STRING:
+        {
+            const str_string_resource_t resource = { value.rid, value.string_value };
+            handler->StringResourceChanged.notify(this, resource);
+            break;
+        }
+        case RES_TYPE_INTEGER:
+        {
+            const str_integer_resource_t resource = { value.rid, value.integer_value };
+            handler->IntegerResourceChanged.notify(this, resource);
+            break;
+        }
+        case RES_TYPE_FLOAT:
+        {
+            const str_float_resource_t resource = { value.rid, value.float_value };
+            handler->FloatResourceChanged.notify(this, resource);
+            break;
+        }
+        case RES_TYPE_BOOLEAN:
+        {
+            const str_boolean_resource_t resource = { value.rid, value.boolean_value };
+            handler->BooleanResourceChanged.notify(this, resource);
+            break;
+        }
+        case RES_TYPE_OPAQUE:
+        {
+            const str_opaque_resource_t resource = { value.rid, value.opaque_value };
+            handler->OpaqueResourceChanged.notify(this, resource);
+            break;
+        }
+        case RES_TYPE_TIME:
+        {
+            const str_integer_resource_t resource = { value.rid, value.integer_value };
+            handler->TimeResourceChanged.notify(this, resource);
+            break;
+        }
+        default:
+        {
+            const str_objlnk_resource_t resource = { value.rid, value.lnk_oid, value.lnk_oiid };
+            handler->ObjlnkResourceChanged.notify(this, resource);
+            break;
+        }
+        }
+    }
+    m_objects->InstanceChanged.notify(this, oiid);
+    return OK;
+}
+
+e_lwm2m_appfwk_itf_err_code_t LwM2MServerStandIn::serverExecute(const lwm2m_appfwk_itf_oiid_t oiid,
+        const lwm2m_appfwk_itf_rid_t rid, const std::vector<std::string> & parameters, uint32_t & operation_id)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    const uint64_t start = nowUs();
+    InstanceState * state = find(oiid);
+    if (state == nullptr)
+    {
+        record(OPERATION_EXECUTE, false, nowUs() - start);
+        return NOT_FOUND;
+    }
+
+    str_executable_parameters_t operation;
+    operation.rid = rid;
+    operation.parameters = parameters;
+    operation.operation_id = 0;
+    std::vector<str_executable_parameters_t> dispatch;
+    const e_lwm2m_appfwk_itf_err_code_t result = state->execute.submit(operation, start / 1000, operation_id, dispatch);
+    if (result != OK)
+    {
+        record(OPERATION_EXECUTE, false, nowUs() - start);
+        return result;
+    }
+    Execution & execution = m_executions[ExecutionKey(oiid, operation_id)];
+    execution.rid = rid;
+    execution.startUs = start;
+    execution.delivered = false;
+
+    // The timeout of the new operation may come before the deadline of the instance.
+    state->executeDeadline = 0;
+    deliver(oiid, dispatch);
+    return OK;
+}
+
+e_lwm2m_appfwk_itf_err_code_t LwM2MServerStandIn::serverObserve(const lwm2m_appfwk_itf_oiid_t oiid,
+        const lwm2m_appfwk_itf_rid_t rid, const bool observe)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    InstanceState * state = find(oiid);
+    if ((state == nullptr) || (state->store.find(rid) == nullptr))
+    {
+        return NOT_FOUND;
+    }
+    if (observe)
+    {
+        state->observed.insert(rid);
+    }
+    else
+    {
+        state->observed.erase(rid);
+    }
+    return OK;
+}
+
+uint64_t LwM2MServerStandIn::poll()
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    const uint64_t now = nowMs();
+    std::vector<lwm2m_appfwk_itf_oiid_t> due;
+    for (std::map<lwm2m_appfwk_itf_oiid_t, InstanceState>::const_iterator it = m_instances.begin();
+            it != m_instances.end(); ++it)
+    {
+        if ((it->second.executeDeadline <= now) || (it->second.notifyDeadline <= now))
+        {
+            due.push_back(it->first);
+        }
+    }
+    // A delegate may create or delete instances: each instance is looked up again before running it.
+    for (size_t i = 0; i < due.size(); ++i)
+    {
+        runInstance(due[i], now);
+    }
+
+    uint64_t next = NO_DEADLINE;
+    for (std::map<lwm2m_appfwk_itf_oiid_t, InstanceState>::const_iterator it = m_instances.begin();
+            it != m_instances.end(); ++it)
+    {
+        next = std::min(next, std::min(it->second.executeDeadline, it->second.notifyDeadline));
+    }
+    return next;
+}
+
+uint64_t LwM2MServerStandIn::nowMs()
+{
+    return nowUs() / 1000;
+}
+
+e_lwm2m_appfwk_itf_err_code_t LwM2MServerStandIn::isServiceReady() const
+{
+    return OK;
+}
+
+ILwM2MObjectHandler::Ptr LwM2MServerStandIn::getObjectHandler(Poco::OSP::BundleContext::Ptr pAppBndlContext)
+{
+    (void) pAppBndlContext;
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    return ILwM2MObjectHandler::Ptr(m_objects.get(), true);
+}
+
+e_lwm2m_appfwk_itf_err_code_t LwM2MServerStandIn::getOperationStatistics(
+        std::vector<str_operation_statistics_t> & statistics)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    statistics.clear();
+    for (int operation = OPERATION_READ; operation <= OPERATION_NOTIFY; ++operation)
+    {
+        const Counter & counter = m_counters[operation];
+        str_operation_statistics_t entry;
+        entry.operation = static_cast<e_lwm2m_appfwk_itf_operation_t>(operation);
+        entry.count = counter.count;
+        entry.failed = counter.failed;
+        entry.latency_min_us = counter.minUs;
+        entry.latency_avg_us = (counter.count != 0) ? counter.sumUs / counter.count : 0;
+        entry.latency_max_us = counter.maxUs;
+        statistics.push_back(entry);
+    }
+    return OK;
+}
+
+e_lwm2m_appfwk_itf_err_code_t LwM2MServerStandIn::resetOperationStatistics()
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    for (int operation = OPERATION_READ; operation <= OPERATION_NOTIFY; ++operation)
+    {
+        m_counters[operation] = Counter();
+    }
+    return OK;
+}
+
+uint64_t LwM2MServerStandIn::nowUs()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+LwM2MServerStandIn::InstanceState * LwM2MServerStandIn::find(const lwm2m_appfwk_itf_oiid_t oiid)
+{
+    std::map<lwm2m_appfwk_itf_oiid_t, InstanceState>::iterator it = m_instances.find(oiid);
+    return (it != m_instances.end()) ? &it->second : nullptr;
+}
+
+void LwM2MServerStandIn::record(const e_lwm2m_appfwk_itf_operation_t operation, const bool success,
+        const uint64_t latencyUs)
+{
+    Counter & counter = m_counters[operation];
+    if ((counter.count == 0) || (latencyUs < counter.minUs))
+    {
+        counter.minUs = latencyUs;
+    }
+    counter.maxUs = std::max(counter.maxUs, latencyUs);
+    counter.sumUs += latencyUs;
+    ++counter.count;
+    if (!success)
+    {
+        ++counter.failed;
+    }
+}
+
+void LwM2MServerStandIn::changed(InstanceState & state, const str_resource_value_t & value, const bool byServer)
+{
+    if (!state.notifications.resourceChanged(value))
+    {
+        return;
+    }
+    state.changedUs.insert(std::make_pair(value.rid, nowUs()));     // keeps the first change not notified
+    if (byServer)
+    {
+        state.serverWritten.insert(value.rid);
+    }
+    state.notifyDeadline = 0;
+}
+
+void LwM2MServerStandIn::deliver(const lwm2m_appfwk_itf_oiid_t oiid,
+        const std::vector<str_executable_parameters_t> & dispatch)
+{
+    InstanceState * state = find(oiid);
+    if (state == nullptr)
+    {
+        return;
+    }
+    const Poco::AutoPtr<Instance> handler = state->handler;
+    for (size_t i = 0; i < dispatch.size(); ++i)
+    {
+        std::map<ExecutionKey, Execution>::iterator execution =
+                m_executions.find(ExecutionKey(oiid, dispatch[i].operation_id));
+        if (execution != m_executions.end())
+        {
+            execution->second.delivered = true;
+        }
+    }
+    for (size_t i = 0; i < dispatch.size(); ++i)
+    {
+        handler->ExecuteOperation.notify(this, dispatch[i]);
+    }
+}
+
+void LwM2MServerStandIn::finish(const lwm2m_appfwk_itf_oiid_t oiid, const uint32_t operationId, const bool success)
+{
+    std::map<ExecutionKey, Execution>::iterator execution = m_executions.find(ExecutionKey(oiid, operationId));
+    if (execution == m_executions.end())
+    {
+        return;
+    }
+    str_server_execute_result_t result;
+    result.oiid = oiid;
+    result.rid = execution->second.rid;
+    result.operation_id = operationId;
+    result.success = success;
+    result.latency_us = nowUs() - execution->second.startUs;
+    m_executions.erase(execution);
+    record(OPERATION_EXECUTE, success, result.latency_us);
+    ExecuteCompleted.notify(this, result);
+}
+
+void LwM2MServerStandIn::runInstance(const lwm2m_appfwk_itf_oiid_t oiid, const uint64_t now)
+{
+    InstanceState * state = find(oiid);
+    if ((state != nullptr) && (state->executeDeadline <= now))
+    {
+        std::vector<str_executable_parameters_t> timedOut;
+        std::vector<str_executable_parameters_t> dispatch;
+        state->executeDeadline = state->execute.expire(now, timedOut, dispatch);
+        for (size_t i = 0; i < timedOut.size(); ++i)
+        {
+            finish(oiid, timedOut[i].operation_id, false);
+        }
+        deliver(oiid, dispatch);
+        state = find(oiid);
+    }
+    if ((state == nullptr) || (state->notifyDeadline > now))
+    {
+        return;
+    }
+
+    std::vector<str_resource_value_t> batch;
+    state->notifyDeadline = state->notifications.collect(now, batch);
+    str_server_notification_t notification;
+    notification.oiid = oiid;
+    std::vector<str_resource_value_t> application;
+    const uint64_t sent = nowUs();
+    for (size_t i = 0; i < batch.size(); ++i)
+    {
+        const lwm2m_appfwk_itf_rid_t rid = batch[i].rid;
+        std::map<lwm2m_appfwk_itf_rid_t, uint64_t>::iterator changedAt = state->changedUs.find(rid);
+        if (state->observed.count(rid) != 0)
+        {
+            notification.values.push_back(batch[i]);
+            record(OPERATION_NOTIFY, true, (changedAt != state->changedUs.end()) ? sent - changedAt->second : 0);
+        }
+        if (changedAt != state->changedUs.end())
+        {
+            state->changedUs.erase(changedAt);
+        }
+        if (state->serverWritten.erase(rid) != 0)
+        {
+            application.push_back(batch[i]);
+        }
+    }
+
+    const Poco::AutoPtr<Instance> handler = state->handler;
+    if (!application.empty())
+    {
+        handler->ResourcesChanged.notify(this, application);
+    }
+    if (!notification.values.empty())
+    {
+        NotifyReceived.notify(this, notification);
+    }
+}
+
+e_lwm2m_appfwk_itf_err_code_t LwM2MServerStandIn::getInstanceList(std::vector<lwm2m_appfwk_itf_oiid_t> & instance_list)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    instance_list.clear();
+    for (std::map<lwm2m_appfwk_itf_oiid_t, InstanceState>::const_iterator it = m_instances.begin();
+            it != m_instances.end(); ++it)
+    {
+        instance_list.push_back(it->first);
+    }
+    return OK;
+}
+
+ILwM2MInstanceHandler::Ptr LwM2MServerStandIn::getInstance(const lwm2m_appfwk_itf_oiid_t oiid)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    InstanceState * state = find(oiid);
+    return (state != nullptr) ? ILwM2MInstanceHandler::Ptr(state->handler.get(), true) : ILwM2MInstanceHandler::Ptr();
+}
+
+e_lwm2m_appfwk_itf_err_code_t LwM2MServerStandIn::createInstance(const lwm2m_appfwk_itf_oiid_t oiid,
+        const str_instance_t & instance)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    if (m_instances.count(oiid) != 0)
+    {
+        return ALREADY_CREATED;
+    }
+    if (m_instances.size() >= m_maxInstances)
+    {
+        return OUT_OF_INSTANCE;
+    }
+    LwM2MInstanceStore store;
+    if (store.importInstance(instance) != OK)
+    {
+        return INVALID_RID;
+    }
+    str_string_resource_t symbolicName = instance.symbolic_name;
+    symbolicName.value = m_symbolicName;
+    store.setSymbolicName(symbolicName);
+
+    InstanceState & state = m_instances[oiid];
+    state.store = store;
+    state.handler = new Instance(this, oiid);
+    state.executeDeadline = NO_DEADLINE;
+    state.notifyDeadline = NO_DEADLINE;
+    return OK;
+}
+
+e_lwm2m_appfwk_itf_err_code_t LwM2MServerStandIn::deleteInstance(const lwm2m_appfwk_itf_oiid_t oiid)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    std::map<lwm2m_appfwk_itf_oiid_t, InstanceState>::iterator it = m_instances.find(oiid);
+    if (it == m_instances.end())
+    {
+        return ID_INVALID;
+    }
+    // The running and queued Execute operations of the instance fail towards the server.
+    std::vector<uint32_t> operations;
+    for (std::map<ExecutionKey, Execution>::const_iterator execution = m_executions.lower_bound(ExecutionKey(oiid, 0));
+            (execution != m_executions.end()) && (execution->first.first == oiid); ++execution)
+    {
+        operations.push_back(execution->first.second);
+    }
+    it->second.handler->detach();
+    m_instances.erase(it);
+    for (size_t i = 0; i < operations.size(); ++i)
+    {
+        finish(oiid, operations[i], false);
+    }
+    return OK;
+}
+
+e_lwm2m_appfwk_itf_err_code_t LwM2MServerStandIn::exportInstance(const lwm2m_appfwk_itf_oiid_t oiid,
+        str_instance_t & instance)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    InstanceState * state = find(oiid);
+    if (state == nullptr)
+    {
+        return NOT_FOUND;
+    }
+    state->store.exportInstance(instance);
+    return OK;
+}
+
+e_lwm2m_appfwk_itf_err_code_t LwM2MServerStandIn::getResourceIds(const lwm2m_appfwk_itf_oiid_t oiid,
+        str_instance_resources_t & instance_rids)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    InstanceState * state = find(oiid);
+    if (state == nullptr)
+    {
+        return NOT_FOUND;
+    }
+    state->store.getResourceIds(instance_rids);
+    return OK;
+}
+
+e_lwm2m_appfwk_itf_err_code_t LwM2MServerStandIn::getSymbolicName(const lwm2m_appfwk_itf_oiid_t oiid,
+        str_string_resource_t & resource)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    InstanceState * state = find(oiid);
+    if (state == nullptr)
+    {
+        return NOT_FOUND;
+    }
+    if (resource.rid != state->store.symbolicName().rid)
+    {
+        return INVALID_RID;
+    }
+    resource = state->store.symbolicName();
+    return OK;
+}
+
+e_lwm2m_appfwk_itf_err_code_t LwM2MServerStandIn::getValue(const lwm2m_appfwk_itf_oiid_t oiid,
+        const e_lwm2m_appfwk_itf_res_type_t type, str_resource_value_t & value)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    InstanceState * state = find(oiid);
+    if (state == nullptr)
+    {
+        return NOT_FOUND;
+    }
+    const e_lwm2m_appfwk_itf_err_code_t result = state->store.get(value);
+    return ((result == OK) && (value.type != type)) ? INVALID_RID : result;
+}
+
+e_lwm2m_appfwk_itf_err_code_t LwM2MServerStandIn::setValue(const lwm2m_appfwk_itf_oiid_t oiid,
+        const str_resource_value_t & value)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    InstanceState * state = find(oiid);
+    if (state == nullptr)
+    {
+        return NOT_FOUND;
+    }
+    const e_lwm2m_appfwk_itf_err_code_t result = state->store.set(value, false);
+    if (result == OK)
+    {
+        changed(*state, value, false);
+    }
+    return result;
+}
+
+e_lwm2m_appfwk_itf_err_code_t LwM2MServerStandIn::readValues(const lwm2m_appfwk_itf_oiid_t oiid,
+        const str_instance_resources_t & rids, std::vector<str_resource_value_t> & values)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    values.clear();
+    InstanceState * state = find(oiid);
+    if (state == nullptr)
+    {
+        return NOT_FOUND;
+    }
+    for (size_t i = 0; i < rids.rids.size(); ++i)
+    {
+        values.push_back(makeValue(rids.rids[i], RES_TYPE_STRING));
+        if (state->store.get(values.back()) != OK)
+        {
+            values.clear();
+            return NOT_FOUND;
+        }
+    }
+    return OK;
+}
+
+e_lwm2m_appfwk_itf_err_code_t LwM2MServerStandIn::writeValues(const lwm2m_appfwk_itf_oiid_t oiid,
+        const std::vector<str_resource_value_t> & values)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    InstanceState * state = find(oiid);
+    if (state == nullptr)
+    {
+        return NOT_FOUND;
+    }
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        if (state->store.check(values[i]) != OK)
+        {
+            return INVALID_RID;
+        }
+    }
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        state->store.set(values[i], false);
+        changed(*state, values[i], false);
+    }
+    m_objects->InstanceChanged.notify(this, oiid);
+    return OK;
+}
+
+e_lwm2m_appfwk_itf_err_code_t LwM2MServerStandIn::setAttributes(const lwm2m_appfwk_itf_oiid_t oiid,
+        const str_notification_attributes_t & attributes)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    InstanceState * state = find(oiid);
+    if ((state == nullptr) || (state->store.find(attributes.rid) == nullptr))
+    {
+        return NOT_FOUND;
+    }
+    const e_lwm2m_appfwk_itf_err_code_t result = state->notifications.setAttributes(attributes);
+    state->notifyDeadline = 0;      // pmax may now be due
+    return result;
+}
+
+e_lwm2m_appfwk_itf_err_code_t LwM2MServerStandIn::getAttributes(const lwm2m_appfwk_itf_oiid_t oiid,
+        str_notification_attributes_t & attributes)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    InstanceState * state = find(oiid);
+    if ((state == nullptr) || (state->store.find(attributes.rid) == nullptr))
+    {
+        return NOT_FOUND;
+    }
+    state->notifications.getAttributes(attributes);
+    return OK;
+}
+
+e_lwm2m_appfwk_itf_err_code_t LwM2MServerStandIn::deleteResource(const lwm2m_appfwk_itf_oiid_t oiid,
+        const lwm2m_appfwk_itf_rid_t rid)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    InstanceState * state = find(oiid);
+    if (state == nullptr)
+    {
+        return NOT_FOUND;
+    }
+    if (rid == state->store.symbolicName().rid)
+    {
+        return METHOD_NOT_ALLOWED;
+    }
+    const e_lwm2m_appfwk_itf_err_code_t result = state->store.remove(rid);
+    if (result == OK)
+    {
+        state->notifications.removeResource(rid);
+        state->observed.erase(rid);
+        state->changedUs.erase(rid);
+        state->serverWritten.erase(rid);
+    }
+    return result;
+}
+
+e_lwm2m_appfwk_itf_err_code_t LwM2MServerStandIn::registerExecute(const lwm2m_appfwk_itf_oiid_t oiid,
+        const lwm2m_appfwk_itf_rid_t rid)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    InstanceState * state = find(oiid);
+    if (state == nullptr)
+    {
+        return NOT_FOUND;
+    }
+    state->execute.registerResource(rid);
+    return OK;
+}
+
+e_lwm2m_appfwk_itf_err_code_t LwM2MServerStandIn::configureExecute(const lwm2m_appfwk_itf_oiid_t oiid,
+        const str_execute_config_t & config)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    InstanceState * state = find(oiid);
+    if (state == nullptr)
+    {
+        return NOT_FOUND;
+    }
+    std::vector<str_executable_parameters_t> dispatch;
+    const e_lwm2m_appfwk_itf_err_code_t result = state->execute.configure(config, dispatch);
+    state->executeDeadline = 0;
+    deliver(oiid, dispatch);
+    return result;
+}
+
+e_lwm2m_appfwk_itf_err_code_t LwM2MServerStandIn::getExecuteStatistics(const lwm2m_appfwk_itf_oiid_t oiid,
+        str_execute_statistics_t & statistics)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    InstanceState * state = find(oiid);
+    return (state != nullptr) ? state->execute.getStatistics(statistics) : NOT_FOUND;
+}
+
+e_lwm2m_appfwk_itf_err_code_t LwM2MServerStandIn::completeExecute(const lwm2m_appfwk_itf_oiid_t oiid,
+        const lwm2m_appfwk_itf_rid_t rid, const uint32_t operationId, const bool success)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    InstanceState * state = find(oiid);
+    if (state == nullptr)
+    {
+        return NOT_FOUND;
+    }
+
+    // setExecuteResult() is only accepted by the scheduler while a single operation of the resource runs.
+    uint32_t completed = operationId;
+    for (std::map<ExecutionKey, Execution>::const_iterator execution = m_executions.lower_bound(ExecutionKey(oiid, 0));
+            (operationId == 0) && (execution != m_executions.end()) && (execution->first.first == oiid); ++execution)
+    {
+        if ((execution->second.rid == rid) && execution->second.delivered)
+        {
+            completed = execution->first.second;
+        }
+    }
+
+    std::vector<str_executable_parameters_t> dispatch;
+    const e_lwm2m_appfwk_itf_err_code_t result = state->execute.complete(rid, operationId, success, nowMs(), dispatch);
+    if (result != OK)
+    {
+        return result;
+    }
+    finish(oiid, completed, success);
+    deliver(oiid, dispatch);
+    return OK;
+}
+
+} /* namespace Connectivity */
+} /* namespace Stla */
@@ -0,0 +1,260 @@
+/**
+ * \file
+ *         LwM2MServerStandIn.hpp
+ * \brief
+ *         LwM2M AppFwk service driven by a local stand-in of the LwM2M server, for load runs on a X86 PC target
+ *
+ * \par Copyright Notice:
+ * \verbatim
+ * Copyright (c) 2021 Stellantis N.V.
+ * All Rights Reserved.
+ * The reproduction, transmission or use of this document or its contents is
+ * not permitted without express written authority.
+ * Offenders will be liable for damages. All rights, including rights created
+ * by patent grant or registration of a utility model or design, are reserved.
+ * \endverbatim
+ */
+
+#ifndef LWM2MSERVERSTANDIN_H_
+#define LWM2MSERVERSTANDIN_H_
+
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "ILwM2MAppFwkService.hpp"
+#include "LwM2MExecuteScheduler.hpp"
+#include "LwM2MInstanceStore.hpp"
+#include "LwM2MNotificationScheduler.hpp"
+
+namespace Stla
+{
+namespace Connectivity
+{
+/**
+ * @brief Notify sent to the stand-in server for the observed resources of an instance.
+ */
+typedef struct str_server_notification
+{
+    lwm2m_appfwk_itf_oiid_t oiid;
+    std::vector<str_resource_value_t> values;
+} str_server_notification_t;
+
+/**
+ * @brief Result of an Execute operation received by the stand-in server.
+ *        latency_us - from serverExecute() to the answer of the application, or to the timeout
+ */
+typedef struct str_server_execute_result
+{
+    lwm2m_appfwk_itf_oiid_t oiid;
+    lwm2m_appfwk_itf_rid_t rid;
+    uint32_t operation_id;
+    bool success;
+    uint64_t latency_us;
+} str_server_execute_result_t;
+
+/**
+ * LwM2MServerStandIn implements ILwM2MAppFwkService for the applications, with the instance store, execute
+ * scheduler and notification scheduler of the service, and plays the LwM2M server on the other side: serverRead(),
+ * serverWrite(), serverExecute() and serverObserve() issue the operations a backend would send through the LwM2M
+ * client.
+ *
+ * Each operation is counted in getOperationStatistics(), with its latency from the server request to the reply:
+ * - Read / Write: the duration of the call.
+ * - Execute: from serverExecute() to setExecuteResult() / setExecuteOperationResult(), or to the timeout.
+ * - Notify: from the first change of a resource to the Notify carrying it, as delayed by its notification attributes.
+ *
+ * poll() runs the timeouts and the notifications; call it when the deadline it returns is reached. Times are taken
+ * from the monotonic clock, so the statistics are real latencies.
+ *
+ * getObjectHandler() returns the same object handler for all bundle contexts, created instances get the symbolic
+ * name given at construction. All the methods lock the stand-in, events are notified with the lock held: a delegate
+ * may call the stand-in back from the notifying thread, not wait for another thread doing so.
+ */
+class LwM2MServerStandIn: public ILwM2MAppFwkService
+{
+public:
+    typedef Poco::AutoPtr<LwM2MServerStandIn> Ptr;
+
+    static const uint64_t NO_DEADLINE = UINT64_MAX;
+
+    /**
+     * @param symbolicName Symbolic Name resource value of the created instances
+     * @param maxInstances createNewInstance() fails with OUT_OF_INSTANCE beyond this number
+     */
+    LwM2MServerStandIn(const std::string & symbolicName, const size_t maxInstances);
+    virtual ~LwM2MServerStandIn();
+
+    /**
+     * @brief Server Read of resources of an instance, all resources of the instance if rids is empty.
+     *
+     * @return
+     * OK (0) - success <br>
+     * NOT_FOUND - no such instance or resource, values is left empty <br>
+     */
+    e_lwm2m_appfwk_itf_err_code_t serverRead(const lwm2m_appfwk_itf_oiid_t oiid,
+            const std::vector<lwm2m_appfwk_itf_rid_t> & rids, std::vector<str_resource_value_t> & values);
+
+    /**
+     * @brief Server Write of resources of an instance. The write is atomic; the application receives one
+     * xxxResourceChanged event per resource and one InstanceChanged event.
+     *
+     * @return
+     * OK (0) - success <br>
+     * NOT_FOUND - no such instance <br>
+     * METHOD_NOT_ALLOWED - at least one resource is read-only; nothing is written <br>
+     * INVALID_RID - at least one resource exists with another type; nothing is written <br>
+     */
+    e_lwm2m_appfwk_itf_err_code_t serverWrite(const lwm2m_appfwk_itf_oiid_t oiid,
+            const std::vector<str_resource_value_t> & values);
+
+    /**
+     * @brief Server Execute of a resource. The result arrives with the ExecuteCompleted event.
+     *
+     * @param operation_id identifier given to the operation by the execute scheduler.
+     *
+     * @return
+     * OK (0) - the operation is running or queued <br>
+     * NOT_FOUND - no such instance, or the resource is not registered with registerExecuteOpHandler <br>
+     * OUT_OF_MEMORY - the queue of the resource is full, the operation failed <br>
+     */
+    e_lwm2m_appfwk_itf_err_code_t serverExecute(const lwm2m_appfwk_itf_oiid_t oiid,
+            const lwm2m_appfwk_itf_rid_t rid, const std::vector<std::string> & parameters, uint32_t & operation_id);
+
+    /**
+     * @brief Server Observe (or cancel observation) of a resource. Changes of an observed resource are sent with
+     * the NotifyReceived event, as scheduled by its notification attributes.
+     *
+     * @return
+     * OK (0) - success <br>
+     * NOT_FOUND - no such instance or resource <br>
+     */
+    e_lwm2m_appfwk_itf_err_code_t serverObserve(const lwm2m_appfwk_itf_oiid_t oiid,
+            const lwm2m_appfwk_itf_rid_t rid, const bool observe);
+
+    /**
+     * @brief Run the execute timeouts and the notifications due now.
+     *
+     * @return the next deadline on the monotonic clock in milliseconds (see nowMs()), or NO_DEADLINE.
+     */
+    uint64_t poll();
+
+    /**
+     * @brief Monotonic clock of the stand-in, in milliseconds.
+     */
+    static uint64_t nowMs();
+
+    /**
+     * @brief Notify received by the stand-in server.
+     */
+    Poco::BasicEvent<const str_server_notification_t> NotifyReceived;
+
+    /**
+     * @brief Execute result received by the stand-in server.
+     */
+    Poco::BasicEvent<const str_server_execute_result_t> ExecuteCompleted;
+
+    // ILwM2MAppFwkService
+    virtual e_lwm2m_appfwk_itf_err_code_t isServiceReady() const;
+    virtual ILwM2MObjectHandler::Ptr getObjectHandler(Poco::OSP::BundleContext::Ptr pAppBndlContext);
+    virtual e_lwm2m_appfwk_itf_err_code_t getOperationStatistics(std::vector<str_operation_statistics_t> & statistics);
+    virtual e_lwm2m_appfwk_itf_err_code_t resetOperationStatistics();
+
+private:
+    class Objects;
+    class Instance;
+
+    struct InstanceState
+    {
+        LwM2MInstanceStore store;
+        LwM2MExecuteScheduler execute;
+        LwM2MNotificationScheduler notifications;
+        Poco::AutoPtr<Instance> handler;
+        std::set<lwm2m_appfwk_itf_rid_t> observed;
+        std::map<lwm2m_appfwk_itf_rid_t, uint64_t> changedUs;   // first change not notified yet
+        std::set<lwm2m_appfwk_itf_rid_t> serverWritten;         // changes notified to the application
+        uint64_t executeDeadline;
+        uint64_t notifyDeadline;
+    };
+
+    typedef std::pair<lwm2m_appfwk_itf_oiid_t, uint32_t> ExecutionKey;    // operation_ids are per instance
+
+    struct Execution
+    {
+        lwm2m_appfwk_itf_rid_t rid;
+        uint64_t startUs;
+        bool delivered;     // running, as opposed to queued
+    };
+
+    struct Counter
+    {
+        Counter();
+
+        uint64_t count;
+        uint64_t failed;
+        uint64_t minUs;
+        uint64_t sumUs;
+        uint64_t maxUs;
+    };
+
+    LwM2MServerStandIn(const LwM2MServerStandIn &);
+    LwM2MServerStandIn & operator=(const LwM2MServerStandIn &);
+
+    static uint64_t nowUs();
+
+    InstanceState * find(const lwm2m_appfwk_itf_oiid_t oiid);
+    void record(const e_lwm2m_appfwk_itf_operation_t operation, const bool success, const uint64_t latencyUs);
+    void changed(InstanceState & state, const str_resource_value_t & value, const bool byServer);
+    void deliver(const lwm2m_appfwk_itf_oiid_t oiid, const std::vector<str_executable_parameters_t> & dispatch);
+    void finish(const lwm2m_appfwk_itf_oiid_t oiid, const uint32_t operationId, const bool success);
+    void runInstance(const lwm2m_appfwk_itf_oiid_t oiid, const uint64_t now);
+
+    // Object handler
+    e_lwm2m_appfwk_itf_err_code_t getInstanceList(std::vector<lwm2m_appfwk_itf_oiid_t> & instance_list);
+    ILwM2MInstanceHandler::Ptr getInstance(const lwm2m_appfwk_itf_oiid_t oiid);
+    e_lwm2m_appfwk_itf_err_code_t createInstance(const lwm2m_appfwk_itf_oiid_t oiid, const str_instance_t & instance);
+    e_lwm2m_appfwk_itf_err_code_t deleteInstance(const lwm2m_appfwk_itf_oiid_t oiid);
+
+    // Instance handlers
+    e_lwm2m_appfwk_itf_err_code_t exportInstance(const lwm2m_appfwk_itf_oiid_t oiid, str_instance_t & instance);
+    e_lwm2m_appfwk_itf_err_code_t getResourceIds(const lwm2m_appfwk_itf_oiid_t oiid,
+            str_instance_resources_t & instance_rids);
+    e_lwm2m_appfwk_itf_err_code_t getSymbolicName(const lwm2m_appfwk_itf_oiid_t oiid,
+            str_string_resource_t & resource);
+    e_lwm2m_appfwk_itf_err_code_t getValue(const lwm2m_appfwk_itf_oiid_t oiid,
+            const e_lwm2m_appfwk_itf_res_type_t type, str_resource_value_t & value);
+    e_lwm2m_appfwk_itf_err_code_t setValue(const lwm2m_appfwk_itf_oiid_t oiid, const str_resource_value_t & value);
+    e_lwm2m_appfwk_itf_err_code_t readValues(const lwm2m_appfwk_itf_oiid_t oiid, const str_instance_resources_t & rids,
+            std::vector<str_resource_value_t> & values);
+    e_lwm2m_appfwk_itf_err_code_t writeValues(const lwm2m_appfwk_itf_oiid_t oiid,
+            const std::vector<str_resource_value_t> & values);
+    e_lwm2m_appfwk_itf_err_code_t setAttributes(const lwm2m_appfwk_itf_oiid_t oiid,
+            const str_notification_attributes_t & attributes);
+    e_lwm2m_appfwk_itf_err_code_t getAttributes(const lwm2m_appfwk_itf_oiid_t oiid,
+            str_notification_attributes_t & attributes);
+    e_lwm2m_appfwk_itf_err_code_t deleteResource(const lwm2m_appfwk_itf_oiid_t oiid, const lwm2m_appfwk_itf_rid_t rid);
+    e_lwm2m_appfwk_itf_err_code_t registerExecute(const lwm2m_appfwk_itf_oiid_t oiid, const lwm2m_appfwk_itf_rid_t rid);
+    e_lwm2m_appfwk_itf_err_code_t configureExecute(const lwm2m_appfwk_itf_oiid_t oiid,
+            const str_execute_config_t & config);
+    e_lwm2m_appfwk_itf_err_code_t getExecuteStatistics(const lwm2m_appfwk_itf_oiid_t oiid,
+            str_execute_statistics_t & statistics);
+    e_lwm2m_appfwk_itf_err_code_t completeExecute(const lwm2m_appfwk_itf_oiid_t oiid,
+            const lwm2m_appfwk_itf_rid_t rid, const uint32_t operationId, const bool success);
+
+    const std::string m_symbolicName;
+    const size_t m_maxInstances;
+
+    std::recursive_mutex m_mutex;
+    Poco::AutoPtr<Objects> m_objects;
+    std::map<lwm2m_appfwk_itf_oiid_t, InstanceState> m_instances;
+    std::map<ExecutionKey, Execution> m_executions; // running and queued Execute operations
+    Counter m_counters[OPERATION_NOTIFY + 1];
+};
+
+} /* namespace Connectivity */
+} /* namespace Stla */
+
+#endif /* LWM2MSERVERSTANDIN_H_ */
@@ -43,7 +43,9 @@ namespace Connectivity
 		ID_UNUSED,          		/**< index is not set */
 		BROKER_ALREADY_CONFIGURED, 	/**< another Third Party  application is already using the interface */
 		BROKER_NOT_AVAILABLE, 		/**< MQTT Manager does not respond */
-		UNKNOWN_ERROR				/**< Unknown Error */
+		UNKNOWN_ERROR,				/**< Unknown Error */
+		CONF_INVALID,				/**< the configuration item cannot be parsed */
+		QUEUE_FULL					/**< the publish queue of the configuration item is full, retry on event_Writable */
 	} mqtt_conf_err_code_t;
 
 	/**
@@ -51,6 +53,47 @@ namespace Connectivity
 	 */
 	#define MAX_CONF_ITEM 10
 
+	/**
+	 * @brief One "topic" line of a bridge configuration: topic pattern [[[ out | in | both ] qos-level] local-prefix remote-prefix]
+	 */
+	typedef struct mqtt_bridge_topic
+	{
+		std::string pattern;		/**< topic pattern, may contain + and # wildcards */
+		std::string direction;		/**< "out", "in" or "both" */
+		unsigned int qos;			/**< QoS level, 0..2 */
+		std::string local_prefix;	/**< local topic prefix, may be empty */
+		std::string remote_prefix;	/**< remote topic prefix, may be empty */
+	} mqtt_bridge_topic_t;
+
+	/**
+	 * @brief One bridge of a configuration item: a "connection" line and the bridge lines following it, with the broker
+	 * default value when a line is absent.
+	 */
+	typedef struct mqtt_bridge_conf
+	{
+		std::string connection;						/**< bridge name ("connection") */
+		std::vector<std::string> addresses;			/**< broker addresses "host[:port]" ("address" / "addresses") */
+		std::vector<mqtt_bridge_topic_t> topics;	/**< bridged topics ("topic") */
+		std::string remote_clientid;				/**< client id used on the remote broker ("remote_clientid") */
+		unsigned int keepalive_interval;			/**< keep-alive period in seconds ("keepalive_interval", default 60) */
+		bool cleansession;							/**< "cleansession", default false */
+		std::string bridge_protocol_version;		/**< "mqttv31", "mqttv311" or "mqttv50" ("bridge_protocol_version", default "mqttv311") */
+	} mqtt_bridge_conf_t;
+
+	/**
+	 * @brief Configuration item parsed and validated by the service when it is set.
+	 *
+	 * The raw "key value" lines are kept in parameters, in order. Like in a broker configuration file, an item may
+	 * define several bridges, each starting at its "connection" line.
+	 */
+	typedef struct mqtt_conf_item
+	{
+		unsigned int index;							/**< index of the configuration item */
+		unsigned int version;						/**< changes each time the item is set, never reused for the same index */
+		std::vector<mqtt_bridge_conf_t> bridges;	/**< bridges defined by the item, in order, empty if none */
+		std::vector<std::pair<std::string, std::string> > parameters;	/**< all "key value" lines of the item, in order, the value may be empty */
+	} mqtt_conf_item_t;
+
 #ifdef DOXYGEN_WORKING
     class IMqttConfHandler : public Poco::RefCountedObject
 #else
@@ -112,6 +155,26 @@ namespace Connectivity
          */
 		virtual mqtt_conf_err_code_t getItem(unsigned int index, std::string &config_out) = 0;
 
+        /**
+         * @brief Read 1 configuration item, as parsed by the service when it was set.
+         *
+         * @param index index of the configuration item to read (between 0 and MAX_CONF_ITEM - 1; MAX_CONF_ITEM = 10 -> index between 0 and 9)
+         * @param item_out output parameter: parsed configuration item
+         *
+         * @return Status of the operation. OK on success.
+         */
+		virtual mqtt_conf_err_code_t getParsedItem(unsigned int index, mqtt_conf_item_t &item_out) = 0;
+
+        /**
+         * @brief Read the version of 1 configuration item, to check cheaply whether it changed since the last read.
+         *
+         * @param index index of the configuration item (between 0 and MAX_CONF_ITEM - 1; MAX_CONF_ITEM = 10 -> index between 0 and 9)
+         * @param version_out output parameter: version of the item, see mqtt_conf_item_t
+         *
+         * @return Status of the operation. OK on success, ID_UNUSED if the index is not set.
+         */
+		virtual mqtt_conf_err_code_t getItemVersion(unsigned int index, unsigned int &version_out) = 0;
+
         /**
          * @brief Writes a new configuration item.
          * 
@@ -157,6 +220,7 @@ namespace Connectivity
          * @warning this operation will create the configuration item if not set, or will overwrite the current configuration
          * @warning if the MQTT broker cannot apply the given configuration, the operation will fail & the previous configuration will be kept unchanged.
          * @warning if the total configuration exceeds the maximum size, the operation will fail & the previous configuration will be kept unchanged.
+         * @warning the configuration is parsed and validated once here: if it cannot be parsed, the operation fails with CONF_INVALID & the previous configuration will be kept unchanged.
          * @warning if only a parameter of the configuration will be changed the whole configuration needs to be sent because the content of hte config files
          * which corresponds to the given index will be replaced with the new content from config parameter
          *
@@ -0,0 +1,392 @@
+/**
+ * \file
+ *         IMqttPublishService.hpp
+ * \brief
+ *         Interface available for 3rd Party application to publish and receive MQTT messages through the shared broker connections.
+ *
+ * \par Copyright Notice:
+ * \verbatim
+ * Copyright (c) 2021 Stellantis N.V.
+ * All Rights Reserved.
+ * The reproduction, transmission or use of this document or its contents is
+ * not permitted without express written authority.
+ * Offenders will be liable for damages. All rights, including rights created
+ * by patent grant or registration of a utility model or design, are reserved.
+ * \endverbatim
+ */
+
+#ifndef IMQTTPUBLISHSERVICE_H_
+#define IMQTTPUBLISHSERVICE_H_
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include <Poco/BasicEvent.h>
+#include <Poco/OSP/Service.h>
+#include "Poco/OSP/BundleContext.h"
+#include "Poco/SharedPtr.h"
+
+#include "IMqttConfService.hpp"
+
+
+namespace Stla
+{
+namespace Connectivity
+{
+	/**
+	 * @brief One message to publish.
+	 */
+	typedef struct mqtt_publish_message
+	{
+		uint32_t message_id;		/**< set by the service when the message is accepted, reported in event_PublishCompleted */
+		std::string topic;			/**< topic name, without wildcards */
+		std::string payload;		/**< payload, binary content allowed */
+		unsigned int qos;			/**< 0 or 1 */
+		bool retain;				/**< retain flag */
+	} mqtt_publish_message_t;
+
+	/**
+	 * @brief Publish pipeline settings of one configuration item. They apply to all the publishers sharing the connection.
+	 */
+	typedef struct mqtt_publish_config
+	{
+		unsigned int batch_max_messages;	/**< messages written to the connection at once; 1 disables batching */
+		unsigned int batch_max_bytes;		/**< payload bytes written to the connection at once */
+		unsigned int batch_max_delay_ms;	/**< longest time a message waits for a batch to fill; 0 sends at once */
+		unsigned int inflight_window;		/**< QoS 1 messages sent and not acknowledged yet */
+		unsigned int max_queued_bytes;		/**< payload bytes queued or in flight before publish() returns QUEUE_FULL */
+	} mqtt_publish_config_t;
+
+	/**
+	 * @brief Result of one message, reported in event_PublishCompleted.
+	 */
+	typedef struct mqtt_publish_result
+	{
+		uint32_t message_id;		/**< as returned by publish() */
+		bool delivered;				/**< QoS 0: written to the connection, QoS 1: acknowledged by the broker */
+	} mqtt_publish_result_t;
+
+	/**
+	 * @brief Counters of one configuration item, all publishers together, since the service start or resetPublishStatistics().
+	 *
+	 * Throughput is obtained by reading the counters twice: (delivered, delivered_bytes) difference over the elapsed time.
+	 * Latencies are measured from publish() to the write of the message (QoS 0) or to its acknowledgement (QoS 1).
+	 */
+	typedef struct mqtt_publish_statistics
+	{
+		uint64_t published;			/**< messages accepted by publish() */
+		uint64_t delivered;			/**< messages written (QoS 0) or acknowledged (QoS 1) */
+		uint64_t delivered_bytes;	/**< payload bytes of the delivered messages */
+		uint64_t rejected;			/**< publish() calls that returned QUEUE_FULL */
+		uint64_t batches;			/**< writes to the connection */
+		uint64_t redelivered;		/**< QoS 1 messages sent again after a reconnection */
+		unsigned int queued;		/**< messages waiting for a batch */
+		unsigned int inflight;		/**< QoS 1 messages waiting for their acknowledgement */
+		unsigned int queued_bytes;	/**< payload bytes queued or in flight */
+		uint64_t qos0_latency_avg_ms;	/**< average publish-to-write time of the QoS 0 messages */
+		uint64_t qos0_latency_max_ms;	/**< longest publish-to-write time of the QoS 0 messages */
+		uint64_t qos1_latency_avg_ms;	/**< average publish-to-acknowledgement time of the QoS 1 messages */
+		uint64_t qos1_latency_max_ms;	/**< longest publish-to-acknowledgement time of the QoS 1 messages */
+	} mqtt_publish_statistics_t;
+
+	/**
+	 * @brief One message received from the broker, notified to each subscriber whose filters match its topic.
+	 *
+	 * All the subscribers receive the same payload buffer: it must not be modified, and can be kept after the notification
+	 * without copy.
+	 */
+	typedef struct mqtt_inbound_message
+	{
+		std::string topic;								/**< topic name */
+		Poco::SharedPtr<const std::string> payload;		/**< payload, binary content allowed, never null */
+		unsigned int qos;								/**< QoS of the delivery, 0..2 */
+		bool retain;									/**< true for a retained message sent on subscription */
+	} mqtt_inbound_message_t;
+
+	/**
+	 * @brief Store-and-forward settings of the messages whose topic matches topic_filter. The first matching policy applies.
+	 */
+	typedef struct mqtt_topic_policy
+	{
+		std::string topic_filter;	/**< topic filter, may contain + and # wildcards */
+		unsigned int priority;		/**< 0..255, messages with a higher priority are forwarded first */
+		unsigned int ttl_s;			/**< seconds after publish() after which a stored message is dropped; 0 for no limit */
+	} mqtt_topic_policy_t;
+
+	/**
+	 * @brief Store-and-forward settings of one configuration item.
+	 *
+	 * While the broker connection is down (e.g. telematic APN down), accepted messages are appended to segment files in the
+	 * private data storage namespace of the service instead of RAM. They are forwarded when the connection is back,
+	 * highest priority first then oldest first, at drain_rate_bytes_per_s so the newly attached link is not saturated.
+	 */
+	typedef struct mqtt_store_forward_config
+	{
+		bool enabled;								/**< false: publish() returns QUEUE_FULL once the RAM queue is full while disconnected */
+		unsigned int disk_budget_bytes;				/**< total size of the segment files; the oldest segment is dropped to make room */
+		unsigned int segment_bytes;					/**< size of one segment file, at most disk_budget_bytes / 2 */
+		unsigned int drain_rate_bytes_per_s;		/**< forwarding rate after reconnection; 0 for no limit */
+		unsigned int drain_burst_bytes;				/**< bytes that can be forwarded at once within the rate */
+		std::vector<mqtt_topic_policy_t> topic_policies;	/**< messages matching no policy get priority 0 and no TTL */
+	} mqtt_store_forward_config_t;
+
+	/**
+	 * @brief Store-and-forward counters of one configuration item.
+	 */
+	typedef struct mqtt_store_forward_statistics
+	{
+		uint64_t stored;			/**< messages written to disk */
+		uint64_t forwarded;			/**< stored messages delivered after reconnection */
+		uint64_t expired;			/**< stored messages dropped at the end of their TTL */
+		uint64_t dropped;			/**< stored messages dropped with the oldest segment to stay within disk_budget_bytes */
+		unsigned int messages;		/**< messages on disk, not forwarded yet */
+		unsigned int disk_bytes;	/**< size of the segment files */
+	} mqtt_store_forward_statistics_t;
+
+#ifdef DOXYGEN_WORKING
+    class IMqttPublisher : public Poco::RefCountedObject
+#else
+    class __attribute__((visibility("default"))) IMqttPublisher : public Poco::RefCountedObject
+#endif
+    {
+
+    public:
+
+        /**
+         * @brief Class smart pointer definition
+         */
+        typedef Poco::AutoPtr<IMqttPublisher> Ptr;
+
+        /**
+         * @brief Destroy the IMqttPublisher handler
+         *
+         */
+        virtual ~IMqttPublisher() {}
+
+        /**
+         * @brief Index of the configuration item whose broker connection is used.
+         */
+        virtual unsigned int getIndex() const = 0;
+
+        /**
+         * @brief Queue a message for publication. The call does not wait for the network.
+         *
+         * @param message message to publish; message_id is ignored
+         * @param message_id_out output parameter: identifier reported in event_PublishCompleted
+         *
+         * @warning when the uplink is slower than the publishers, publish() returns QUEUE_FULL instead of buffering without limit.
+         *          The caller keeps the message and retries on event_Writable.
+         *
+         * @warning while the broker connection is down and store-and-forward is enabled, the message is written to disk and
+         *          OK is returned; event_PublishCompleted is notified once it is forwarded, or with delivered = false if it
+         *          expires or is dropped.
+         *
+         * @return Status of the operation. OK on success, QUEUE_FULL when the queue of the configuration item is full,
+         *         METHOD_NOT_ALLOWED for a QoS other than 0 and 1 or a topic with wildcards.
+         */
+        virtual mqtt_conf_err_code_t publish(const mqtt_publish_message_t &message, uint32_t &message_id_out) = 0;
+
+        /**
+         * @brief Read the counters of the configuration item.
+         *
+         * @return Status of the operation. OK on success.
+         */
+        virtual mqtt_conf_err_code_t getStatistics(mqtt_publish_statistics_t &statistics_out) = 0;
+
+        /**
+         * @brief Poco event notifying the result of the messages of this publisher, in publication order for a given QoS.
+         */
+        Poco::BasicEvent<const mqtt_publish_result_t> event_PublishCompleted;
+
+        /**
+         * @brief Poco event notifying that the queue went back under half of max_queued_bytes after publish() returned QUEUE_FULL.
+         */
+        Poco::BasicEvent<const unsigned int> event_Writable;
+
+    };
+
+#ifdef DOXYGEN_WORKING
+    class IMqttSubscriber : public Poco::RefCountedObject
+#else
+    class __attribute__((visibility("default"))) IMqttSubscriber : public Poco::RefCountedObject
+#endif
+    {
+
+    public:
+
+        /**
+         * @brief Class smart pointer definition
+         */
+        typedef Poco::AutoPtr<IMqttSubscriber> Ptr;
+
+        /**
+         * @brief Destroy the IMqttSubscriber handler, removing its subscriptions
+         *
+         */
+        virtual ~IMqttSubscriber() {}
+
+        /**
+         * @brief Index of the configuration item whose broker connection is used.
+         */
+        virtual unsigned int getIndex() const = 0;
+
+        /**
+         * @brief Subscribe to a topic filter.
+         *
+         * The filters of all the subscribers of a configuration item are compiled into one topic tree: each received message
+         * is matched once, whatever the number of subscribers, and notified once to each matching subscriber even if several
+         * of its filters match. The service subscribes on the broker once per distinct filter.
+         *
+         * @param topic_filter topic filter, + matches one level and # the remaining levels
+         * @param qos maximum QoS requested from the broker, 0..2
+         *
+         * @return Status of the operation. OK on success (also if already subscribed), METHOD_NOT_ALLOWED for an invalid filter or QoS.
+         */
+        virtual mqtt_conf_err_code_t subscribe(const std::string &topic_filter, unsigned int qos) = 0;
+
+        /**
+         * @brief Remove a subscription.
+         *
+         * @return Status of the operation. OK on success, ID_UNUSED if the filter is not subscribed.
+         */
+        virtual mqtt_conf_err_code_t unsubscribe(const std::string &topic_filter) = 0;
+
+        /**
+         * @brief Poco event notifying a received message matching at least one filter of this subscriber.
+         */
+        Poco::BasicEvent<const mqtt_inbound_message_t> event_MessageReceived;
+
+    };
+
+
+    /**
+     * @brief MQTT Publish - AppFwk service name used in OSP
+     */
+    const char* const MQTT_PUBLISH_SERVICE_NAME = "stla.connectivity.mqttpublish.service.base";
+
+    /**
+     * @brief IMqttPublishService gives the applications a shared publish pipeline and inbound router per MQTT configuration item.
+     *
+     * The service opens one broker connection per configuration item set through IMqttConfHandler, and multiplexes the
+     * messages of all the publishers of that item on it: small messages are batched into one write, QoS 1 messages are
+     * sent within an in-flight window.
+     */
+#ifdef DOXYGEN_WORKING
+    class IMqttPublishService : public Poco::OSP::Service
+#else
+    class __attribute__((visibility("default"))) IMqttPublishService : public Poco::OSP::Service
+#endif
+    {
+    public:
+
+        /**
+         * @brief Class smart pointer definition
+         */
+        typedef Poco::AutoPtr<IMqttPublishService> Ptr;
+
+        /**
+         * @brief IMqttPublishService constructor.
+         */
+        IMqttPublishService() {}
+
+        /**
+         * @brief IMqttPublishService destructor.
+         */
+        virtual ~IMqttPublishService() {}
+
+        /**
+         * @brief Get a publisher on the broker connection of a configuration item, unique per bundlecontext and index.
+         *
+         * @param pAppBndlContext Application context
+         * @param index index of the configuration item (between 0 and MAX_CONF_ITEM - 1)
+         * @param publisher_out output parameter: the publisher
+         *
+         * @return Status of the operation. OK on success, ID_INVALID or ID_UNUSED for an index without configuration item.
+         */
+        virtual mqtt_conf_err_code_t getMqttPublisher(Poco::OSP::BundleContext::Ptr pAppBndlContext, unsigned int index,
+                IMqttPublisher::Ptr &publisher_out) = 0;
+
+        /**
+         * @brief Get a subscriber on the broker connection of a configuration item, unique per bundlecontext and index.
+         *
+         * @param pAppBndlContext Application context
+         * @param index index of the configuration item (between 0 and MAX_CONF_ITEM - 1)
+         * @param subscriber_out output parameter: the subscriber
+         *
+         * @return Status of the operation. OK on success, ID_INVALID or ID_UNUSED for an index without configuration item.
+         */
+        virtual mqtt_conf_err_code_t getMqttSubscriber(Poco::OSP::BundleContext::Ptr pAppBndlContext, unsigned int index,
+                IMqttSubscriber::Ptr &subscriber_out) = 0;
+
+        /**
+         * @brief Set the publish pipeline settings of a configuration item.
+         *
+         * @param index index of the configuration item (between 0 and MAX_CONF_ITEM - 1)
+         * @param config new settings; queued and in-flight messages are kept
+         *
+         * @return Status of the operation. OK on success, METHOD_NOT_ALLOWED if a count is 0.
+         */
+        virtual mqtt_conf_err_code_t setPublishConfig(unsigned int index, const mqtt_publish_config_t &config) = 0;
+
+        /**
+         * @brief Get the publish pipeline settings of a configuration item.
+         *
+         * @return Status of the operation. OK on success.
+         */
+        virtual mqtt_conf_err_code_t getPublishConfig(unsigned int index, mqtt_publish_config_t &config_out) = 0;
+
+        /**
+         * @brief Set the store-and-forward settings of a configuration item. Stored messages are kept.
+         *
+         * @return Status of the operation. OK on success, METHOD_NOT_ALLOWED for a segment_bytes of 0 or above
+         *         disk_budget_bytes / 2, or a priority above 255.
+         */
+        virtual mqtt_conf_err_code_t setStoreForwardConfig(unsigned int index, const mqtt_store_forward_config_t &config) = 0;
+
+        /**
+         * @brief Get the store-and-forward settings of a configuration item.
+         *
+         * @return Status of the operation. OK on success.
+         */
+        virtual mqtt_conf_err_code_t getStoreForwardConfig(unsigned int index, mqtt_store_forward_config_t &config_out) = 0;
+
+        /**
+         * @brief Read the store-and-forward counters of a configuration item.
+         *
+         * @return Status of the operation. OK on success.
+         */
+        virtual mqtt_conf_err_code_t getStoreForwardStatistics(unsigned int index,
+                mqtt_store_forward_statistics_t &statistics_out) = 0;
+
+        /**
+         * @brief Reset the publish counters of a configuration item, e.g. before a measurement. Queued and in-flight
+         * messages are kept; their latency is counted when they are delivered.
+         *
+         * @return Status of the operation. OK on success.
+         */
+        virtual mqtt_conf_err_code_t resetPublishStatistics(unsigned int index) = 0;
+
+        /**
+         * @brief	Returns the service information for the object's class.
+         */
+        const std::type_info& type() const
+        {
+            return typeid(IMqttPublishService);
+        }
+
+        /**
+         * @brief	Returns true if the class is a subclass of the class given by obj.
+         */
+        bool isA(const std::type_info& obj) const
+        {
+            std::string name(type().name());
+            return name == obj.name();
+        }
+
+    };
+
+} ///* namespace Connectivity */
+} ///* namespace Stla */
+
+#endif ///* IMQTTPUBLISHSERVICE_H_ */
@@ -0,0 +1,361 @@
+/**
+ * \file
+ *         MqttConfItemCache.cpp
+ * \brief
+ *         Parsing, validation and caching of the MQTT configuration items set through IMqttConfHandler.
+ *
+ * \par Copyright Notice:
+ * \verbatim
+ * Copyright (c) 2021 Stellantis N.V.
+ * All Rights Reserved.
+ * The reproduction, transmission or use of this document or its contents is
+ * not permitted without express written authority.
+ * Offenders will be liable for damages. All rights, including rights created
+ * by patent grant or registration of a utility model or design, are reserved.
+ * \endverbatim
+ */
+
+#include "MqttConfItemCache.hpp"
+
+#include <cstdlib>
+#include <sstream>
+
+namespace Stla
+{
+namespace Connectivity
+{
+namespace
+{
+const unsigned int DEFAULT_KEEPALIVE_INTERVAL = 60;
+const char DEFAULT_PROTOCOL_VERSION[] = "mqttv311";
+
+std::string trim(const std::string &text)
+{
+    const std::string::size_type first = text.find_first_not_of(" \t\r");
+    if (first == std::string::npos)
+    {
+        return std::string();
+    }
+    const std::string::size_type last = text.find_last_not_of(" \t\r");
+    return text.substr(first, last - first + 1);
+}
+
+void split(const std::string &text, std::vector<std::string> &tokens)
+{
+    std::istringstream stream(text);
+    std::string token;
+    while (stream >> token)
+    {
+        tokens.push_back(token);
+    }
+}
+
+bool parseUnsigned(const std::string &text, unsigned long max, unsigned int &value)
+{
+    if (text.empty() || (text.find_first_not_of("0123456789") != std::string::npos) || (text.size() > 10))
+    {
+        return false;
+    }
+    const unsigned long result = std::strtoul(text.c_str(), nullptr, 10);
+    if (result > max)
+    {
+        return false;
+    }
+    value = static_cast<unsigned int>(result);
+    return true;
+}
+
+bool validAddress(const std::string &address)
+{
+    const std::string::size_type colon = address.rfind(':');
+    if (colon == std::string::npos)
+    {
+        return !address.empty();
+    }
+    unsigned int port;
+    return (colon > 0) && parseUnsigned(address.substr(colon + 1), 65535, port) && (port > 0);
+}
+
+/**
+ * topic pattern [[[ out | in | both ] qos-level] local-prefix remote-prefix], "" stands for an empty prefix.
+ */
+bool parseTopic(const std::string &value, mqtt_bridge_topic_t &topic)
+{
+    std::vector<std::string> tokens;
+    split(value, tokens);
+    if (tokens.empty() || (tokens.size() > 5))
+    {
+        return false;
+    }
+    topic.pattern = tokens[0];
+    topic.direction = (tokens.size() > 1) ? tokens[1] : "out";
+    topic.qos = 0;
+    if ((topic.direction != "out") && (topic.direction != "in") && (topic.direction != "both"))
+    {
+        return false;
+    }
+    if ((tokens.size() > 2) && !parseUnsigned(tokens[2], 2, topic.qos))
+    {
+        return false;
+    }
+    topic.local_prefix = (tokens.size() > 3 && tokens[3] != "\"\"") ? tokens[3] : "";
+    topic.remote_prefix = (tokens.size() > 4 && tokens[4] != "\"\"") ? tokens[4] : "";
+    return topic.pattern != "\"\"" || !topic.local_prefix.empty() || !topic.remote_prefix.empty();
+}
+
+bool isBridgeKey(const std::string &key)
+{
+    return (key == "address") || (key == "addresses") || (key == "topic") || (key == "keepalive_interval")
+            || (key == "cleansession") || (key == "remote_clientid") || (key == "bridge_protocol_version");
+}
+
+bool parseBridgeLine(const std::string &key, const std::string &value, mqtt_bridge_conf_t &bridge)
+{
+    bool valid = true;
+    if ((key == "address") || (key == "addresses"))
+    {
+        std::vector<std::string> addresses;
+        split(value, addresses);
+        for (std::vector<std::string>::const_iterator it = addresses.begin(); it != addresses.end(); ++it)
+        {
+            valid = valid && validAddress(*it);
+        }
+        bridge.addresses.insert(bridge.addresses.end(), addresses.begin(), addresses.end());
+    }
+    else if (key == "topic")
+    {
+        mqtt_bridge_topic_t topic;
+        valid = parseTopic(value, topic);
+        bridge.topics.push_back(topic);
+    }
+    else if (key == "keepalive_interval")
+    {
+        valid = parseUnsigned(value, 65535, bridge.keepalive_interval) && (bridge.keepalive_interval > 0);
+    }
+    else if (key == "cleansession")
+    {
+        valid = (value == "true") || (value == "false");
+        bridge.cleansession = (value == "true");
+    }
+    else if (key == "remote_clientid")
+    {
+        bridge.remote_clientid = value;
+    }
+    else if (key == "bridge_protocol_version")
+    {
+        valid = (value == "mqttv31") || (value == "mqttv311") || (value == "mqttv50");
+        bridge.bridge_protocol_version = value;
+    }
+    return valid;
+}
+
+/**
+ * The last bridge of the item is complete: it has an address and its name is not used by a previous bridge.
+ */
+bool checkBridge(const mqtt_conf_item_t &item, std::string &error_out)
+{
+    if (item.bridges.empty())
+    {
+        return true;
+    }
+    const mqtt_bridge_conf_t &bridge = item.bridges.back();
+    if (bridge.addresses.empty())
+    {
+        error_out = "connection " + bridge.connection + " has no address";
+        return false;
+    }
+    for (size_t i = 0; i + 1 < item.bridges.size(); ++i)
+    {
+        if (item.bridges[i].connection == bridge.connection)
+        {
+            error_out = "connection " + bridge.connection + " is defined twice";
+            return false;
+        }
+    }
+    return true;
+}
+} // namespace
+
+MqttConfItemCache::MqttConfItemCache() :
+        m_lastVersion(0)
+{
+    clear();
+}
+
+bool MqttConfItemCache::parse(const std::string &config, mqtt_conf_item_t &item_out, std::string &error_out)
+{
+    mqtt_conf_item_t item = mqtt_conf_item_t();
+
+    std::istringstream stream(config);
+    std::string line;
+    unsigned int lineNumber = 0;
+    while (std::getline(stream, line))
+    {
+        ++lineNumber;
+        line = trim(line);
+        if (line.empty() || (line[0] == '#'))
+        {
+            continue;
+        }
+
+        const std::string::size_type separator = line.find_first_of(" \t");
+        const std::string key = line.substr(0, separator);
+        const std::string value = (separator == std::string::npos) ? std::string() : trim(line.substr(separator));
+
+        std::ostringstream error;
+        error << "line " << lineNumber << ": ";
+        if (key.find_first_not_of("abcdefghijklmnopqrstuvwxyz0123456789_") != std::string::npos)
+        {
+            error_out = error.str() + "expected \"key value\"";
+            return false;
+        }
+        if (isBridgeKey(key) && item.bridges.empty())
+        {
+            error_out = error.str() + key + " must follow a connection line";
+            return false;
+        }
+
+        // Other keys are passed to the broker as they are, only the bridge settings are checked here.
+        bool valid = true;
+        if (key == "connection")
+        {
+            if (!checkBridge(item, error_out))
+            {
+                return false;
+            }
+            mqtt_bridge_conf_t bridge = mqtt_bridge_conf_t();
+            bridge.connection = value;
+            bridge.keepalive_interval = DEFAULT_KEEPALIVE_INTERVAL;
+            bridge.cleansession = false;
+            bridge.bridge_protocol_version = DEFAULT_PROTOCOL_VERSION;
+            item.bridges.push_back(bridge);
+            valid = !value.empty();
+        }
+        else if (isBridgeKey(key))
+        {
+            valid = !value.empty() && parseBridgeLine(key, value, item.bridges.back());
+        }
+
+        if (!valid)
+        {
+            error_out = error.str() + "invalid " + key;
+            return false;
+        }
+        item.parameters.push_back(std::make_pair(key, value));
+    }
+
+    if (!checkBridge(item, error_out))
+    {
+        return false;
+    }
+    item_out = item;
+    return true;
+}
+
+mqtt_conf_err_code_t MqttConfItemCache::set(unsigned int index, const std::string &config)
+{
+    if (index >= MAX_CONF_ITEM)
+    {
+        return ID_INVALID;
+    }
+    mqtt_conf_item_t item;
+    std::string error;
+    if (!parse(config, item, error))
+    {
+        return CONF_INVALID;
+    }
+    item.index = index;
+    item.version = ++m_lastVersion;
+
+    Entry &entry = m_entries[index];
+    entry.used = true;
+    entry.raw = config;
+    entry.parsed = item;
+    return OK;
+}
+
+mqtt_conf_err_code_t MqttConfItemCache::remove(unsigned int index)
+{
+    const Entry *entry;
+    const mqtt_conf_err_code_t result = find(index, entry);
+    if (result == OK)
+    {
+        m_entries[index].used = false;
+        m_entries[index].raw.clear();
+        m_entries[index].parsed = mqtt_conf_item_t();
+    }
+    return result;
+}
+
+mqtt_conf_err_code_t MqttConfItemCache::getRaw(unsigned int index, std::string &config_out) const
+{
+    const Entry *entry;
+    const mqtt_conf_err_code_t result = find(index, entry);
+    if (result == OK)
+    {
+        config_out = entry->raw;
+    }
+    return result;
+}
+
+mqtt_conf_err_code_t MqttConfItemCache::getParsed(unsigned int index, mqtt_conf_item_t &item_out) const
+{
+    const Entry *entry;
+    const mqtt_conf_err_code_t result = find(index, entry);
+    if (result == OK)
+    {
+        item_out = entry->parsed;
+    }
+    return result;
+}
+
+mqtt_conf_err_code_t MqttConfItemCache::getVersion(unsigned int index, unsigned int &version_out) const
+{
+    const Entry *entry;
+    const mqtt_conf_err_code_t result = find(index, entry);
+    if (result == OK)
+    {
+        version_out = entry->parsed.version;
+    }
+    return result;
+}
+
+void MqttConfItemCache::getIndexList(std::vector<unsigned int> &indexes_out) const
+{
+    indexes_out.clear();
+    for (unsigned int index = 0; index < MAX_CONF_ITEM; ++index)
+    {
+        if (m_entries[index].used)
+        {
+            indexes_out.push_back(index);
+        }
+    }
+}
+
+void MqttConfItemCache::clear()
+{
+    // Versions keep increasing, so a reader never mistakes a new item for the one it cached.
+    for (unsigned int index = 0; index < MAX_CONF_ITEM; ++index)
+    {
+        m_entries[index].used = false;
+        m_entries[index].raw.clear();
+        m_entries[index].parsed = mqtt_conf_item_t();
+    }
+}
+
+mqtt_conf_err_code_t MqttConfItemCache::find(unsigned int index, const Entry *&entry_out) const
+{
+    if (index >= MAX_CONF_ITEM)
+    {
+        return ID_INVALID;
+    }
+    if (!m_entries[index].used)
+    {
+        return ID_UNUSED;
+    }
+    entry_out = &m_entries[index];
+    return OK;
+}
+
+} /* namespace Connectivity */
+} /* namespace Stla */
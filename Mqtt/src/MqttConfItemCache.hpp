@@ -0,0 +1,96 @@
+/**
+ * \file
+ *         MqttConfItemCache.hpp
+ * \brief
+ *         Parsing, validation and caching of the MQTT configuration items set through IMqttConfHandler.
+ *
+ * \par Copyright Notice:
+ * \verbatim
+ * Copyright (c) 2021 Stellantis N.V.
+ * All Rights Reserved.
+ * The reproduction, transmission or use of this document or its contents is
+ * not permitted without express written authority.
+ * Offenders will be liable for damages. All rights, including rights created
+ * by patent grant or registration of a utility model or design, are reserved.
+ * \endverbatim
+ */
+
+#ifndef MQTTCONFITEMCACHE_H_
+#define MQTTCONFITEMCACHE_H_
+
+#include <string>
+#include <vector>
+
+#include "IMqttConfService.hpp"
+
+namespace Stla
+{
+namespace Connectivity
+{
+/**
+ * MqttConfItemCache keeps, for each index, the raw configuration string and its parsed form.
+ * Items are parsed once in set(); readers get the parsed item or its version without parsing.
+ *
+ * The class is not thread-safe.
+ */
+class MqttConfItemCache
+{
+public:
+    MqttConfItemCache();
+
+    /**
+     * @brief Parse a configuration string (mosquitto configuration syntax, one "key value" per line, # for comments).
+     * Each "connection" line starts a new bridge; only the bridge settings are validated, other lines are kept as they are.
+     *
+     * @param error_out description of the first invalid line, on failure
+     *
+     * @return true if the configuration is valid; index and version of item_out are not set.
+     */
+    static bool parse(const std::string &config, mqtt_conf_item_t &item_out, std::string &error_out);
+
+    /**
+     * @brief Parse and store a configuration item.
+     *
+     * @return OK, ID_INVALID for an index out of range, CONF_INVALID if the configuration cannot be parsed (the previous item is kept).
+     */
+    mqtt_conf_err_code_t set(unsigned int index, const std::string &config);
+
+    /**
+     * @return OK, ID_INVALID for an index out of range, ID_UNUSED if the index is not set.
+     */
+    mqtt_conf_err_code_t remove(unsigned int index);
+
+    mqtt_conf_err_code_t getRaw(unsigned int index, std::string &config_out) const;
+
+    mqtt_conf_err_code_t getParsed(unsigned int index, mqtt_conf_item_t &item_out) const;
+
+    mqtt_conf_err_code_t getVersion(unsigned int index, unsigned int &version_out) const;
+
+    /**
+     * @brief Sorted list of the indexes set.
+     */
+    void getIndexList(std::vector<unsigned int> &indexes_out) const;
+
+    /**
+     * @brief Remove all items (e.g. ADK mode change).
+     */
+    void clear();
+
+private:
+    struct Entry
+    {
+        bool used;
+        std::string raw;
+        mqtt_conf_item_t parsed;
+    };
+
+    mqtt_conf_err_code_t find(unsigned int index, const Entry *&entry_out) const;
+
+    Entry m_entries[MAX_CONF_ITEM];
+    unsigned int m_lastVersion;
+};
+
+} /* namespace Connectivity */
+} /* namespace Stla */
+
+#endif /* MQTTCONFITEMCACHE_H_ */
@@ -0,0 +1,264 @@
+/**
+ * \file
+ *         MqttPublishQueue.cpp
+ * \brief
+ *         Batching, QoS 1 in-flight window and back-pressure of the messages published on one broker connection.
+ *
+ * \par Copyright Notice:
+ * \verbatim
+ * Copyright (c) 2021 Stellantis N.V.
+ * All Rights Reserved.
+ * The reproduction, transmission or use of this document or its contents is
+ * not permitted without express written authority.
+ * Offenders will be liable for damages. All rights, including rights created
+ * by patent grant or registration of a utility model or design, are reserved.
+ * \endverbatim
+ */
+
+#include "MqttPublishQueue.hpp"
+
+namespace Stla
+{
+namespace Connectivity
+{
+const uint64_t MqttPublishQueue::NO_DEADLINE;
+const unsigned int MqttPublishQueue::DEFAULT_BATCH_MAX_MESSAGES;
+const unsigned int MqttPublishQueue::DEFAULT_BATCH_MAX_BYTES;
+const unsigned int MqttPublishQueue::DEFAULT_BATCH_MAX_DELAY_MS;
+const unsigned int MqttPublishQueue::DEFAULT_INFLIGHT_WINDOW;
+const unsigned int MqttPublishQueue::DEFAULT_MAX_QUEUED_BYTES;
+
+MqttPublishQueue::MqttPublishQueue() :
+        m_config(), m_pendingBytes(0), m_queuedBytes(0), m_blocked(false), m_blockedBytes(0), m_lastMessageId(0),
+        m_statistics()
+{
+    resetStatistics();
+    m_config.batch_max_messages = DEFAULT_BATCH_MAX_MESSAGES;
+    m_config.batch_max_bytes = DEFAULT_BATCH_MAX_BYTES;
+    m_config.batch_max_delay_ms = DEFAULT_BATCH_MAX_DELAY_MS;
+    m_config.inflight_window = DEFAULT_INFLIGHT_WINDOW;
+    m_config.max_queued_bytes = DEFAULT_MAX_QUEUED_BYTES;
+}
+
+mqtt_conf_err_code_t MqttPublishQueue::setConfig(const mqtt_publish_config_t &config)
+{
+    if ((config.batch_max_messages == 0) || (config.batch_max_bytes == 0) || (config.inflight_window == 0)
+            || (config.max_queued_bytes == 0))
+    {
+        return METHOD_NOT_ALLOWED;
+    }
+    m_config = config;
+    return OK;
+}
+
+const mqtt_publish_config_t &MqttPublishQueue::getConfig() const
+{
+    return m_config;
+}
+
+mqtt_conf_err_code_t MqttPublishQueue::enqueue(const mqtt_publish_message_t &message, const uint64_t nowMs,
+        uint32_t &message_id_out)
+{
+    return add(message, 0, nowMs, message_id_out);
+}
+
+mqtt_conf_err_code_t MqttPublishQueue::requeue(const mqtt_publish_message_t &message, const uint32_t message_id,
+        const uint64_t nowMs, uint32_t &message_id_out)
+{
+    return add(message, message_id, nowMs, message_id_out);
+}
+
+mqtt_conf_err_code_t MqttPublishQueue::add(const mqtt_publish_message_t &message, const uint32_t message_id,
+        const uint64_t nowMs, uint32_t &message_id_out)
+{
+    if ((message.qos > 1) || message.topic.empty() || (message.topic.find_first_of("+#") != std::string::npos)
+            || (message.payload.size() > m_config.max_queued_bytes))
+    {
+        return METHOD_NOT_ALLOWED;
+    }
+    const unsigned int size = static_cast<unsigned int>(message.payload.size());
+    if (m_queuedBytes + size > m_config.max_queued_bytes)
+    {
+        m_blocked = true;
+        if (size > m_blockedBytes)
+        {
+            m_blockedBytes = size;
+        }
+        ++m_statistics.rejected;
+        return QUEUE_FULL;
+    }
+
+    Entry entry;
+    entry.message = message;
+    entry.message.message_id = (message_id != 0) ? message_id : allocateMessageId();
+    entry.enqueuedMs = nowMs;
+    entry.sent = false;
+    m_pending.push_back(entry);
+    m_pendingBytes += size;
+    m_queuedBytes += size;
+    ++m_statistics.published;
+
+    message_id_out = entry.message.message_id;
+    return OK;
+}
+
+uint32_t MqttPublishQueue::allocateMessageId()
+{
+    if (++m_lastMessageId == 0)
+    {
+        m_lastMessageId = 1;
+    }
+    return m_lastMessageId;
+}
+
+uint64_t MqttPublishQueue::takeBatch(const uint64_t nowMs, std::vector<mqtt_publish_message_t> &batch,
+        std::vector<mqtt_publish_result_t> &completed)
+{
+    if (ready(nowMs))
+    {
+        unsigned int batchBytes = 0;
+        const size_t first = batch.size();
+        while (!m_pending.empty() && (batch.size() - first < m_config.batch_max_messages))
+        {
+            const Entry &entry = m_pending.front();
+            const unsigned int size = static_cast<unsigned int>(entry.message.payload.size());
+            if (((entry.message.qos == 1) && windowFull())
+                    || ((batch.size() > first) && (batchBytes + size > m_config.batch_max_bytes)))
+            {
+                break;
+            }
+
+            batch.push_back(entry.message);
+            batchBytes += size;
+            m_pendingBytes -= size;
+            if (entry.sent)
+            {
+                ++m_statistics.redelivered;
+            }
+            if (entry.message.qos == 1)
+            {
+                m_inflight.push_back(entry);
+            }
+            else
+            {
+                mqtt_publish_result_t result;
+                result.message_id = entry.message.message_id;
+                result.delivered = true;
+                completed.push_back(result);
+                m_queuedBytes -= size;
+                delivered(entry, nowMs);
+            }
+            m_pending.pop_front();
+        }
+        if (batch.size() > first)
+        {
+            ++m_statistics.batches;
+        }
+    }
+
+    if (m_pending.empty() || ((m_pending.front().message.qos == 1) && windowFull()))
+    {
+        return NO_DEADLINE;
+    }
+    if (ready(nowMs))
+    {
+        return nowMs;
+    }
+    return m_pending.front().enqueuedMs + m_config.batch_max_delay_ms;
+}
+
+bool MqttPublishQueue::acknowledge(const uint32_t message_id, const uint64_t nowMs, mqtt_publish_result_t &result_out)
+{
+    // Acknowledgements normally come in sending order, so the matching entry is near the front.
+    for (std::list<Entry>::iterator it = m_inflight.begin(); it != m_inflight.end(); ++it)
+    {
+        if (it->message.message_id == message_id)
+        {
+            m_queuedBytes -= static_cast<unsigned int>(it->message.payload.size());
+            delivered(*it, nowMs);
+            m_inflight.erase(it);
+            result_out.message_id = message_id;
+            result_out.delivered = true;
+            return true;
+        }
+    }
+    return false;
+}
+
+void MqttPublishQueue::connectionLost()
+{
+    while (!m_inflight.empty())
+    {
+        Entry &entry = m_inflight.back();
+        entry.sent = true;
+        m_pendingBytes += static_cast<unsigned int>(entry.message.payload.size());
+        m_pending.push_front(entry);
+        m_inflight.pop_back();
+    }
+}
+
+bool MqttPublishQueue::takeWritable()
+{
+    // Wait until the largest rejected message fits, so a retry on event_Writable does not fail again.
+    if (m_blocked && (m_queuedBytes <= m_config.max_queued_bytes / 2)
+            && (m_queuedBytes + m_blockedBytes <= m_config.max_queued_bytes))
+    {
+        m_blocked = false;
+        m_blockedBytes = 0;
+        return true;
+    }
+    return false;
+}
+
+void MqttPublishQueue::getStatistics(mqtt_publish_statistics_t &statistics_out) const
+{
+    statistics_out = m_statistics;
+    statistics_out.queued = static_cast<unsigned int>(m_pending.size());
+    statistics_out.inflight = static_cast<unsigned int>(m_inflight.size());
+    statistics_out.queued_bytes = m_queuedBytes;
+    statistics_out.qos0_latency_avg_ms = (m_deliveredByQos[0] > 0) ? m_latencySumMs[0] / m_deliveredByQos[0] : 0;
+    statistics_out.qos1_latency_avg_ms = (m_deliveredByQos[1] > 0) ? m_latencySumMs[1] / m_deliveredByQos[1] : 0;
+}
+
+void MqttPublishQueue::resetStatistics()
+{
+    m_statistics = mqtt_publish_statistics_t();
+    for (size_t qos = 0; qos < 2; ++qos)
+    {
+        m_latencySumMs[qos] = 0;
+        m_deliveredByQos[qos] = 0;
+    }
+}
+
+void MqttPublishQueue::delivered(const Entry &entry, const uint64_t nowMs)
+{
+    const uint64_t latencyMs = (nowMs > entry.enqueuedMs) ? nowMs - entry.enqueuedMs : 0;
+    const unsigned int qos = entry.message.qos;
+    ++m_statistics.delivered;
+    m_statistics.delivered_bytes += entry.message.payload.size();
+    ++m_deliveredByQos[qos];
+    m_latencySumMs[qos] += latencyMs;
+    uint64_t &latencyMaxMs = (qos == 0) ? m_statistics.qos0_latency_max_ms : m_statistics.qos1_latency_max_ms;
+    if (latencyMs > latencyMaxMs)
+    {
+        latencyMaxMs = latencyMs;
+    }
+}
+
+bool MqttPublishQueue::ready(const uint64_t nowMs) const
+{
+    if (m_pending.empty())
+    {
+        return false;
+    }
+    return (m_pending.size() >= m_config.batch_max_messages) || (m_pendingBytes >= m_config.batch_max_bytes)
+            || (nowMs >= m_pending.front().enqueuedMs + m_config.batch_max_delay_ms);
+}
+
+bool MqttPublishQueue::windowFull() const
+{
+    return m_inflight.size() >= m_config.inflight_window;
+}
+
+} /* namespace Connectivity */
+} /* namespace Stla */
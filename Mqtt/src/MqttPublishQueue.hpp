@@ -0,0 +1,152 @@
+/**
+ * \file
+ *         MqttPublishQueue.hpp
+ * \brief
+ *         Batching, QoS 1 in-flight window and back-pressure of the messages published on one broker connection.
+ *
+ * \par Copyright Notice:
+ * \verbatim
+ * Copyright (c) 2021 Stellantis N.V.
+ * All Rights Reserved.
+ * The reproduction, transmission or use of this document or its contents is
+ * not permitted without express written authority.
+ * Offenders will be liable for damages. All rights, including rights created
+ * by patent grant or registration of a utility model or design, are reserved.
+ * \endverbatim
+ */
+
+#ifndef MQTTPUBLISHQUEUE_H_
+#define MQTTPUBLISHQUEUE_H_
+
+#include <deque>
+#include <list>
+#include <vector>
+#include <cstdint>
+
+#include "IMqttPublishService.hpp"
+
+namespace Stla
+{
+namespace Connectivity
+{
+/**
+ * MqttPublishQueue holds the messages of all the publishers of one configuration item.
+ *
+ * Messages from publish() are given to enqueue(). The connection thread calls takeBatch() when the deadline
+ * returned by the previous call is reached, or after enqueue() / acknowledge(), and writes the returned
+ * messages at once. acknowledge() is called for each PUBACK, connectionLost() when the connection drops.
+ *
+ * Messages leave the queue in publication order: a QoS 1 message waiting for room in the in-flight window
+ * also holds back the QoS 0 messages queued after it.
+ *
+ * Times are monotonic, in milliseconds. The class is not thread-safe.
+ */
+class MqttPublishQueue
+{
+public:
+    /**
+     * @brief Value returned by takeBatch() when nothing can be sent before an enqueue() or acknowledge().
+     */
+    static const uint64_t NO_DEADLINE = UINT64_MAX;
+
+    static const unsigned int DEFAULT_BATCH_MAX_MESSAGES = 32;
+    static const unsigned int DEFAULT_BATCH_MAX_BYTES = 16384;
+    static const unsigned int DEFAULT_BATCH_MAX_DELAY_MS = 20;
+    static const unsigned int DEFAULT_INFLIGHT_WINDOW = 20;     // mosquitto max_inflight_messages default
+    static const unsigned int DEFAULT_MAX_QUEUED_BYTES = 1048576;
+
+    MqttPublishQueue();
+
+    /**
+     * @return OK, METHOD_NOT_ALLOWED if a count is 0.
+     */
+    mqtt_conf_err_code_t setConfig(const mqtt_publish_config_t &config);
+
+    const mqtt_publish_config_t &getConfig() const;
+
+    /**
+     * @brief Accept a message from publish(), and assign it a new message_id (message.message_id is ignored).
+     *
+     * @return OK, QUEUE_FULL when max_queued_bytes would be exceeded, METHOD_NOT_ALLOWED for an invalid message
+     * or a payload larger than max_queued_bytes.
+     */
+    mqtt_conf_err_code_t enqueue(const mqtt_publish_message_t &message, const uint64_t nowMs, uint32_t &message_id_out);
+
+    /**
+     * @brief Accept a message forwarded from disk, with the message_id reserved by allocateMessageId() when it was
+     * stored, or 0 for a message recovered after a restart, which gets a new one.
+     *
+     * @return as enqueue().
+     */
+    mqtt_conf_err_code_t requeue(const mqtt_publish_message_t &message, const uint32_t message_id, const uint64_t nowMs,
+            uint32_t &message_id_out);
+
+    /**
+     * @brief Reserve a message_id, e.g. for a message stored on disk while the connection is down.
+     */
+    uint32_t allocateMessageId();
+
+    /**
+     * @brief Take the next batch, if one is ready.
+     *
+     * @param batch messages to write now, in order; QoS 1 messages are then in flight.
+     * @param completed results of the QoS 0 messages of the batch, to notify once the batch is written.
+     *
+     * @return the time of the next call: nowMs if another batch is ready, or NO_DEADLINE.
+     */
+    uint64_t takeBatch(const uint64_t nowMs, std::vector<mqtt_publish_message_t> &batch,
+            std::vector<mqtt_publish_result_t> &completed);
+
+    /**
+     * @brief Record the acknowledgement of a QoS 1 message.
+     *
+     * @return false if the message is not in flight (duplicate acknowledgement).
+     */
+    bool acknowledge(const uint32_t message_id, const uint64_t nowMs, mqtt_publish_result_t &result_out);
+
+    /**
+     * @brief Put the in-flight messages back at the front of the queue, to be sent again on the next connection.
+     */
+    void connectionLost();
+
+    /**
+     * @brief true once when the queue went back under half of max_queued_bytes after enqueue() returned QUEUE_FULL,
+     * with room for the largest rejected message.
+     */
+    bool takeWritable();
+
+    void getStatistics(mqtt_publish_statistics_t &statistics_out) const;
+
+    void resetStatistics();
+
+private:
+    struct Entry
+    {
+        mqtt_publish_message_t message;
+        uint64_t enqueuedMs;
+        bool sent;      // sent on a previous connection
+    };
+
+    mqtt_conf_err_code_t add(const mqtt_publish_message_t &message, const uint32_t message_id, const uint64_t nowMs,
+            uint32_t &message_id_out);
+    void delivered(const Entry &entry, const uint64_t nowMs);
+    bool ready(const uint64_t nowMs) const;
+    bool windowFull() const;
+
+    mqtt_publish_config_t m_config;
+    std::deque<Entry> m_pending;
+    std::list<Entry> m_inflight;    // in sending order
+    unsigned int m_pendingBytes;
+    unsigned int m_queuedBytes;     // pending and in flight
+    bool m_blocked;
+    unsigned int m_blockedBytes;    // largest payload rejected since m_blocked was set
+    uint32_t m_lastMessageId;
+    mqtt_publish_statistics_t m_statistics;
+    uint64_t m_latencySumMs[2];     // by QoS
+    uint64_t m_deliveredByQos[2];
+};
+
+} /* namespace Connectivity */
+} /* namespace Stla */
+
+#endif /* MQTTPUBLISHQUEUE_H_ */
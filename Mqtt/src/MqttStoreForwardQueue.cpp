@@ -0,0 +1,523 @@
+/**
+ * \file
+ *         MqttStoreForwardQueue.cpp
+ * \brief
+ *         Disk-backed queue of the messages published while the broker connection of a configuration item is down.
+ *
+ * \par Copyright Notice:
+ * \verbatim
+ * Copyright (c) 2021 Stellantis N.V.
+ * All Rights Reserved.
+ * The reproduction, transmission or use of this document or its contents is
+ * not permitted without express written authority.
+ * Offenders will be liable for damages. All rights, including rights created
+ * by patent grant or registration of a utility model or design, are reserved.
+ * \endverbatim
+ */
+
+#include "MqttStoreForwardQueue.hpp"
+
+#include <algorithm>
+
+namespace Stla
+{
+namespace Connectivity
+{
+namespace
+{
+const unsigned int DEFAULT_DISK_BUDGET_BYTES = 4194304;
+const unsigned int DEFAULT_SEGMENT_BYTES = 262144;
+const unsigned int DEFAULT_DRAIN_RATE_BYTES_PER_S = 16384;
+const unsigned int DEFAULT_DRAIN_BURST_BYTES = 4096;
+
+/*
+ * Record: length (4) | crc32 of body (4) | body
+ * Message body: RECORD_MESSAGE | sequence (8) | expiry (8) | priority | qos | retain | topic length (2) | topic | payload
+ * Tombstone body: RECORD_TOMBSTONE | sequence (8)
+ * Integers are little endian.
+ */
+const unsigned char RECORD_MESSAGE = 1;
+const unsigned char RECORD_TOMBSTONE = 2;
+const size_t RECORD_HEADER_SIZE = 8;
+const size_t MESSAGE_HEADER_SIZE = 1 + 8 + 8 + 3 + 2;
+const size_t TOMBSTONE_SIZE = 1 + 8;
+
+uint32_t crc32(const unsigned char *data, const size_t length)
+{
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < length; ++i)
+    {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; ++bit)
+        {
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+        }
+    }
+    return ~crc;
+}
+
+void putUint(std::vector<unsigned char> &out, uint64_t value, const size_t size)
+{
+    for (size_t i = 0; i < size; ++i)
+    {
+        out.push_back(static_cast<unsigned char>(value & 0xFF));
+        value >>= 8;
+    }
+}
+
+uint64_t getUint(const unsigned char *in, const size_t size)
+{
+    uint64_t value = 0;
+    for (size_t i = size; i > 0; --i)
+    {
+        value = (value << 8) | in[i - 1];
+    }
+    return value;
+}
+
+void seal(std::vector<unsigned char> &record)
+{
+    // record starts with RECORD_HEADER_SIZE placeholder bytes
+    const uint32_t length = static_cast<uint32_t>(record.size() - RECORD_HEADER_SIZE);
+    const uint32_t crc = crc32(&record[RECORD_HEADER_SIZE], length);
+    for (size_t i = 0; i < 4; ++i)
+    {
+        record[i] = static_cast<unsigned char>(length >> (8 * i));
+        record[4 + i] = static_cast<unsigned char>(crc >> (8 * i));
+    }
+}
+
+void splitLevels(const std::string &topic, std::vector<std::string> &levels)
+{
+    size_t start = 0;
+    size_t end;
+    while ((end = topic.find('/', start)) != std::string::npos)
+    {
+        levels.push_back(topic.substr(start, end - start));
+        start = end + 1;
+    }
+    levels.push_back(topic.substr(start));
+}
+
+/**
+ * MQTT topic filter matching: + matches one level, # the remaining levels (including none).
+ */
+bool topicMatches(const std::string &filter, const std::string &topic)
+{
+    std::vector<std::string> filterLevels;
+    std::vector<std::string> topicLevels;
+    splitLevels(filter, filterLevels);
+    splitLevels(topic, topicLevels);
+    for (size_t i = 0; i < filterLevels.size(); ++i)
+    {
+        if (filterLevels[i] == "#")
+        {
+            return true;
+        }
+        if ((i >= topicLevels.size()) || ((filterLevels[i] != "+") && (filterLevels[i] != topicLevels[i])))
+        {
+            return false;
+        }
+    }
+    return filterLevels.size() == topicLevels.size();
+}
+} // namespace
+
+const uint64_t MqttStoreForwardQueue::NO_DEADLINE;
+
+MqttStoreForwardQueue::MqttStoreForwardQueue(IMqttSegmentStorage &storage) :
+        m_storage(storage), m_config(), m_current(0), m_nextSequence(1), m_diskBytes(0), m_tokens(0),
+        m_lastRefillMs(0), m_statistics()
+{
+    m_config.enabled = false;
+    m_config.disk_budget_bytes = DEFAULT_DISK_BUDGET_BYTES;
+    m_config.segment_bytes = DEFAULT_SEGMENT_BYTES;
+    m_config.drain_rate_bytes_per_s = DEFAULT_DRAIN_RATE_BYTES_PER_S;
+    m_config.drain_burst_bytes = DEFAULT_DRAIN_BURST_BYTES;
+}
+
+bool MqttStoreForwardQueue::open()
+{
+    std::vector<uint32_t> segments;
+    if (!m_storage.list(segments))
+    {
+        return false;
+    }
+    std::sort(segments.begin(), segments.end());
+
+    for (std::vector<uint32_t>::const_iterator it = segments.begin(); it != segments.end(); ++it)
+    {
+        std::vector<unsigned char> image;
+        if (!m_storage.load(*it, image))
+        {
+            return false;
+        }
+        recover(*it, image);
+    }
+    for (std::map<uint64_t, Entry>::const_iterator it = m_entries.begin(); it != m_entries.end(); ++it)
+    {
+        ++m_segments[it->second.segment].live;
+    }
+    collect();
+    return true;
+}
+
+mqtt_conf_err_code_t MqttStoreForwardQueue::setConfig(const mqtt_store_forward_config_t &config)
+{
+    if ((config.segment_bytes == 0) || (config.segment_bytes > config.disk_budget_bytes / 2))
+    {
+        return METHOD_NOT_ALLOWED;
+    }
+    for (std::vector<mqtt_topic_policy_t>::const_iterator it = config.topic_policies.begin();
+            it != config.topic_policies.end(); ++it)
+    {
+        if (it->priority > 255)
+        {
+            return METHOD_NOT_ALLOWED;
+        }
+    }
+    m_config = config;
+    return OK;
+}
+
+const mqtt_store_forward_config_t &MqttStoreForwardQueue::getConfig() const
+{
+    return m_config;
+}
+
+mqtt_conf_err_code_t MqttStoreForwardQueue::store(const mqtt_publish_message_t &message, const uint64_t nowS,
+        std::vector<uint32_t> &dropped)
+{
+    unsigned int priority;
+    unsigned int ttl_s;
+    policy(message.topic, priority, ttl_s);
+
+    std::vector<unsigned char> record(RECORD_HEADER_SIZE, 0);
+    record.reserve(RECORD_HEADER_SIZE + MESSAGE_HEADER_SIZE + message.topic.size() + message.payload.size());
+    record.push_back(RECORD_MESSAGE);
+    putUint(record, m_nextSequence, 8);
+    const uint64_t expiryS = (ttl_s != 0) ? nowS + ttl_s : 0;
+    putUint(record, expiryS, 8);
+    record.push_back(static_cast<unsigned char>(priority));
+    record.push_back(static_cast<unsigned char>(message.qos));
+    record.push_back(message.retain ? 1 : 0);
+    putUint(record, message.topic.size(), 2);
+    record.insert(record.end(), message.topic.begin(), message.topic.end());
+    record.insert(record.end(), message.payload.begin(), message.payload.end());
+    seal(record);
+
+    if ((message.topic.size() > 0xFFFF) || (record.size() > m_config.disk_budget_bytes))
+    {
+        return METHOD_NOT_ALLOWED;
+    }
+    while ((m_diskBytes + record.size() > m_config.disk_budget_bytes) && !m_segments.empty())
+    {
+        evictOldest(dropped);
+    }
+
+    Entry entry;
+    if (!append(record, entry.segment, entry.offset))
+    {
+        return UNKNOWN_ERROR;
+    }
+    entry.messageId = message.message_id;
+    entry.length = static_cast<uint32_t>(record.size());
+    entry.priority = priority;
+    entry.expiryS = expiryS;
+    entry.taken = false;
+    ++m_segments[entry.segment].live;
+    m_entries[m_nextSequence] = entry;
+    m_order.insert(OrderKey(255 - priority, m_nextSequence));
+    ++m_nextSequence;
+    ++m_statistics.stored;
+    return OK;
+}
+
+void MqttStoreForwardQueue::expire(const uint64_t nowS, std::vector<uint32_t> &expired)
+{
+    std::map<uint64_t, Entry>::iterator it = m_entries.begin();
+    while (it != m_entries.end())
+    {
+        std::map<uint64_t, Entry>::iterator current = it++;
+        if (!current->second.taken && (current->second.expiryS != 0) && (current->second.expiryS <= nowS))
+        {
+            expired.push_back(current->second.messageId);
+            ++m_statistics.expired;
+            erase(current);
+        }
+    }
+    // Expired messages get no tombstone: they expire again when recovered after a restart.
+    collect();
+}
+
+void MqttStoreForwardQueue::startDrain(const uint64_t nowMs)
+{
+    m_tokens = 0;
+    m_lastRefillMs = nowMs;
+}
+
+uint64_t MqttStoreForwardQueue::nextTake(const uint64_t nowMs)
+{
+    if (m_order.empty())
+    {
+        return NO_DEADLINE;
+    }
+    if (m_config.drain_rate_bytes_per_s == 0)
+    {
+        return nowMs;
+    }
+    refill(nowMs);
+    const Entry &entry = m_entries[m_order.begin()->second];
+    const int64_t needed = static_cast<int64_t>(std::min(entry.length, m_config.drain_burst_bytes)) * 1000;
+    if (m_tokens >= needed)
+    {
+        return nowMs;
+    }
+    return nowMs + static_cast<uint64_t>(needed - m_tokens + m_config.drain_rate_bytes_per_s - 1)
+            / m_config.drain_rate_bytes_per_s;
+}
+
+bool MqttStoreForwardQueue::take(const uint64_t nowMs, mqtt_publish_message_t &message_out, uint64_t &sequence_out)
+{
+    if (nextTake(nowMs) != nowMs)
+    {
+        return false;
+    }
+    const uint64_t sequence = m_order.begin()->second;
+    std::map<uint64_t, Entry>::iterator it = m_entries.find(sequence);
+    Entry &entry = it->second;
+
+    std::vector<unsigned char> record;
+    if (!m_storage.read(entry.segment, entry.offset, entry.length, record) || (record.size() != entry.length)
+            || (getUint(&record[4], 4) != crc32(&record[RECORD_HEADER_SIZE], entry.length - RECORD_HEADER_SIZE)))
+    {
+        // Unreadable: the message cannot be forwarded.
+        ++m_statistics.dropped;
+        erase(it);
+        collect();
+        return false;
+    }
+
+    const unsigned char *body = &record[RECORD_HEADER_SIZE];
+    const size_t topicLength = static_cast<size_t>(getUint(body + 20, 2));
+    message_out.message_id = entry.messageId;
+    message_out.qos = body[18];
+    message_out.retain = (body[19] != 0);
+    message_out.topic.assign(reinterpret_cast<const char *>(body + MESSAGE_HEADER_SIZE), topicLength);
+    message_out.payload.assign(reinterpret_cast<const char *>(body + MESSAGE_HEADER_SIZE + topicLength),
+            entry.length - RECORD_HEADER_SIZE - MESSAGE_HEADER_SIZE - topicLength);
+
+    if (m_config.drain_rate_bytes_per_s != 0)
+    {
+        m_tokens -= static_cast<int64_t>(entry.length) * 1000;
+    }
+    m_order.erase(m_order.begin());
+    entry.taken = true;
+    sequence_out = sequence;
+    return true;
+}
+
+void MqttStoreForwardQueue::untake(const uint64_t sequence)
+{
+    std::map<uint64_t, Entry>::iterator it = m_entries.find(sequence);
+    if ((it != m_entries.end()) && it->second.taken)
+    {
+        it->second.taken = false;
+        m_order.insert(OrderKey(255 - it->second.priority, sequence));
+    }
+}
+
+bool MqttStoreForwardQueue::release(const uint64_t sequence)
+{
+    std::map<uint64_t, Entry>::iterator it = m_entries.find(sequence);
+    if (it == m_entries.end())
+    {
+        // dropped with its segment while forwarded
+        return true;
+    }
+    const uint32_t segment = it->second.segment;
+    ++m_statistics.forwarded;
+    erase(it);
+    collect();
+    if (m_segments.find(segment) == m_segments.end())
+    {
+        // The segment is gone: the message cannot come back, no tombstone needed.
+        return true;
+    }
+
+    std::vector<unsigned char> record(RECORD_HEADER_SIZE, 0);
+    record.push_back(RECORD_TOMBSTONE);
+    putUint(record, sequence, 8);
+    seal(record);
+    uint32_t tombstoneSegment;
+    uint32_t offset;
+    return append(record, tombstoneSegment, offset);
+}
+
+void MqttStoreForwardQueue::getStatistics(mqtt_store_forward_statistics_t &statistics_out) const
+{
+    statistics_out = m_statistics;
+    statistics_out.messages = static_cast<unsigned int>(m_entries.size());
+    statistics_out.disk_bytes = static_cast<unsigned int>(m_diskBytes);
+}
+
+void MqttStoreForwardQueue::policy(const std::string &topic, unsigned int &priority, unsigned int &ttl_s) const
+{
+    priority = 0;
+    ttl_s = 0;
+    for (std::vector<mqtt_topic_policy_t>::const_iterator it = m_config.topic_policies.begin();
+            it != m_config.topic_policies.end(); ++it)
+    {
+        if (topicMatches(it->topic_filter, topic))
+        {
+            priority = it->priority;
+            ttl_s = it->ttl_s;
+            return;
+        }
+    }
+}
+
+bool MqttStoreForwardQueue::append(const std::vector<unsigned char> &record, uint32_t &segment, uint32_t &offset)
+{
+    std::map<uint32_t, Segment>::iterator current = m_segments.find(m_current);
+    if ((current != m_segments.end()) && (current->second.bytes + record.size() > m_config.segment_bytes))
+    {
+        ++m_current;
+        current = m_segments.end();
+    }
+    if (!m_storage.append(m_current, record))
+    {
+        return false;
+    }
+    if (current == m_segments.end())
+    {
+        current = m_segments.insert(std::make_pair(m_current, Segment())).first;
+        current->second.bytes = 0;
+        current->second.live = 0;
+    }
+    segment = m_current;
+    offset = current->second.bytes;
+    current->second.bytes += static_cast<uint32_t>(record.size());
+    m_diskBytes += record.size();
+    return true;
+}
+
+void MqttStoreForwardQueue::recover(const uint32_t segment, const std::vector<unsigned char> &image)
+{
+    size_t offset = 0;
+    while (offset + RECORD_HEADER_SIZE <= image.size())
+    {
+        const unsigned char *header = &image[offset];
+        const size_t length = static_cast<size_t>(getUint(header, 4));
+        if ((length == 0) || (length > image.size() - offset - RECORD_HEADER_SIZE)
+                || (getUint(header + 4, 4) != crc32(header + RECORD_HEADER_SIZE, length)))
+        {
+            break;
+        }
+        const unsigned char *body = header + RECORD_HEADER_SIZE;
+        const uint64_t sequence = (length >= TOMBSTONE_SIZE) ? getUint(body + 1, 8) : 0;
+        if ((body[0] == RECORD_MESSAGE) && (length >= MESSAGE_HEADER_SIZE)
+                && (MESSAGE_HEADER_SIZE + getUint(body + 20, 2) <= length))
+        {
+            Entry entry;
+            entry.messageId = 0;
+            entry.segment = segment;
+            entry.offset = static_cast<uint32_t>(offset);
+            entry.length = static_cast<uint32_t>(RECORD_HEADER_SIZE + length);
+            entry.priority = body[17];
+            entry.expiryS = getUint(body + 9, 8);
+            entry.taken = false;
+            m_entries[sequence] = entry;
+            m_order.insert(OrderKey(255 - entry.priority, sequence));
+        }
+        else if ((body[0] == RECORD_TOMBSTONE) && (length == TOMBSTONE_SIZE))
+        {
+            std::map<uint64_t, Entry>::iterator it = m_entries.find(sequence);
+            if (it != m_entries.end())
+            {
+                m_order.erase(OrderKey(255 - it->second.priority, sequence));
+                m_entries.erase(it);
+            }
+        }
+        m_nextSequence = std::max(m_nextSequence, sequence + 1);
+        offset += RECORD_HEADER_SIZE + length;
+    }
+
+    Segment &info = m_segments[segment];
+    info.bytes = static_cast<uint32_t>(image.size());
+    info.live = 0;
+    m_diskBytes += image.size();
+    // Never append after a damaged tail: records written there could not be read back.
+    m_current = (offset == image.size()) ? segment : segment + 1;
+}
+
+void MqttStoreForwardQueue::erase(std::map<uint64_t, Entry>::iterator it)
+{
+    if (!it->second.taken)
+    {
+        m_order.erase(OrderKey(255 - it->second.priority, it->first));
+    }
+    std::map<uint32_t, Segment>::iterator segment = m_segments.find(it->second.segment);
+    if (segment != m_segments.end())
+    {
+        --segment->second.live;
+    }
+    m_entries.erase(it);
+}
+
+void MqttStoreForwardQueue::evictOldest(std::vector<uint32_t> &dropped)
+{
+    const uint32_t oldest = m_segments.begin()->first;
+    if (oldest == m_current)
+    {
+        // Start a new segment so the current one can go.
+        ++m_current;
+    }
+    // Sequences grow with segments, so the entries of the oldest segment come first.
+    while (!m_entries.empty() && (m_entries.begin()->second.segment == oldest))
+    {
+        // Taken messages are already in the RAM queue: they are not reported as dropped.
+        if (!m_entries.begin()->second.taken)
+        {
+            dropped.push_back(m_entries.begin()->second.messageId);
+            ++m_statistics.dropped;
+        }
+        erase(m_entries.begin());
+    }
+    m_diskBytes -= m_segments.begin()->second.bytes;
+    m_storage.remove(oldest);
+    m_segments.erase(m_segments.begin());
+}
+
+void MqttStoreForwardQueue::collect()
+{
+    // Oldest first only: a segment may hold the tombstones of messages stored in older segments.
+    while (!m_segments.empty() && (m_segments.begin()->second.live == 0)
+            && ((m_segments.begin()->first != m_current) || m_entries.empty()))
+    {
+        if (m_segments.begin()->first == m_current)
+        {
+            ++m_current;
+        }
+        m_diskBytes -= m_segments.begin()->second.bytes;
+        m_storage.remove(m_segments.begin()->first);
+        m_segments.erase(m_segments.begin());
+    }
+}
+
+void MqttStoreForwardQueue::refill(const uint64_t nowMs)
+{
+    if (nowMs > m_lastRefillMs)
+    {
+        m_tokens += static_cast<int64_t>(nowMs - m_lastRefillMs) * m_config.drain_rate_bytes_per_s;
+        m_lastRefillMs = nowMs;
+    }
+    const int64_t burst = static_cast<int64_t>(m_config.drain_burst_bytes) * 1000;
+    if (m_tokens > burst)
+    {
+        m_tokens = burst;
+    }
+}
+
+} /* namespace Connectivity */
+} /* namespace Stla */
@@ -0,0 +1,190 @@
+/**
+ * \file
+ *         MqttStoreForwardQueue.hpp
+ * \brief
+ *         Disk-backed queue of the messages published while the broker connection of a configuration item is down.
+ *
+ * \par Copyright Notice:
+ * \verbatim
+ * Copyright (c) 2021 Stellantis N.V.
+ * All Rights Reserved.
+ * The reproduction, transmission or use of this document or its contents is
+ * not permitted without express written authority.
+ * Offenders will be liable for damages. All rights, including rights created
+ * by patent grant or registration of a utility model or design, are reserved.
+ * \endverbatim
+ */
+
+#ifndef MQTTSTOREFORWARDQUEUE_H_
+#define MQTTSTOREFORWARDQUEUE_H_
+
+#include <map>
+#include <set>
+#include <vector>
+#include <cstdint>
+
+#include "IMqttPublishService.hpp"
+
+namespace Stla
+{
+namespace Connectivity
+{
+/**
+ * IMqttSegmentStorage persists the append-only segment files of a MqttStoreForwardQueue.
+ * The service implements it on top of the data storage service, one file per segment in its private namespace.
+ */
+class IMqttSegmentStorage
+{
+public:
+    virtual ~IMqttSegmentStorage()
+    {
+    }
+
+    /**
+     * @brief List the segments present in persistence, in any order.
+     */
+    virtual bool list(std::vector<uint32_t> &segments) = 0;
+
+    virtual bool load(const uint32_t segment, std::vector<unsigned char> &image) = 0;
+
+    virtual bool read(const uint32_t segment, const uint32_t offset, const uint32_t length,
+            std::vector<unsigned char> &data) = 0;
+
+    /**
+     * @brief Append data at the end of a segment, creating it if needed.
+     */
+    virtual bool append(const uint32_t segment, const std::vector<unsigned char> &data) = 0;
+
+    virtual bool remove(const uint32_t segment) = 0;
+};
+
+/**
+ * MqttStoreForwardQueue keeps the stored messages of one configuration item.
+ *
+ * Each message is appended to the current segment as a record; forwarding a message appends a tombstone
+ * record, so a message is forwarded again after a restart only if it was not acknowledged before.
+ * Segments are removed oldest first, once all their messages are forwarded, expired or dropped. Only the
+ * index of the messages is kept in RAM; topics and payloads are read back from disk when forwarded.
+ *
+ * The class is not thread-safe.
+ */
+class MqttStoreForwardQueue
+{
+public:
+    /**
+     * @brief Value returned by nextTake() when no message is waiting.
+     */
+    static const uint64_t NO_DEADLINE = UINT64_MAX;
+
+    explicit MqttStoreForwardQueue(IMqttSegmentStorage &storage);
+
+    /**
+     * @brief Rebuild the index from the segments in persistence. A segment with a damaged tail is
+     * read up to the damage and no longer appended to.
+     *
+     * Recovered messages have a message_id of 0: their publishers are gone.
+     */
+    bool open();
+
+    /**
+     * @return OK, METHOD_NOT_ALLOWED for a segment_bytes of 0 or above disk_budget_bytes / 2, or a priority above 255.
+     */
+    mqtt_conf_err_code_t setConfig(const mqtt_store_forward_config_t &config);
+
+    const mqtt_store_forward_config_t &getConfig() const;
+
+    /**
+     * @brief Append a message to disk.
+     *
+     * @param nowS current UTC time in seconds, for the TTL.
+     * @param dropped message_id of the messages dropped with the oldest segment to make room.
+     *
+     * @return OK, METHOD_NOT_ALLOWED if the message alone exceeds disk_budget_bytes, UNKNOWN_ERROR if it cannot be written.
+     */
+    mqtt_conf_err_code_t store(const mqtt_publish_message_t &message, const uint64_t nowS,
+            std::vector<uint32_t> &dropped);
+
+    /**
+     * @brief Drop the messages whose TTL is over, taken ones excepted.
+     *
+     * @param expired message_id of the dropped messages.
+     */
+    void expire(const uint64_t nowS, std::vector<uint32_t> &expired);
+
+    /**
+     * @brief Reset the drain rate: forwarding starts from an empty burst.
+     */
+    void startDrain(const uint64_t nowMs);
+
+    /**
+     * @return nowMs if take() would return a message, the time at which it will, or NO_DEADLINE.
+     */
+    uint64_t nextTake(const uint64_t nowMs);
+
+    /**
+     * @brief Read the next message to forward, highest priority first then oldest first, if the drain rate allows it.
+     * The message stays on disk until release().
+     *
+     * @param sequence_out identifier of the message in the queue, for release() / untake().
+     */
+    bool take(const uint64_t nowMs, mqtt_publish_message_t &message_out, uint64_t &sequence_out);
+
+    /**
+     * @brief Give back a taken message that could not be forwarded, e.g. the RAM queue is full.
+     */
+    void untake(const uint64_t sequence);
+
+    /**
+     * @brief Remove a taken message once it is delivered.
+     *
+     * @return false if the tombstone cannot be written; the message will then be forwarded again after a restart.
+     */
+    bool release(const uint64_t sequence);
+
+    void getStatistics(mqtt_store_forward_statistics_t &statistics_out) const;
+
+private:
+    struct Entry
+    {
+        uint32_t messageId;
+        uint32_t segment;
+        uint32_t offset;        // of the record in the segment
+        uint32_t length;        // of the record
+        unsigned int priority;
+        uint64_t expiryS;       // 0 for no expiry
+        bool taken;
+    };
+
+    struct Segment
+    {
+        uint32_t bytes;
+        uint32_t live;          // entries whose record is in this segment
+    };
+
+    typedef std::pair<unsigned int, uint64_t> OrderKey;    // (255 - priority, sequence)
+
+    void policy(const std::string &topic, unsigned int &priority, unsigned int &ttl_s) const;
+    bool append(const std::vector<unsigned char> &record, uint32_t &segment, uint32_t &offset);
+    void recover(const uint32_t segment, const std::vector<unsigned char> &image);
+    void erase(std::map<uint64_t, Entry>::iterator it);
+    void evictOldest(std::vector<uint32_t> &dropped);
+    void collect();
+    void refill(const uint64_t nowMs);
+
+    IMqttSegmentStorage &m_storage;
+    mqtt_store_forward_config_t m_config;
+    std::map<uint64_t, Entry> m_entries;       // by sequence, so by segment too
+    std::set<OrderKey> m_order;                // entries not taken
+    std::map<uint32_t, Segment> m_segments;
+    uint32_t m_current;                        // segment appended to
+    uint64_t m_nextSequence;
+    uint64_t m_diskBytes;
+    int64_t m_tokens;                          // drain budget, in bytes x 1000
+    uint64_t m_lastRefillMs;
+    mqtt_store_forward_statistics_t m_statistics;
+};
+
+} /* namespace Connectivity */
+} /* namespace Stla */
+
+#endif /* MQTTSTOREFORWARDQUEUE_H_ */
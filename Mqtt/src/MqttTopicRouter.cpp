@@ -0,0 +1,222 @@
+/**
+ * \file
+ *         MqttTopicRouter.cpp
+ * \brief
+ *         Topic tree of the subscriptions of one configuration item, matching each inbound message once.
+ *
+ * \par Copyright Notice:
+ * \verbatim
+ * Copyright (c) 2021 Stellantis N.V.
+ * All Rights Reserved.
+ * The reproduction, transmission or use of this document or its contents is
+ * not permitted without express written authority.
+ * Offenders will be liable for damages. All rights, including rights created
+ * by patent grant or registration of a utility model or design, are reserved.
+ * \endverbatim
+ */
+
+#include "MqttTopicRouter.hpp"
+
+#include <algorithm>
+
+namespace Stla
+{
+namespace Connectivity
+{
+MqttTopicRouter::MqttTopicRouter()
+{
+}
+
+bool MqttTopicRouter::validFilter(const std::string &filter)
+{
+    if (filter.empty())
+    {
+        return false;
+    }
+    std::vector<std::string> levels;
+    split(filter, levels);
+    for (size_t i = 0; i < levels.size(); ++i)
+    {
+        const std::string &level = levels[i];
+        if (level.find('#') != std::string::npos)
+        {
+            if ((level != "#") || (i + 1 != levels.size()))
+            {
+                return false;
+            }
+        }
+        else if ((level.find('+') != std::string::npos) && (level != "+"))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool MqttTopicRouter::subscribe(const SubscriberId subscriber, const std::string &filter, const unsigned int qos)
+{
+    if (!validFilter(filter))
+    {
+        return false;
+    }
+    m_filters[subscriber][filter] = qos;
+
+    std::vector<std::string> levels;
+    split(filter, levels);
+    const bool hash = (levels.back() == "#");
+    if (hash)
+    {
+        levels.pop_back();
+    }
+
+    Node *node = &m_root;
+    for (std::vector<std::string>::const_iterator it = levels.begin(); it != levels.end(); ++it)
+    {
+        std::unique_ptr<Node> &child = node->children[*it];
+        if (!child)
+        {
+            child.reset(new Node());
+        }
+        node = child.get();
+    }
+    (hash ? node->hashSubscribers : node->subscribers).insert(subscriber);
+    return true;
+}
+
+bool MqttTopicRouter::unsubscribe(const SubscriberId subscriber, const std::string &filter)
+{
+    std::map<SubscriberId, std::map<std::string, unsigned int> >::iterator it = m_filters.find(subscriber);
+    if ((it == m_filters.end()) || (it->second.erase(filter) == 0))
+    {
+        return false;
+    }
+    if (it->second.empty())
+    {
+        m_filters.erase(it);
+    }
+
+    std::vector<std::string> levels;
+    split(filter, levels);
+    remove(m_root, levels, 0, subscriber);
+    return true;
+}
+
+void MqttTopicRouter::unsubscribeAll(const SubscriberId subscriber)
+{
+    std::map<SubscriberId, std::map<std::string, unsigned int> >::iterator it = m_filters.find(subscriber);
+    if (it == m_filters.end())
+    {
+        return;
+    }
+    for (std::map<std::string, unsigned int>::const_iterator filter = it->second.begin();
+            filter != it->second.end(); ++filter)
+    {
+        std::vector<std::string> levels;
+        split(filter->first, levels);
+        remove(m_root, levels, 0, subscriber);
+    }
+    m_filters.erase(it);
+}
+
+void MqttTopicRouter::match(const std::string &topic, std::vector<SubscriberId> &subscribers) const
+{
+    subscribers.clear();
+    std::vector<std::string> levels;
+    split(topic, levels);
+    walk(m_root, levels, 0, subscribers);
+
+    // A subscriber may match through several filters.
+    std::sort(subscribers.begin(), subscribers.end());
+    subscribers.erase(std::unique(subscribers.begin(), subscribers.end()), subscribers.end());
+}
+
+void MqttTopicRouter::getFilters(std::map<std::string, unsigned int> &filters) const
+{
+    filters.clear();
+    for (std::map<SubscriberId, std::map<std::string, unsigned int> >::const_iterator it = m_filters.begin();
+            it != m_filters.end(); ++it)
+    {
+        for (std::map<std::string, unsigned int>::const_iterator filter = it->second.begin();
+                filter != it->second.end(); ++filter)
+        {
+            std::map<std::string, unsigned int>::iterator known = filters.find(filter->first);
+            if (known == filters.end())
+            {
+                filters.insert(*filter);
+            }
+            else if (filter->second > known->second)
+            {
+                known->second = filter->second;
+            }
+        }
+    }
+}
+
+void MqttTopicRouter::split(const std::string &topic, std::vector<std::string> &levels)
+{
+    size_t start = 0;
+    size_t end;
+    while ((end = topic.find('/', start)) != std::string::npos)
+    {
+        levels.push_back(topic.substr(start, end - start));
+        start = end + 1;
+    }
+    levels.push_back(topic.substr(start));
+}
+
+void MqttTopicRouter::walk(const Node &node, const std::vector<std::string> &levels, const size_t level,
+        std::vector<SubscriberId> &subscribers)
+{
+    const bool system = (level == 0) && !levels[0].empty() && (levels[0][0] == '$');
+
+    // "a/#" also matches "a", so the # subscribers of a node match at every depth below and at the node itself.
+    if (!system)
+    {
+        subscribers.insert(subscribers.end(), node.hashSubscribers.begin(), node.hashSubscribers.end());
+    }
+    if (level == levels.size())
+    {
+        subscribers.insert(subscribers.end(), node.subscribers.begin(), node.subscribers.end());
+        return;
+    }
+
+    std::map<std::string, std::unique_ptr<Node> >::const_iterator child = node.children.find(levels[level]);
+    if (child != node.children.end())
+    {
+        walk(*child->second, levels, level + 1, subscribers);
+    }
+    if (!system && (levels[level] != "+"))
+    {
+        child = node.children.find("+");
+        if (child != node.children.end())
+        {
+            walk(*child->second, levels, level + 1, subscribers);
+        }
+    }
+}
+
+bool MqttTopicRouter::remove(Node &node, const std::vector<std::string> &levels, const size_t level,
+        const SubscriberId subscriber)
+{
+    if ((level + 1 == levels.size()) && (levels[level] == "#"))
+    {
+        node.hashSubscribers.erase(subscriber);
+    }
+    else if (level == levels.size())
+    {
+        node.subscribers.erase(subscriber);
+    }
+    else
+    {
+        std::map<std::string, std::unique_ptr<Node> >::iterator child = node.children.find(levels[level]);
+        if ((child != node.children.end()) && remove(*child->second, levels, level + 1, subscriber))
+        {
+            node.children.erase(child);
+        }
+    }
+    // Tell the parent whether this node can be pruned.
+    return node.children.empty() && node.subscribers.empty() && node.hashSubscribers.empty();
+}
+
+} /* namespace Connectivity */
+} /* namespace Stla */
@@ -0,0 +1,99 @@
+/**
+ * \file
+ *         MqttTopicRouter.hpp
+ * \brief
+ *         Topic tree of the subscriptions of one configuration item, matching each inbound message once.
+ *
+ * \par Copyright Notice:
+ * \verbatim
+ * Copyright (c) 2021 Stellantis N.V.
+ * All Rights Reserved.
+ * The reproduction, transmission or use of this document or its contents is
+ * not permitted without express written authority.
+ * Offenders will be liable for damages. All rights, including rights created
+ * by patent grant or registration of a utility model or design, are reserved.
+ * \endverbatim
+ */
+
+#ifndef MQTTTOPICROUTER_H_
+#define MQTTTOPICROUTER_H_
+
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace Stla
+{
+namespace Connectivity
+{
+/**
+ * MqttTopicRouter compiles the topic filters of all the subscribers of a configuration item into one tree,
+ * one node per topic level. A message is matched by walking the tree once along its topic levels, following
+ * the exact level and the + child at each step; # subscriptions are held by the node of their parent level.
+ * The cost depends on the topic depth and the number of wildcard branches, not on the number of subscribers.
+ *
+ * Topics starting with $ are not matched by a wildcard in the first level, as required by MQTT.
+ *
+ * The class is not thread-safe.
+ */
+class MqttTopicRouter
+{
+public:
+    typedef uint32_t SubscriberId;
+
+    MqttTopicRouter();
+
+    /**
+     * @brief true for a non-empty filter whose + and # wildcards each fill a whole level, # being last.
+     */
+    static bool validFilter(const std::string &filter);
+
+    /**
+     * @brief Add a subscription, or update its QoS.
+     *
+     * @return false for an invalid filter.
+     */
+    bool subscribe(const SubscriberId subscriber, const std::string &filter, const unsigned int qos);
+
+    /**
+     * @return false if the subscriber is not subscribed to the filter.
+     */
+    bool unsubscribe(const SubscriberId subscriber, const std::string &filter);
+
+    void unsubscribeAll(const SubscriberId subscriber);
+
+    /**
+     * @brief Subscribers with at least one filter matching a topic, sorted, each once.
+     */
+    void match(const std::string &topic, std::vector<SubscriberId> &subscribers) const;
+
+    /**
+     * @brief Distinct filters of all the subscribers, with the highest QoS requested, to subscribe on the broker.
+     */
+    void getFilters(std::map<std::string, unsigned int> &filters) const;
+
+private:
+    struct Node
+    {
+        std::map<std::string, std::unique_ptr<Node> > children;   // including "+"
+        std::set<SubscriberId> subscribers;         // filter ending at this level
+        std::set<SubscriberId> hashSubscribers;     // filter ending with # after this level
+    };
+
+    static void split(const std::string &topic, std::vector<std::string> &levels);
+    static void walk(const Node &node, const std::vector<std::string> &levels, const size_t level,
+            std::vector<SubscriberId> &subscribers);
+    static bool remove(Node &node, const std::vector<std::string> &levels, const size_t level,
+            const SubscriberId subscriber);
+
+    Node m_root;
+    std::map<SubscriberId, std::map<std::string, unsigned int> > m_filters;    // by subscriber, with QoS
+};
+
+} /* namespace Connectivity */
+} /* namespace Stla */
+
+#endif /* MQTTTOPICROUTER_H_ */
@@ -0,0 +1,662 @@
+/**
+ * \file
+ *         MqttBrokerStandIn.cpp
+ * \brief
+ *         MQTT publish service connected to an in-process broker stand-in, for benchmarks on a X86 PC target
+ *
+ * \par Copyright Notice:
+ * \verbatim
+ * Copyright (c) 2021 Stellantis N.V.
+ * All Rights Reserved.
+ * The reproduction, transmission or use of this document or its contents is
+ * not permitted without express written authority.
+ * Offenders will be liable for damages. All rights, including rights created
+ * by patent grant or registration of a utility model or design, are reserved.
+ * \endverbatim
+ */
+
+#include "MqttBrokerStandIn.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+
+namespace Stla
+{
+namespace Connectivity
+{
+namespace
+{
+const char ACK_DELAY_KEY[] = "standin_ack_delay_ms";
+const char LINK_RATE_KEY[] = "standin_link_bytes_per_s";
+
+bool parseParameter(const mqtt_conf_item_t &item, const std::string &key, unsigned int &value)
+{
+    value = 0;
+    for (size_t i = 0; i < item.parameters.size(); ++i)
+    {
+        if (item.parameters[i].first != key)
+        {
+            continue;
+        }
+        const std::string &text = item.parameters[i].second;
+        if (text.empty() || (text.find_first_not_of("0123456789") != std::string::npos) || (text.size() > 9))
+        {
+            return false;
+        }
+        value = static_cast<unsigned int>(std::strtoul(text.c_str(), nullptr, 10));
+    }
+    return true;
+}
+} // namespace
+
+/**
+ * Configuration handler given to the applications. It forwards to the stand-in until the stand-in is destroyed.
+ */
+class MqttBrokerStandIn::ConfHandler : public IMqttConfHandler
+{
+public:
+    explicit ConfHandler(MqttBrokerStandIn *broker) :
+            m_broker(broker)
+    {
+    }
+
+    void detach()
+    {
+        m_broker = nullptr;
+    }
+
+    virtual mqtt_conf_err_code_t getAdkMode(bool &adk_mode_out)
+    {
+        return (m_broker != nullptr) ? m_broker->getAdkMode(adk_mode_out) : BROKER_NOT_AVAILABLE;
+    }
+
+    virtual mqtt_conf_err_code_t setAdkMode(bool adk_mode)
+    {
+        return (m_broker != nullptr) ? m_broker->setAdkMode(adk_mode) : BROKER_NOT_AVAILABLE;
+    }
+
+    virtual mqtt_conf_err_code_t getIndexList(std::vector<unsigned int> &indexes_out)
+    {
+        return (m_broker != nullptr) ? m_broker->getIndexList(indexes_out) : BROKER_NOT_AVAILABLE;
+    }
+
+    virtual mqtt_conf_err_code_t getItem(unsigned int index, std::string &config_out)
+    {
+        return (m_broker != nullptr) ? m_broker->getItem(index, config_out) : BROKER_NOT_AVAILABLE;
+    }
+
+    virtual mqtt_conf_err_code_t getParsedItem(unsigned int index, mqtt_conf_item_t &item_out)
+    {
+        return (m_broker != nullptr) ? m_broker->getParsedItem(index, item_out) : BROKER_NOT_AVAILABLE;
+    }
+
+    virtual mqtt_conf_err_code_t getItemVersion(unsigned int index, unsigned int &version_out)
+    {
+        return (m_broker != nullptr) ? m_broker->getItemVersion(index, version_out) : BROKER_NOT_AVAILABLE;
+    }
+
+    virtual mqtt_conf_err_code_t setItem(unsigned int index, const std::string config)
+    {
+        return (m_broker != nullptr) ? m_broker->setItem(index, config) : BROKER_NOT_AVAILABLE;
+    }
+
+    virtual mqtt_conf_err_code_t deleteItem(unsigned int index)
+    {
+        return (m_broker != nullptr) ? m_broker->deleteItem(index) : BROKER_NOT_AVAILABLE;
+    }
+
+private:
+    MqttBrokerStandIn *m_broker;
+};
+
+/**
+ * Publisher given to an application. It forwards to the stand-in until its configuration item is deleted or the
+ * stand-in is destroyed.
+ */
+class MqttBrokerStandIn::Publisher : public IMqttPublisher
+{
+public:
+    Publisher(MqttBrokerStandIn *broker, unsigned int index) :
+            m_broker(broker), m_index(index)
+    {
+    }
+
+    void detach()
+    {
+        m_broker = nullptr;
+    }
+
+    virtual unsigned int getIndex() const
+    {
+        return m_index;
+    }
+
+    virtual mqtt_conf_err_code_t publish(const mqtt_publish_message_t &message, uint32_t &message_id_out)
+    {
+        return (m_broker != nullptr) ? m_broker->publish(this, message, message_id_out) : BROKER_NOT_AVAILABLE;
+    }
+
+    virtual mqtt_conf_err_code_t getStatistics(mqtt_publish_statistics_t &statistics_out)
+    {
+        return (m_broker != nullptr) ? m_broker->getStatistics(m_index, statistics_out) : BROKER_NOT_AVAILABLE;
+    }
+
+private:
+    MqttBrokerStandIn *m_broker;
+    const unsigned int m_index;
+};
+
+/**
+ * Subscriber given to an application. It forwards to the stand-in until its configuration item is deleted or the
+ * stand-in is destroyed.
+ */
+class MqttBrokerStandIn::Subscriber : public IMqttSubscriber
+{
+public:
+    Subscriber(MqttBrokerStandIn *broker, unsigned int index, MqttTopicRouter::SubscriberId id) :
+            m_broker(broker), m_index(index), m_id(id)
+    {
+    }
+
+    void detach()
+    {
+        m_broker = nullptr;
+    }
+
+    MqttTopicRouter::SubscriberId getId() const
+    {
+        return m_id;
+    }
+
+    virtual unsigned int getIndex() const
+    {
+        return m_index;
+    }
+
+    virtual mqtt_conf_err_code_t subscribe(const std::string &topic_filter, unsigned int qos)
+    {
+        return (m_broker != nullptr) ? m_broker->subscribe(this, topic_filter, qos) : BROKER_NOT_AVAILABLE;
+    }
+
+    virtual mqtt_conf_err_code_t unsubscribe(const std::string &topic_filter)
+    {
+        return (m_broker != nullptr) ? m_broker->unsubscribe(this, topic_filter) : BROKER_NOT_AVAILABLE;
+    }
+
+private:
+    MqttBrokerStandIn *m_broker;
+    const unsigned int m_index;
+    const MqttTopicRouter::SubscriberId m_id;
+};
+
+const uint64_t MqttBrokerStandIn::NO_DEADLINE;
+
+MqttBrokerStandIn::Connection::Connection() :
+        storeForward(), ackDelayMs(0), linkBytesPerS(0), linkFreeUs(0), batchDeadline(NO_DEADLINE)
+{
+}
+
+MqttBrokerStandIn::MqttBrokerStandIn() :
+        m_confHandler(new ConfHandler(this)), m_adkMode(true), m_lastSubscriberId(0)
+{
+}
+
+MqttBrokerStandIn::~MqttBrokerStandIn()
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    m_confHandler->detach();
+    while (!m_connections.empty())
+    {
+        close(m_connections.begin()->first);
+    }
+}
+
+IMqttConfHandler::Ptr MqttBrokerStandIn::getMqttConfHandler(Poco::OSP::BundleContext::Ptr pAppBndlContext)
+{
+    (void) pAppBndlContext;
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    return IMqttConfHandler::Ptr(m_confHandler.get(), true);
+}
+
+uint64_t MqttBrokerStandIn::poll()
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    const uint64_t now = nowUs();
+    std::vector<unsigned int> indexes;
+    for (std::map<unsigned int, Connection>::const_iterator it = m_connections.begin(); it != m_connections.end(); ++it)
+    {
+        indexes.push_back(it->first);
+    }
+    // A delegate may delete a configuration item: each connection is looked up again before running it.
+    for (size_t i = 0; i < indexes.size(); ++i)
+    {
+        runConnection(indexes[i], now);
+    }
+
+    uint64_t next = NO_DEADLINE;
+    for (std::map<unsigned int, Connection>::const_iterator it = m_connections.begin(); it != m_connections.end(); ++it)
+    {
+        next = std::min(next, it->second.batchDeadline);
+        if (!it->second.acks.empty())
+        {
+            next = std::min(next, it->second.acks.front().dueUs);
+        }
+    }
+    return next;
+}
+
+uint64_t MqttBrokerStandIn::nowUs()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+mqtt_conf_err_code_t MqttBrokerStandIn::getMqttPublisher(Poco::OSP::BundleContext::Ptr pAppBndlContext,
+        unsigned int index, IMqttPublisher::Ptr &publisher_out)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    Connection *connection = find(index);
+    if (connection == nullptr)
+    {
+        return check(index);
+    }
+    Poco::AutoPtr<Publisher> &publisher = connection->publishers[pAppBndlContext.get()];
+    if (publisher.isNull())
+    {
+        publisher = new Publisher(this, index);
+    }
+    publisher_out = IMqttPublisher::Ptr(publisher.get(), true);
+    return OK;
+}
+
+mqtt_conf_err_code_t MqttBrokerStandIn::getMqttSubscriber(Poco::OSP::BundleContext::Ptr pAppBndlContext,
+        unsigned int index, IMqttSubscriber::Ptr &subscriber_out)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    Connection *connection = find(index);
+    if (connection == nullptr)
+    {
+        return check(index);
+    }
+    Poco::AutoPtr<Subscriber> &subscriber = connection->subscribers[pAppBndlContext.get()];
+    if (subscriber.isNull())
+    {
+        subscriber = new Subscriber(this, index, ++m_lastSubscriberId);
+        connection->routed[subscriber->getId()] = subscriber;
+    }
+    subscriber_out = IMqttSubscriber::Ptr(subscriber.get(), true);
+    return OK;
+}
+
+mqtt_conf_err_code_t MqttBrokerStandIn::setPublishConfig(unsigned int index, const mqtt_publish_config_t &config)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    Connection *connection = find(index);
+    if (connection == nullptr)
+    {
+        return check(index);
+    }
+    const mqtt_conf_err_code_t result = connection->queue.setConfig(config);
+    connection->batchDeadline = 0;  // a smaller batch may be ready
+    return result;
+}
+
+mqtt_conf_err_code_t MqttBrokerStandIn::getPublishConfig(unsigned int index, mqtt_publish_config_t &config_out)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    Connection *connection = find(index);
+    if (connection == nullptr)
+    {
+        return check(index);
+    }
+    config_out = connection->queue.getConfig();
+    return OK;
+}
+
+mqtt_conf_err_code_t MqttBrokerStandIn::setStoreForwardConfig(unsigned int index,
+        const mqtt_store_forward_config_t &config)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    Connection *connection = find(index);
+    if (connection == nullptr)
+    {
+        return check(index);
+    }
+    if (config.enabled && ((config.segment_bytes == 0) || (config.segment_bytes > config.disk_budget_bytes / 2)))
+    {
+        return METHOD_NOT_ALLOWED;
+    }
+    for (size_t i = 0; i < config.topic_policies.size(); ++i)
+    {
+        if ((config.topic_policies[i].priority > 255)
+                || !MqttTopicRouter::validFilter(config.topic_policies[i].topic_filter))
+        {
+            return METHOD_NOT_ALLOWED;
+        }
+    }
+    connection->storeForward = config;
+    return OK;
+}
+
+mqtt_conf_err_code_t MqttBrokerStandIn::getStoreForwardConfig(unsigned int index,
+        mqtt_store_forward_config_t &config_out)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    Connection *connection = find(index);
+    if (connection == nullptr)
+    {
+        return check(index);
+    }
+    config_out = connection->storeForward;
+    return OK;
+}
+
+mqtt_conf_err_code_t MqttBrokerStandIn::getStoreForwardStatistics(unsigned int index,
+        mqtt_store_forward_statistics_t &statistics_out)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    if (find(index) == nullptr)
+    {
+        return check(index);
+    }
+    statistics_out = mqtt_store_forward_statistics_t();
+    return OK;
+}
+
+mqtt_conf_err_code_t MqttBrokerStandIn::resetPublishStatistics(unsigned int index)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    Connection *connection = find(index);
+    if (connection == nullptr)
+    {
+        return check(index);
+    }
+    connection->queue.resetStatistics();
+    return OK;
+}
+
+MqttBrokerStandIn::Connection *MqttBrokerStandIn::find(unsigned int index)
+{
+    std::map<unsigned int, Connection>::iterator it = m_connections.find(index);
+    return (it != m_connections.end()) ? &it->second : nullptr;
+}
+
+mqtt_conf_err_code_t MqttBrokerStandIn::check(unsigned int index) const
+{
+    return (index < MAX_CONF_ITEM) ? ID_UNUSED : ID_INVALID;
+}
+
+void MqttBrokerStandIn::runConnection(unsigned int index, const uint64_t now)
+{
+    Connection *connection = find(index);
+    if (connection == nullptr)
+    {
+        return;
+    }
+    const uint64_t nowMs = now / 1000;
+
+    // Acknowledgements first: they free room in the in-flight window for the next batch.
+    std::vector<std::pair<Poco::AutoPtr<Publisher>, mqtt_publish_result_t> > results;
+    while (!connection->acks.empty() && (connection->acks.front().dueUs <= now))
+    {
+        mqtt_publish_result_t result;
+        if (connection->queue.acknowledge(connection->acks.front().messageId, nowMs, result))
+        {
+            std::map<uint32_t, Poco::AutoPtr<Publisher> >::iterator owner = connection->owners.find(result.message_id);
+            if (owner != connection->owners.end())
+            {
+                results.push_back(std::make_pair(owner->second, result));
+                connection->owners.erase(owner);
+            }
+            connection->batchDeadline = 0;
+        }
+        connection->acks.pop_front();
+    }
+
+    std::vector<mqtt_publish_message_t> batch;
+    while ((connection->batchDeadline <= now) && (connection->linkFreeUs <= now))
+    {
+        const size_t first = batch.size();
+        std::vector<mqtt_publish_result_t> completed;
+        const uint64_t next = connection->queue.takeBatch(nowMs, batch, completed);
+        connection->batchDeadline = (next == MqttPublishQueue::NO_DEADLINE) ? NO_DEADLINE : next * 1000;
+
+        uint64_t written = std::max(connection->linkFreeUs, now);
+        for (size_t i = first; i < batch.size(); ++i)
+        {
+            if (connection->linkBytesPerS != 0)
+            {
+                written += (batch[i].payload.size() * 1000000ULL) / connection->linkBytesPerS;
+            }
+            if (batch[i].qos == 1)
+            {
+                PendingAck ack;
+                ack.dueUs = written + connection->ackDelayMs * 1000ULL;
+                ack.messageId = batch[i].message_id;
+                connection->acks.push_back(ack);
+            }
+        }
+        connection->linkFreeUs = written;
+        for (size_t i = 0; i < completed.size(); ++i)
+        {
+            std::map<uint32_t, Poco::AutoPtr<Publisher> >::iterator owner =
+                    connection->owners.find(completed[i].message_id);
+            if (owner != connection->owners.end())
+            {
+                results.push_back(std::make_pair(owner->second, completed[i]));
+                connection->owners.erase(owner);
+            }
+        }
+        if (batch.size() == first)
+        {
+            break;
+        }
+    }
+    if ((connection->batchDeadline != NO_DEADLINE) && (connection->batchDeadline < connection->linkFreeUs))
+    {
+        connection->batchDeadline = connection->linkFreeUs;
+    }
+
+    // The broker loops the written messages back to the matching subscribers; all receive the same buffer.
+    std::vector<std::pair<Poco::AutoPtr<Subscriber>, mqtt_inbound_message_t> > inbound;
+    for (size_t i = 0; i < batch.size(); ++i)
+    {
+        std::vector<MqttTopicRouter::SubscriberId> matched;
+        connection->router.match(batch[i].topic, matched);
+        if (matched.empty())
+        {
+            continue;
+        }
+        mqtt_inbound_message_t message;
+        message.topic = batch[i].topic;
+        message.payload = Poco::SharedPtr<const std::string>(new std::string(batch[i].payload));
+        message.qos = batch[i].qos;
+        message.retain = false;
+        for (size_t j = 0; j < matched.size(); ++j)
+        {
+            inbound.push_back(std::make_pair(connection->routed[matched[j]], message));
+        }
+    }
+
+    std::vector<Poco::AutoPtr<Publisher> > writable;
+    if (connection->queue.takeWritable())
+    {
+        for (std::map<const Poco::OSP::BundleContext *, Poco::AutoPtr<Publisher> >::const_iterator it =
+                connection->publishers.begin(); it != connection->publishers.end(); ++it)
+        {
+            writable.push_back(it->second);
+        }
+    }
+
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        results[i].first->event_PublishCompleted.notify(this, results[i].second);
+    }
+    for (size_t i = 0; i < inbound.size(); ++i)
+    {
+        inbound[i].first->event_MessageReceived.notify(this, inbound[i].second);
+    }
+    for (size_t i = 0; i < writable.size(); ++i)
+    {
+        writable[i]->event_Writable.notify(this, index);
+    }
+}
+
+void MqttBrokerStandIn::close(unsigned int index)
+{
+    Connection *connection = find(index);
+    if (connection == nullptr)
+    {
+        return;
+    }
+    for (std::map<const Poco::OSP::BundleContext *, Poco::AutoPtr<Publisher> >::iterator it =
+            connection->publishers.begin(); it != connection->publishers.end(); ++it)
+    {
+        it->second->detach();
+    }
+    for (std::map<const Poco::OSP::BundleContext *, Poco::AutoPtr<Subscriber> >::iterator it =
+            connection->subscribers.begin(); it != connection->subscribers.end(); ++it)
+    {
+        it->second->detach();
+    }
+    m_connections.erase(index);
+}
+
+mqtt_conf_err_code_t MqttBrokerStandIn::getAdkMode(bool &adk_mode_out)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    adk_mode_out = m_adkMode;
+    return OK;
+}
+
+mqtt_conf_err_code_t MqttBrokerStandIn::setAdkMode(bool adk_mode)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    if (adk_mode != m_adkMode)
+    {
+        m_adkMode = adk_mode;
+        m_items.clear();
+        while (!m_connections.empty())
+        {
+            close(m_connections.begin()->first);
+        }
+    }
+    return OK;
+}
+
+mqtt_conf_err_code_t MqttBrokerStandIn::getIndexList(std::vector<unsigned int> &indexes_out)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    m_items.getIndexList(indexes_out);
+    return OK;
+}
+
+mqtt_conf_err_code_t MqttBrokerStandIn::getItem(unsigned int index, std::string &config_out)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    return m_items.getRaw(index, config_out);
+}
+
+mqtt_conf_err_code_t MqttBrokerStandIn::getParsedItem(unsigned int index, mqtt_conf_item_t &item_out)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    return m_items.getParsed(index, item_out);
+}
+
+mqtt_conf_err_code_t MqttBrokerStandIn::getItemVersion(unsigned int index, unsigned int &version_out)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    return m_items.getVersion(index, version_out);
+}
+
+mqtt_conf_err_code_t MqttBrokerStandIn::setItem(unsigned int index, const std::string &config)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    mqtt_conf_item_t item;
+    std::string error;
+    unsigned int ackDelayMs = 0;
+    unsigned int linkBytesPerS = 0;
+    if (MqttConfItemCache::parse(config, item, error)
+            && (!parseParameter(item, ACK_DELAY_KEY, ackDelayMs) || !parseParameter(item, LINK_RATE_KEY, linkBytesPerS)))
+    {
+        return CONF_INVALID;
+    }
+    const mqtt_conf_err_code_t result = m_items.set(index, config);
+    if (result != OK)
+    {
+        return result;
+    }
+    Connection &connection = m_connections[index];
+    connection.ackDelayMs = ackDelayMs;
+    connection.linkBytesPerS = linkBytesPerS;
+    return OK;
+}
+
+mqtt_conf_err_code_t MqttBrokerStandIn::deleteItem(unsigned int index)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    const mqtt_conf_err_code_t result = m_items.remove(index);
+    if (result == OK)
+    {
+        close(index);
+    }
+    return result;
+}
+
+mqtt_conf_err_code_t MqttBrokerStandIn::publish(Publisher *publisher, const mqtt_publish_message_t &message,
+        uint32_t &message_id_out)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    Connection *connection = find(publisher->getIndex());
+    if (connection == nullptr)
+    {
+        return BROKER_NOT_AVAILABLE;
+    }
+    const mqtt_conf_err_code_t result = connection->queue.enqueue(message, nowUs() / 1000, message_id_out);
+    if (result == OK)
+    {
+        connection->owners[message_id_out] = Poco::AutoPtr<Publisher>(publisher, true);
+        connection->batchDeadline = 0;
+    }
+    return result;
+}
+
+mqtt_conf_err_code_t MqttBrokerStandIn::getStatistics(unsigned int index, mqtt_publish_statistics_t &statistics_out)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    Connection *connection = find(index);
+    if (connection == nullptr)
+    {
+        return BROKER_NOT_AVAILABLE;
+    }
+    connection->queue.getStatistics(statistics_out);
+    return OK;
+}
+
+mqtt_conf_err_code_t MqttBrokerStandIn::subscribe(Subscriber *subscriber, const std::string &topic_filter,
+        unsigned int qos)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    Connection *connection = find(subscriber->getIndex());
+    if (connection == nullptr)
+    {
+        return BROKER_NOT_AVAILABLE;
+    }
+    return ((qos <= 2) && connection->router.subscribe(subscriber->getId(), topic_filter, qos)) ? OK
+            : METHOD_NOT_ALLOWED;
+}
+
+mqtt_conf_err_code_t MqttBrokerStandIn::unsubscribe(Subscriber *subscriber, const std::string &topic_filter)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    Connection *connection = find(subscriber->getIndex());
+    if (connection == nullptr)
+    {
+        return BROKER_NOT_AVAILABLE;
+    }
+    return connection->router.unsubscribe(subscriber->getId(), topic_filter) ? OK : ID_UNUSED;
+}
+
+} /* namespace Connectivity */
+} /* namespace Stla */
@@ -0,0 +1,161 @@
+/**
+ * \file
+ *         MqttBrokerStandIn.hpp
+ * \brief
+ *         MQTT publish service connected to an in-process broker stand-in, for benchmarks on a X86 PC target
+ *
+ * \par Copyright Notice:
+ * \verbatim
+ * Copyright (c) 2021 Stellantis N.V.
+ * All Rights Reserved.
+ * The reproduction, transmission or use of this document or its contents is
+ * not permitted without express written authority.
+ * Offenders will be liable for damages. All rights, including rights created
+ * by patent grant or registration of a utility model or design, are reserved.
+ * \endverbatim
+ */
+
+#ifndef MQTTBROKERSTANDIN_H_
+#define MQTTBROKERSTANDIN_H_
+
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "IMqttConfService.hpp"
+#include "IMqttPublishService.hpp"
+#include "MqttConfItemCache.hpp"
+#include "MqttPublishQueue.hpp"
+#include "MqttTopicRouter.hpp"
+
+namespace Stla
+{
+namespace Connectivity
+{
+/**
+ * MqttBrokerStandIn implements IMqttPublishService with the publish queue and topic router of the service, on
+ * connections to a broker simulated in the same process. Configuration items are set through the IMqttConfHandler
+ * returned by getMqttConfHandler(): each item opens one connection, with these stand-in lines besides the mosquitto
+ * ones (the parsed bridges are not used):
+ * - standin_ack_delay_ms: time the broker takes to acknowledge a QoS 1 message once it is written, default 0.
+ * - standin_link_bytes_per_s: payload throughput of the link, 0 (default) for no limit. A batch is only taken from
+ *   the queue once the link has written the previous one.
+ *
+ * The broker delivers each written message to the subscribers of the same configuration item whose filters match it,
+ * as the broker loops back the messages of a client to its own subscriptions.
+ *
+ * The connections never drop: the store-and-forward settings are kept but no message is stored.
+ *
+ * poll() writes the batches and delivers the acknowledgements due; call it when the deadline it returns is reached,
+ * and after publish(). Events are notified from poll(), with the stand-in locked: a delegate may call the stand-in
+ * back from the notifying thread, not wait for another thread doing so.
+ */
+class MqttBrokerStandIn : public IMqttPublishService
+{
+public:
+    typedef Poco::AutoPtr<MqttBrokerStandIn> Ptr;
+
+    static const uint64_t NO_DEADLINE = UINT64_MAX;
+
+    MqttBrokerStandIn();
+    virtual ~MqttBrokerStandIn();
+
+    /**
+     * @brief Configuration handler of the stand-in, the same for all bundle contexts. setItem() opens or updates the
+     * connection of the item, deleteItem() closes it: its queued and in-flight messages are dropped without result.
+     */
+    IMqttConfHandler::Ptr getMqttConfHandler(Poco::OSP::BundleContext::Ptr pAppBndlContext);
+
+    /**
+     * @brief Write the batches and deliver the acknowledgements due now.
+     *
+     * @return the next deadline on the monotonic clock in microseconds (see nowUs()), or NO_DEADLINE.
+     */
+    uint64_t poll();
+
+    /**
+     * @brief Monotonic clock of the stand-in, in microseconds.
+     */
+    static uint64_t nowUs();
+
+    // IMqttPublishService
+    virtual mqtt_conf_err_code_t getMqttPublisher(Poco::OSP::BundleContext::Ptr pAppBndlContext, unsigned int index,
+            IMqttPublisher::Ptr &publisher_out);
+    virtual mqtt_conf_err_code_t getMqttSubscriber(Poco::OSP::BundleContext::Ptr pAppBndlContext, unsigned int index,
+            IMqttSubscriber::Ptr &subscriber_out);
+    virtual mqtt_conf_err_code_t setPublishConfig(unsigned int index, const mqtt_publish_config_t &config);
+    virtual mqtt_conf_err_code_t getPublishConfig(unsigned int index, mqtt_publish_config_t &config_out);
+    virtual mqtt_conf_err_code_t setStoreForwardConfig(unsigned int index, const mqtt_store_forward_config_t &config);
+    virtual mqtt_conf_err_code_t getStoreForwardConfig(unsigned int index, mqtt_store_forward_config_t &config_out);
+    virtual mqtt_conf_err_code_t getStoreForwardStatistics(unsigned int index,
+            mqtt_store_forward_statistics_t &statistics_out);
+    virtual mqtt_conf_err_code_t resetPublishStatistics(unsigned int index);
+
+private:
+    class ConfHandler;
+    class Publisher;
+    class Subscriber;
+
+    struct PendingAck
+    {
+        uint64_t dueUs;
+        uint32_t messageId;
+    };
+
+    struct Connection
+    {
+        Connection();
+
+        MqttPublishQueue queue;
+        MqttTopicRouter router;
+        mqtt_store_forward_config_t storeForward;
+        unsigned int ackDelayMs;
+        unsigned int linkBytesPerS;
+        uint64_t linkFreeUs;        // end of the write of the last batch
+        uint64_t batchDeadline;
+        std::deque<PendingAck> acks;    // in writing order, so by due time
+        std::map<const Poco::OSP::BundleContext *, Poco::AutoPtr<Publisher> > publishers;
+        std::map<const Poco::OSP::BundleContext *, Poco::AutoPtr<Subscriber> > subscribers;
+        std::map<MqttTopicRouter::SubscriberId, Poco::AutoPtr<Subscriber> > routed;
+        std::map<uint32_t, Poco::AutoPtr<Publisher> > owners;     // publisher of each queued or in-flight message
+    };
+
+    MqttBrokerStandIn(const MqttBrokerStandIn &);
+    MqttBrokerStandIn &operator=(const MqttBrokerStandIn &);
+
+    Connection *find(unsigned int index);
+    mqtt_conf_err_code_t check(unsigned int index) const;
+    void runConnection(unsigned int index, const uint64_t now);
+    void close(unsigned int index);
+
+    // Configuration handler
+    mqtt_conf_err_code_t getAdkMode(bool &adk_mode_out);
+    mqtt_conf_err_code_t setAdkMode(bool adk_mode);
+    mqtt_conf_err_code_t getIndexList(std::vector<unsigned int> &indexes_out);
+    mqtt_conf_err_code_t getItem(unsigned int index, std::string &config_out);
+    mqtt_conf_err_code_t getParsedItem(unsigned int index, mqtt_conf_item_t &item_out);
+    mqtt_conf_err_code_t getItemVersion(unsigned int index, unsigned int &version_out);
+    mqtt_conf_err_code_t setItem(unsigned int index, const std::string &config);
+    mqtt_conf_err_code_t deleteItem(unsigned int index);
+
+    // Publishers and subscribers
+    mqtt_conf_err_code_t publish(Publisher *publisher, const mqtt_publish_message_t &message, uint32_t &message_id_out);
+    mqtt_conf_err_code_t getStatistics(unsigned int index, mqtt_publish_statistics_t &statistics_out);
+    mqtt_conf_err_code_t subscribe(Subscriber *subscriber, const std::string &topic_filter, unsigned int qos);
+    mqtt_conf_err_code_t unsubscribe(Subscriber *subscriber, const std::string &topic_filter);
+
+    std::recursive_mutex m_mutex;
+    Poco::AutoPtr<ConfHandler> m_confHandler;
+    bool m_adkMode;
+    MqttConfItemCache m_items;
+    std::map<unsigned int, Connection> m_connections;
+    MqttTopicRouter::SubscriberId m_lastSubscriberId;
+};
+
+} /* namespace Connectivity */
+} /* namespace Stla */
+
+#endif /* MQTTBROKERSTANDIN_H_ */
@@ -0,0 +1,220 @@
+/**
+ * \file
+ *         MqttPublishBenchmark.cpp
+ * \brief
+ *         Publish throughput and latency benchmark against MqttBrokerStandIn, for benchmarks on a X86 PC target
+ *
+ * \par Copyright Notice:
+ * \verbatim
+ * Copyright (c) 2021 Stellantis N.V.
+ * All Rights Reserved.
+ * The reproduction, transmission or use of this document or its contents is
+ * not permitted without express written authority.
+ * Offenders will be liable for damages. All rights, including rights created
+ * by patent grant or registration of a utility model or design, are reserved.
+ * \endverbatim
+ */
+
+#include "MqttPublishBenchmark.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+#include <thread>
+
+#include <Poco/Delegate.h>
+
+namespace Stla
+{
+namespace Connectivity
+{
+const unsigned int MqttPublishBenchmark::INDEX;
+
+const char *const MqttPublishBenchmark::DEFAULT_CONFIG =
+        "connection benchmark\n"
+        "address 127.0.0.1:1883\n"
+        "topic benchmark/# out 1\n"
+        "standin_ack_delay_ms 0\n"
+        "standin_link_bytes_per_s 0\n";
+
+MqttPublishBenchmark::MqttPublishBenchmark(MqttBrokerStandIn &broker) :
+        m_broker(broker), m_confHandler(broker.getMqttConfHandler(Poco::OSP::BundleContext::Ptr())), m_failed(0),
+        m_lastCompletedUs(0), m_writable(true)
+{
+}
+
+MqttPublishBenchmark::~MqttPublishBenchmark()
+{
+    release();
+}
+
+mqtt_conf_err_code_t MqttPublishBenchmark::setup(const std::string &config, const mqtt_publish_config_t &publishConfig)
+{
+    release();
+    mqtt_conf_err_code_t result = m_confHandler->setItem(INDEX, config.empty() ? std::string(DEFAULT_CONFIG) : config);
+    if (result == OK)
+    {
+        result = m_broker.setPublishConfig(INDEX, publishConfig);
+    }
+    if (result == OK)
+    {
+        result = m_broker.getMqttPublisher(Poco::OSP::BundleContext::Ptr(), INDEX, m_publisher);
+    }
+    if (result == OK)
+    {
+        m_publisher->event_PublishCompleted += Poco::delegate(this, &MqttPublishBenchmark::onPublishCompleted);
+        m_publisher->event_Writable += Poco::delegate(this, &MqttPublishBenchmark::onWritable);
+    }
+    return result;
+}
+
+mqtt_conf_err_code_t MqttPublishBenchmark::run(unsigned int payloadBytes, unsigned int qos, unsigned int messages,
+        mqtt_benchmark_result_t &result_out)
+{
+    result_out = mqtt_benchmark_result_t();
+    result_out.payload_bytes = payloadBytes;
+    result_out.qos = qos;
+    if (m_publisher.isNull())
+    {
+        return BROKER_NOT_AVAILABLE;
+    }
+
+    std::ostringstream topic;
+    topic << "benchmark/" << payloadBytes << "/qos" << qos;
+    mqtt_publish_message_t message;
+    message.message_id = 0;
+    message.topic = topic.str();
+    message.payload.assign(payloadBytes, 'x');
+    message.qos = qos;
+    message.retain = false;
+
+    m_publishedUs.clear();
+    m_latenciesUs.clear();
+    m_failed = 0;
+    m_writable = true;
+    m_broker.resetPublishStatistics(INDEX);
+
+    const uint64_t start = MqttBrokerStandIn::nowUs();
+    m_lastCompletedUs = start;
+    unsigned int sent = 0;
+    while ((sent < messages) || !m_publishedUs.empty())
+    {
+        // One publish() per poll(), as publishers feeding the connection: a burst queued at once would measure
+        // its own queueing time.
+        if ((sent < messages) && m_writable)
+        {
+            uint32_t messageId = 0;
+            const uint64_t now = MqttBrokerStandIn::nowUs();
+            const mqtt_conf_err_code_t status = m_publisher->publish(message, messageId);
+            if (status == QUEUE_FULL)
+            {
+                ++result_out.queue_full;
+                m_writable = false;
+            }
+            else if (status != OK)
+            {
+                return status;
+            }
+            else
+            {
+                m_publishedUs[messageId] = now;
+                ++sent;
+            }
+        }
+
+        const uint64_t deadline = m_broker.poll();
+        const uint64_t now = MqttBrokerStandIn::nowUs();
+        if (deadline == MqttBrokerStandIn::NO_DEADLINE)
+        {
+            m_writable = true;  // nothing left in the queue, event_Writable may not come
+        }
+        else if ((deadline > now) && ((sent == messages) || !m_writable))
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(deadline - now));
+        }
+    }
+
+    result_out.messages = sent;
+    result_out.failed = m_failed;
+    result_out.elapsed_us = m_lastCompletedUs - start;
+    const uint64_t delivered = m_latenciesUs.size();
+    if (result_out.elapsed_us != 0)
+    {
+        result_out.messages_per_s = (delivered * 1000000.0) / result_out.elapsed_us;
+        result_out.bytes_per_s = (delivered * static_cast<double>(payloadBytes) * 1000000.0) / result_out.elapsed_us;
+    }
+    if (delivered != 0)
+    {
+        std::sort(m_latenciesUs.begin(), m_latenciesUs.end());
+        uint64_t sum = 0;
+        for (size_t i = 0; i < m_latenciesUs.size(); ++i)
+        {
+            sum += m_latenciesUs[i];
+        }
+        result_out.latency_avg_us = sum / delivered;
+        result_out.latency_p99_us = m_latenciesUs[((delivered * 99) - 1) / 100];
+        result_out.latency_max_us = m_latenciesUs.back();
+    }
+    return OK;
+}
+
+mqtt_conf_err_code_t MqttPublishBenchmark::runMatrix(const std::vector<unsigned int> &payloadSizes,
+        const std::vector<unsigned int> &qosLevels, unsigned int messages,
+        std::vector<mqtt_benchmark_result_t> &results_out)
+{
+    results_out.clear();
+    for (size_t i = 0; i < payloadSizes.size(); ++i)
+    {
+        for (size_t j = 0; j < qosLevels.size(); ++j)
+        {
+            mqtt_benchmark_result_t result;
+            const mqtt_conf_err_code_t status = run(payloadSizes[i], qosLevels[j], messages, result);
+            if (status != OK)
+            {
+                return status;
+            }
+            results_out.push_back(result);
+        }
+    }
+    return OK;
+}
+
+void MqttPublishBenchmark::release()
+{
+    if (!m_publisher.isNull())
+    {
+        m_publisher->event_PublishCompleted -= Poco::delegate(this, &MqttPublishBenchmark::onPublishCompleted);
+        m_publisher->event_Writable -= Poco::delegate(this, &MqttPublishBenchmark::onWritable);
+        m_publisher = IMqttPublisher::Ptr();
+    }
+}
+
+void MqttPublishBenchmark::onPublishCompleted(const void *pSender, const mqtt_publish_result_t &result)
+{
+    (void) pSender;
+    std::map<uint32_t, uint64_t>::iterator published = m_publishedUs.find(result.message_id);
+    if (published == m_publishedUs.end())
+    {
+        return;
+    }
+    m_lastCompletedUs = MqttBrokerStandIn::nowUs();
+    if (result.delivered)
+    {
+        m_latenciesUs.push_back(m_lastCompletedUs - published->second);
+    }
+    else
+    {
+        ++m_failed;
+    }
+    m_publishedUs.erase(published);
+}
+
+void MqttPublishBenchmark::onWritable(const void *pSender, const unsigned int &index)
+{
+    (void) pSender;
+    (void) index;
+    m_writable = true;
+}
+
+} /* namespace Connectivity */
+} /* namespace Stla */
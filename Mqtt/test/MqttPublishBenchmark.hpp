@@ -0,0 +1,119 @@
+/**
+ * \file
+ *         MqttPublishBenchmark.hpp
+ * \brief
+ *         Publish throughput and latency benchmark against MqttBrokerStandIn, for benchmarks on a X86 PC target
+ *
+ * \par Copyright Notice:
+ * \verbatim
+ * Copyright (c) 2021 Stellantis N.V.
+ * All Rights Reserved.
+ * The reproduction, transmission or use of this document or its contents is
+ * not permitted without express written authority.
+ * Offenders will be liable for damages. All rights, including rights created
+ * by patent grant or registration of a utility model or design, are reserved.
+ * \endverbatim
+ */
+
+#ifndef MQTTPUBLISHBENCHMARK_H_
+#define MQTTPUBLISHBENCHMARK_H_
+
+#include <map>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "MqttBrokerStandIn.hpp"
+
+namespace Stla
+{
+namespace Connectivity
+{
+/**
+ * @brief Result of one benchmark run, for one payload size and QoS level.
+ */
+typedef struct mqtt_benchmark_result
+{
+    unsigned int payload_bytes;
+    unsigned int qos;
+    uint64_t messages;          /**< messages accepted by publish() */
+    uint64_t failed;            /**< messages completed with delivered = false */
+    uint64_t queue_full;        /**< publish() calls that returned QUEUE_FULL, retried on event_Writable */
+    uint64_t elapsed_us;        /**< from the first publish() to the last completion */
+    double messages_per_s;      /**< delivered messages */
+    double bytes_per_s;         /**< payload bytes of the delivered messages */
+    uint64_t latency_avg_us;    /**< publish() to event_PublishCompleted: write for QoS 0, acknowledgement for QoS 1 */
+    uint64_t latency_p99_us;
+    uint64_t latency_max_us;
+} mqtt_benchmark_result_t;
+
+/**
+ * MqttPublishBenchmark sets a configuration item on a MqttBrokerStandIn through IMqttConfHandler::setItem, then
+ * publishes a given number of messages for each payload size and QoS level, polling the stand-in after each
+ * publish() and waiting for event_Writable after QUEUE_FULL. Latencies are measured by the benchmark itself in
+ * microseconds, from publish() to event_PublishCompleted.
+ *
+ * Runs are repeatable: the broker is simulated and the payloads do not depend on the run.
+ */
+class MqttPublishBenchmark
+{
+public:
+    static const unsigned int INDEX = 0;
+
+    /**
+     * @brief Configuration item used when setup() is given an empty configuration: one bridge, acknowledgement
+     * without delay and no link limit.
+     */
+    static const char *const DEFAULT_CONFIG;
+
+    explicit MqttPublishBenchmark(MqttBrokerStandIn &broker);
+    ~MqttPublishBenchmark();
+
+    /**
+     * @brief Set the configuration item INDEX (standin_ack_delay_ms and standin_link_bytes_per_s shape the broker,
+     * see MqttBrokerStandIn), then apply the publish pipeline settings.
+     *
+     * @return Status of the first operation which failed, OK on success.
+     */
+    mqtt_conf_err_code_t setup(const std::string &config, const mqtt_publish_config_t &publishConfig);
+
+    /**
+     * @brief Publish messages of payloadBytes bytes with a QoS, and wait for all their results.
+     *
+     * @return OK, METHOD_NOT_ALLOWED for a QoS above 1 or a payload larger than max_queued_bytes, BROKER_NOT_AVAILABLE
+     * without setup().
+     */
+    mqtt_conf_err_code_t run(unsigned int payloadBytes, unsigned int qos, unsigned int messages,
+            mqtt_benchmark_result_t &result_out);
+
+    /**
+     * @brief run() for each payload size and each QoS level, payload size first.
+     *
+     * @return Status of the first run which failed, the results of the previous runs being kept.
+     */
+    mqtt_conf_err_code_t runMatrix(const std::vector<unsigned int> &payloadSizes,
+            const std::vector<unsigned int> &qosLevels, unsigned int messages,
+            std::vector<mqtt_benchmark_result_t> &results_out);
+
+private:
+    MqttPublishBenchmark(const MqttPublishBenchmark &);
+    MqttPublishBenchmark &operator=(const MqttPublishBenchmark &);
+
+    void release();
+    void onPublishCompleted(const void *pSender, const mqtt_publish_result_t &result);
+    void onWritable(const void *pSender, const unsigned int &index);
+
+    MqttBrokerStandIn &m_broker;
+    IMqttConfHandler::Ptr m_confHandler;
+    IMqttPublisher::Ptr m_publisher;
+    std::map<uint32_t, uint64_t> m_publishedUs;     // by message_id, until completed
+    std::vector<uint64_t> m_latenciesUs;
+    uint64_t m_failed;
+    uint64_t m_lastCompletedUs;
+    bool m_writable;
+};
+
+} /* namespace Connectivity */
+} /* namespace Stla */
+
+#endif /* MQTTPUBLISHBENCHMARK_H_ */
@@ -52,6 +52,7 @@ enum WiFiServerIF_ErrorCodes
     WIFI_SERVER_RES_ERR_WIFIMGR_NOT_READY,
     WIFI_SERVER_RES_ERR_CLIENT_NOT_READY,
     WIFI_SERVER_RES_ERR_CLIENT_NOT_ENABLED,
+    WIFI_SERVER_RES_ERR_INVALID_PARAM,
 };
 
 /**
@@ -82,6 +83,17 @@ enum WiFiServerSecurity_e
     WIFI_SERVER_SECURITYLEVEL_WEP
 };
 
+/**
+ * @brief WiFiServerOffloadState_e: State of a transfer deferred to Wi-Fi
+ */
+ //@serialize
+enum WiFiServerOffloadState_e
+{
+    WIFI_SERVER_OFFLOAD_QUEUED,        /**< Waiting for a preferred Wi-Fi network */
+    WIFI_SERVER_OFFLOAD_RUNNING,       /**< To be transferred now, from offset */
+    WIFI_SERVER_OFFLOAD_PAUSED         /**< To be stopped now, resumed later from offset */
+};
+
 /**
  * @brief WiFiServerNetState_e: Type of service carried on current WiFi network connection
  */
@@ -131,6 +143,60 @@ struct WifiServerServiceList
     unsigned int services_num;
 };
 
+/**
+ * @brief WifiServerServiceListDiff: Changes of the WiFi service list between two versions, services keyed by MAC address
+ */
+struct WifiServerServiceListDiff
+{
+    unsigned int from_version;                              /*!< Version of the list the changes apply to */
+
+    unsigned int version;                                   /*!< Version of the list after the changes */
+
+    bool full_list;                                         /*!< The changes since from_version are no longer known: added holds the whole list, the previous copy must be dropped */
+
+    vector<WifiServerServiceConfig> added;                  /*!< Services not in the list at from_version, or removed and added back since */
+
+    vector<WifiServerServiceConfig> updated;                /*!< Services whose attributes changed since from_version */
+
+    vector<std::string> removed;                            /*!< MAC addresses of the services removed since from_version */
+};
+
+/**
+ * @brief WifiServerOffloadTransfer: Large transfer (logs, tracks, CAN history...) deferred until a preferred Wi-Fi network is connected
+ */
+struct WifiServerOffloadTransfer
+{
+    std::string name;                                       /*!< Name given by the client, for its own use */
+
+    unsigned long long size;                                /*!< Total size in bytes */
+
+    unsigned long long offset;                              /*!< Bytes already transferred, where the transfer starts */
+
+    unsigned int priority;                                  /*!< Higher priority transfers are started first */
+};
+
+/**
+ * @brief WifiServerOffloadStatus: State change of a transfer deferred to Wi-Fi
+ */
+struct WifiServerOffloadStatus
+{
+    unsigned int transfer_id;                               /*!< Identifier returned by queueWifiOffloadTransfer */
+
+    WiFiServerOffloadState_e state;                         /*!< New state of the transfer */
+
+    unsigned long long offset;                              /*!< Last offset reported, where a running transfer starts */
+};
+
+/**
+ * @brief WifiServerOffloadConfig: Configuration of the Wi-Fi offload of large transfers
+ */
+struct WifiServerOffloadConfig
+{
+    vector<std::string> preferred_ssids;                    /*!< Networks on which transfers are started, e.g. depot or home networks */
+
+    unsigned int max_streams;                               /*!< Transfers running in parallel */
+};
+
 /**
  * @brief WifiServerStatus: WiFi service status data
  */
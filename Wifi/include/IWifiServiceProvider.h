@@ -158,6 +158,71 @@ public:
     */
     virtual void getWifiStatus(WifiServerStatus& stWifiStatus) = 0;
 
+    /**
+    * \brief getWifiServicesVersion: Interface to request the available Wi-Fi services with the version of the list,
+    *                                to be used as starting point of getWifiServicesChanges and m_evWifiRemoteServicesDiff.
+    *
+    * \param [out] stWifiServicesList - Structure provided by client to be filled with Wi-Fi service list, ordered by MAC address.
+    * \param [out] version - Version of the list, incremented on each change.
+    * \return WiFiServerIF_ErrorCodes - WIFI_SERVER_RES_OK operation success |
+    *                                   Different than WIFI_SERVER_RES_OK an error was found while retrieving data.
+    */
+    virtual WiFiServerIF_ErrorCodes getWifiServicesVersion(WifiServerServiceList& stWifiServicesList, unsigned int& version) = 0;
+
+    /**
+    * \brief getWifiServicesChanges: Interface to request the changes of the Wi-Fi service list since a version,
+    *                                e.g. to catch up after missed m_evWifiRemoteServicesDiff events.
+    *
+    * \param [in] sinceVersion - Version of the list known by the client.
+    * \param [out] stDiff - Changes since sinceVersion. full_list is set when they are no longer known.
+    * \return WiFiServerIF_ErrorCodes - WIFI_SERVER_RES_OK operation success |
+    *                                   Different than WIFI_SERVER_RES_OK an error was found while retrieving data.
+    */
+    virtual WiFiServerIF_ErrorCodes getWifiServicesChanges(unsigned int sinceVersion, WifiServerServiceListDiff& stDiff) = 0;
+
+    /**
+    * \brief setWifiOffloadConfig: Interface to set the preferred Wi-Fi networks and the number of parallel streams
+    *                              of the Wi-Fi offload. Running transfers are paused if the current network is no
+    *                              longer preferred.
+    *
+    * \param [in] stConfig - Configuration of the Wi-Fi offload.
+    * \return WiFiServerIF_ErrorCodes - WIFI_SERVER_RES_OK operation success |
+    *                                   WIFI_SERVER_RES_ERR_INVALID_PARAM if max_streams is 0.
+    */
+    virtual WiFiServerIF_ErrorCodes setWifiOffloadConfig(const WifiServerOffloadConfig& stConfig) = 0;
+
+    /**
+    * \brief queueWifiOffloadTransfer: Interface to defer a large transfer until a preferred Wi-Fi network is connected.
+    *                                  m_evWifiOffloadStatusChanged tells when to run and when to pause it.
+    *
+    * \param [in] stTransfer - Transfer to defer.
+    * \param [out] transferId - Identifier of the transfer.
+    * \return WiFiServerIF_ErrorCodes - WIFI_SERVER_RES_OK operation success |
+    *                                   WIFI_SERVER_RES_ERR_INVALID_PARAM if offset is beyond size.
+    */
+    virtual WiFiServerIF_ErrorCodes queueWifiOffloadTransfer(const WifiServerOffloadTransfer& stTransfer, unsigned int& transferId) = 0;
+
+    /**
+    * \brief reportWifiOffloadProgress: Interface to report the bytes transferred, from which the transfer resumes
+    *                                   after a pause.
+    *
+    * \param [in] transferId - Identifier of the transfer.
+    * \param [in] offset - Bytes transferred since the start of the transfer.
+    * \return WiFiServerIF_ErrorCodes - WIFI_SERVER_RES_OK operation success |
+    *                                   WIFI_SERVER_RES_ERR_INVALID_PARAM if the transfer is unknown or offset is beyond size.
+    */
+    virtual WiFiServerIF_ErrorCodes reportWifiOffloadProgress(unsigned int transferId, unsigned long long offset) = 0;
+
+    /**
+    * \brief releaseWifiOffloadTransfer: Interface to remove a transfer when it is done or cancelled,
+    *                                    which lets the next queued one start.
+    *
+    * \param [in] transferId - Identifier of the transfer.
+    * \return WiFiServerIF_ErrorCodes - WIFI_SERVER_RES_OK operation success |
+    *                                   WIFI_SERVER_RES_ERR_INVALID_PARAM if the transfer is unknown.
+    */
+    virtual WiFiServerIF_ErrorCodes releaseWifiOffloadTransfer(unsigned int transferId) = 0;
+
     typedef Poco::AutoPtr<IWifiServiceProvider> Ptr;
 
     /**
@@ -207,6 +272,29 @@ public:
     */
     Poco::BasicEvent<void> m_evWifiRemoteServicesChanged;
 
+    /**
+    * \brief m_evWifiRemoteServicesDiff: Poco event used to notify the changes of the Wi-Fi service list,
+    * from the previous version (from_version) to the new one (version), services keyed by MAC address.
+    * It is triggered together with m_evWifiRemoteServicesChanged, only when a service is added, removed or updated.
+    * A change of rssi alone is notified when it exceeds the service hysteresis, so scans do not notify every service.
+    *
+    * \pre : Current Wi-Fi mode is client.
+    * \post : Event m_evWifiRemoteServicesDiff will notify the changes.
+    * \note Client must ensure to remove delegate during shutdown proccess. A client missing a version (from_version
+    * different from the version it knows) must call getWifiServicesChanges.
+    */
+    Poco::BasicEvent<const WifiServerServiceListDiff> m_evWifiRemoteServicesDiff;
+
+    /**
+    * \brief m_evWifiOffloadStatusChanged: Poco event used to notify the state changes of the deferred transfers.
+    * When the Wi-Fi connection state becomes WIFI_SERVER_STATE_CONNECTED on a preferred network, the queued transfers
+    * are set WIFI_SERVER_OFFLOAD_RUNNING by priority, up to max_streams at a time. On disconnection, the running ones are
+    * set WIFI_SERVER_OFFLOAD_PAUSED, and run again from the last reported offset on the next preferred connection.
+    *
+    * \note Client must ensure to remove delegate during shutdown proccess.
+    */
+    Poco::BasicEvent<const WifiServerOffloadStatus> m_evWifiOffloadStatusChanged;
+
     /**
     * \brief m_evWifiStatusChanged: Poco event used to notify the current Wi-Fi state.
     * Wi-Fi domain will use the structure WifiServerStatus to provide:
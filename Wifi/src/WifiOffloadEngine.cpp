@@ -0,0 +1,146 @@
+/**
+ * \file
+ *          WifiOffloadEngine.cpp
+ * \brief
+ *          Large transfers deferred until a preferred Wi-Fi network is connected
+ *
+ * \par Copyright Notice:
+ * \verbatim
+ * Copyright (c) 2021 Stellantis N.V.
+ * All Rights Reserved.
+ * The reproduction, transmission or use of this document or its contents is
+ * not permitted without express written authority.
+ * Offenders will be liable for damages. All rights, including rights created
+ * by patent grant or registration of a utility model or design, are reserved.
+ * \endverbatim
+ */
+
+#include "WifiOffloadEngine.h"
+
+#include <algorithm>
+
+namespace Stla {
+namespace Connectivity {
+
+namespace {
+
+typedef std::pair<unsigned int, unsigned int> Rank;     // priority, identifier
+
+/* Higher priority first, then the oldest. */
+bool before(const Rank& a, const Rank& b)
+{
+    return (a.first != b.first) ? (a.first > b.first) : (a.second < b.second);
+}
+
+}
+
+const unsigned int WifiOffloadEngine::DEFAULT_MAX_STREAMS;
+
+WifiOffloadEngine::WifiOffloadEngine(): m_nextId(1), m_connectionState(WIFI_SERVER_STATE_DISCONNECTED)
+{
+    m_config.max_streams = DEFAULT_MAX_STREAMS;
+}
+
+WiFiServerIF_ErrorCodes WifiOffloadEngine::setConfig(const WifiServerOffloadConfig& config)
+{
+    if (config.max_streams == 0)
+    {
+        return WIFI_SERVER_RES_ERR_INVALID_PARAM;
+    }
+    m_config = config;
+    return WIFI_SERVER_RES_OK;
+}
+
+WiFiServerIF_ErrorCodes WifiOffloadEngine::queue(const WifiServerOffloadTransfer& transfer, unsigned int& transferId)
+{
+    if (transfer.offset > transfer.size)
+    {
+        return WIFI_SERVER_RES_ERR_INVALID_PARAM;
+    }
+    // After a wrap of the counter, skip the ids of transfers still queued.
+    while ((m_nextId == 0) || (m_transfers.find(m_nextId) != m_transfers.end()))
+    {
+        ++m_nextId;
+    }
+    transferId = m_nextId++;
+    Transfer& entry = m_transfers[transferId];
+    entry.transfer = transfer;
+    entry.state = WIFI_SERVER_OFFLOAD_QUEUED;
+    return WIFI_SERVER_RES_OK;
+}
+
+WiFiServerIF_ErrorCodes WifiOffloadEngine::progress(unsigned int transferId, unsigned long long offset)
+{
+    std::map<unsigned int, Transfer>::iterator it = m_transfers.find(transferId);
+    if ((it == m_transfers.end()) || (offset > it->second.transfer.size))
+    {
+        return WIFI_SERVER_RES_ERR_INVALID_PARAM;
+    }
+    it->second.transfer.offset = offset;
+    return WIFI_SERVER_RES_OK;
+}
+
+WiFiServerIF_ErrorCodes WifiOffloadEngine::release(unsigned int transferId)
+{
+    return (m_transfers.erase(transferId) > 0) ? WIFI_SERVER_RES_OK : WIFI_SERVER_RES_ERR_INVALID_PARAM;
+}
+
+void WifiOffloadEngine::setConnection(WiFiServerIF_ServiceState_e state, const std::string& ssid)
+{
+    m_connectionState = state;
+    m_ssid = ssid;
+}
+
+void WifiOffloadEngine::schedule(vector<WifiServerOffloadStatus>& changes)
+{
+    changes.clear();
+    const bool preferred = onPreferredNetwork();
+
+    vector<Rank> running;
+    vector<Rank> waiting;
+    for (std::map<unsigned int, Transfer>::iterator it = m_transfers.begin(); it != m_transfers.end(); ++it)
+    {
+        const Rank rank(it->second.transfer.priority, it->first);
+        if (it->second.state == WIFI_SERVER_OFFLOAD_RUNNING)
+        {
+            running.push_back(rank);
+        }
+        else
+        {
+            waiting.push_back(rank);
+        }
+    }
+    std::sort(running.begin(), running.end(), before);
+    std::sort(waiting.begin(), waiting.end(), before);
+
+    const size_t streams = preferred ? m_config.max_streams : 0;
+    for (size_t i = streams; i < running.size(); ++i)
+    {
+        setState(running[i].second, m_transfers[running[i].second], WIFI_SERVER_OFFLOAD_PAUSED, changes);
+    }
+    for (size_t i = 0; (i < waiting.size()) && (running.size() + i < streams); ++i)
+    {
+        setState(waiting[i].second, m_transfers[waiting[i].second], WIFI_SERVER_OFFLOAD_RUNNING, changes);
+    }
+}
+
+bool WifiOffloadEngine::onPreferredNetwork() const
+{
+    return (m_connectionState == WIFI_SERVER_STATE_CONNECTED)
+        && (std::find(m_config.preferred_ssids.begin(), m_config.preferred_ssids.end(), m_ssid)
+            != m_config.preferred_ssids.end());
+}
+
+void WifiOffloadEngine::setState(unsigned int transferId, Transfer& transfer, WiFiServerOffloadState_e state,
+    vector<WifiServerOffloadStatus>& changes)
+{
+    transfer.state = state;
+    WifiServerOffloadStatus status;
+    status.transfer_id = transferId;
+    status.state = state;
+    status.offset = transfer.transfer.offset;
+    changes.push_back(status);
+}
+
+}
+}
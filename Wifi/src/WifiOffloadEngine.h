@@ -0,0 +1,99 @@
+/**
+ * \file
+ *          WifiOffloadEngine.h
+ * \brief
+ *          Large transfers deferred until a preferred Wi-Fi network is connected
+ *
+ * \par Copyright Notice:
+ * \verbatim
+ * Copyright (c) 2021 Stellantis N.V.
+ * All Rights Reserved.
+ * The reproduction, transmission or use of this document or its contents is
+ * not permitted without express written authority.
+ * Offenders will be liable for damages. All rights, including rights created
+ * by patent grant or registration of a utility model or design, are reserved.
+ * \endverbatim
+ */
+
+#ifndef WIFIOFFLOADENGINE_H
+#define WIFIOFFLOADENGINE_H
+
+#include <map>
+#include <string>
+
+#include "IWifiRemoteServiceTypes.h"
+
+namespace Stla {
+namespace Connectivity {
+
+/**
+ * WifiOffloadEngine decides which deferred transfers run.
+ *
+ * Transfers run only while the Wi-Fi client is connected to a preferred SSID, at most max_streams at a time. Free
+ * streams go to the transfers of highest priority, then the oldest. A running transfer is not interrupted by a
+ * transfer queued later, only by a disconnection or a lower max_streams (the lowest priority ones are paused first).
+ * The offset reported by the client is kept, so a paused transfer runs again from it.
+ *
+ * The service calls schedule() after each change (configuration, queue, connection state or SSID), then notifies
+ * the state changes returned. The class is not thread-safe.
+ */
+class WifiOffloadEngine
+{
+public:
+    static const unsigned int DEFAULT_MAX_STREAMS = 2;
+
+    WifiOffloadEngine();
+
+    /**
+     * @return WIFI_SERVER_RES_ERR_INVALID_PARAM if max_streams is 0.
+     */
+    WiFiServerIF_ErrorCodes setConfig(const WifiServerOffloadConfig& config);
+
+    /**
+     * @return WIFI_SERVER_RES_ERR_INVALID_PARAM if offset is beyond size.
+     */
+    WiFiServerIF_ErrorCodes queue(const WifiServerOffloadTransfer& transfer, unsigned int& transferId);
+
+    /**
+     * @return WIFI_SERVER_RES_ERR_INVALID_PARAM if the transfer is unknown or offset is beyond size.
+     */
+    WiFiServerIF_ErrorCodes progress(unsigned int transferId, unsigned long long offset);
+
+    /**
+     * @return WIFI_SERVER_RES_ERR_INVALID_PARAM if the transfer is unknown.
+     */
+    WiFiServerIF_ErrorCodes release(unsigned int transferId);
+
+    /**
+     * @brief Set the Wi-Fi client connection state, and the SSID of the connected service.
+     */
+    void setConnection(WiFiServerIF_ServiceState_e state, const std::string& ssid);
+
+    /**
+     * @brief Compute the running transfers.
+     * @param[out] changes Transfers to run or to pause
+     */
+    void schedule(vector<WifiServerOffloadStatus>& changes);
+
+private:
+    struct Transfer
+    {
+        WifiServerOffloadTransfer transfer;
+        WiFiServerOffloadState_e state;
+    };
+
+    bool onPreferredNetwork() const;
+    void setState(unsigned int transferId, Transfer& transfer, WiFiServerOffloadState_e state,
+        vector<WifiServerOffloadStatus>& changes);
+
+    WifiServerOffloadConfig m_config;
+    std::map<unsigned int, Transfer> m_transfers;
+    unsigned int m_nextId;
+    WiFiServerIF_ServiceState_e m_connectionState;
+    std::string m_ssid;
+};
+
+}
+}
+
+#endif // WIFIOFFLOADENGINE_H
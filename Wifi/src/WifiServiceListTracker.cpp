@@ -0,0 +1,187 @@
+/**
+ * \file
+ *          WifiServiceListTracker.cpp
+ * \brief
+ *          Versioned Wi-Fi service list, and changes between its versions
+ *
+ * \par Copyright Notice:
+ * \verbatim
+ * Copyright (c) 2021 Stellantis N.V.
+ * All Rights Reserved.
+ * The reproduction, transmission or use of this document or its contents is
+ * not permitted without express written authority.
+ * Offenders will be liable for damages. All rights, including rights created
+ * by patent grant or registration of a utility model or design, are reserved.
+ * \endverbatim
+ */
+
+#include "WifiServiceListTracker.h"
+
+#include <cctype>
+
+namespace Stla {
+namespace Connectivity {
+
+const size_t WifiServiceListTracker::MAX_REMOVED_SERVICES;
+const unsigned int WifiServiceListTracker::DEFAULT_RSSI_HYSTERESIS;
+
+WifiServiceListTracker::WifiServiceListTracker(unsigned int rssiHysteresis): m_rssiHysteresis(rssiHysteresis),
+    m_version(0), m_forgottenVersion(0)
+{
+}
+
+bool WifiServiceListTracker::update(const vector<WifiServerServiceConfig>& services, WifiServerServiceListDiff& diff)
+{
+    diff = WifiServerServiceListDiff();
+    diff.from_version = m_version;
+    diff.version = m_version + 1;
+    diff.full_list = false;
+
+    std::map<std::string, const WifiServerServiceConfig*> scanned;
+    for (vector<WifiServerServiceConfig>::const_iterator it = services.begin(); it != services.end(); ++it)
+    {
+        scanned[key(it->mac)] = &*it;   // the last one wins if a MAC address is reported twice
+    }
+
+    for (std::map<std::string, Service>::const_iterator it = m_services.begin(); it != m_services.end(); ++it)
+    {
+        if (scanned.find(it->first) == scanned.end())
+        {
+            diff.removed.push_back(it->second.config.mac);
+        }
+    }
+    for (std::map<std::string, const WifiServerServiceConfig*>::const_iterator it = scanned.begin();
+        it != scanned.end(); ++it)
+    {
+        const std::map<std::string, Service>::const_iterator previous = m_services.find(it->first);
+        if (previous == m_services.end())
+        {
+            diff.added.push_back(*it->second);
+        }
+        else if (changed(previous->second.config, *it->second))
+        {
+            diff.updated.push_back(*it->second);
+        }
+    }
+    if (diff.added.empty() && diff.updated.empty() && diff.removed.empty())
+    {
+        diff.version = m_version;
+        return false;
+    }
+
+    ++m_version;
+    for (vector<std::string>::const_iterator it = diff.removed.begin(); it != diff.removed.end(); ++it)
+    {
+        const std::string removedKey = key(*it);
+        m_services.erase(removedKey);
+        Removal& removal = m_removed[removedKey];
+        removal.mac = *it;
+        removal.version = m_version;
+    }
+    while (m_removed.size() > MAX_REMOVED_SERVICES)
+    {
+        std::map<std::string, Removal>::iterator oldest = m_removed.begin();
+        for (std::map<std::string, Removal>::iterator it = m_removed.begin(); it != m_removed.end(); ++it)
+        {
+            if (it->second.version < oldest->second.version)
+            {
+                oldest = it;
+            }
+        }
+        if (oldest->second.version > m_forgottenVersion)
+        {
+            m_forgottenVersion = oldest->second.version;
+        }
+        m_removed.erase(oldest);
+    }
+    for (vector<WifiServerServiceConfig>::const_iterator it = diff.added.begin(); it != diff.added.end(); ++it)
+    {
+        const std::string addedKey = key(it->mac);
+        m_removed.erase(addedKey);
+        Service& service = m_services[addedKey];
+        service.config = *it;
+        service.addedVersion = m_version;
+        service.changedVersion = m_version;
+    }
+    for (vector<WifiServerServiceConfig>::const_iterator it = diff.updated.begin(); it != diff.updated.end(); ++it)
+    {
+        Service& service = m_services[key(it->mac)];
+        service.config = *it;
+        service.changedVersion = m_version;
+    }
+    return true;
+}
+
+void WifiServiceListTracker::get(WifiServerServiceList& list, unsigned int& version) const
+{
+    list.wifiRemoteServices.clear();
+    list.wifiRemoteServices.reserve(m_services.size());
+    for (std::map<std::string, Service>::const_iterator it = m_services.begin(); it != m_services.end(); ++it)
+    {
+        list.wifiRemoteServices.push_back(it->second.config);
+    }
+    list.services_num = static_cast<unsigned int>(list.wifiRemoteServices.size());
+    version = m_version;
+}
+
+void WifiServiceListTracker::getChanges(unsigned int sinceVersion, WifiServerServiceListDiff& diff) const
+{
+    diff = WifiServerServiceListDiff();
+    diff.from_version = sinceVersion;
+    diff.version = m_version;
+    diff.full_list = (sinceVersion > m_version) || (sinceVersion < m_forgottenVersion);
+
+    for (std::map<std::string, Service>::const_iterator it = m_services.begin(); it != m_services.end(); ++it)
+    {
+        if (diff.full_list || (it->second.addedVersion > sinceVersion))
+        {
+            diff.added.push_back(it->second.config);
+        }
+        else if (it->second.changedVersion > sinceVersion)
+        {
+            diff.updated.push_back(it->second.config);
+        }
+    }
+    if (diff.full_list)
+    {
+        return;
+    }
+    for (std::map<std::string, Removal>::const_iterator it = m_removed.begin(); it != m_removed.end(); ++it)
+    {
+        if (it->second.version > sinceVersion)
+        {
+            diff.removed.push_back(it->second.mac);
+        }
+    }
+}
+
+unsigned int WifiServiceListTracker::getVersion() const
+{
+    return m_version;
+}
+
+std::string WifiServiceListTracker::key(const std::string& mac)
+{
+    std::string result(mac);
+    for (std::string::iterator it = result.begin(); it != result.end(); ++it)
+    {
+        *it = static_cast<char>(std::tolower(static_cast<unsigned char>(*it)));
+    }
+    return result;
+}
+
+bool WifiServiceListTracker::changed(const WifiServerServiceConfig& previous,
+    const WifiServerServiceConfig& current) const
+{
+    const unsigned int rssiDelta = (current.rssi > previous.rssi) ? current.rssi - previous.rssi
+        : previous.rssi - current.rssi;
+    return (previous.ssid != current.ssid) || (previous.channel != current.channel)
+        || (previous.cipher != current.cipher) || (previous.mac != current.mac)
+        || (previous.IEE_802_11_mode != current.IEE_802_11_mode)
+        || (previous.connection_status != current.connection_status)
+        || (previous.securityMode != current.securityMode)
+        || ((rssiDelta > 0) && (rssiDelta >= m_rssiHysteresis));
+}
+
+}
+}
@@ -0,0 +1,91 @@
+/**
+ * \file
+ *          WifiServiceListTracker.h
+ * \brief
+ *          Versioned Wi-Fi service list, and changes between its versions
+ *
+ * \par Copyright Notice:
+ * \verbatim
+ * Copyright (c) 2021 Stellantis N.V.
+ * All Rights Reserved.
+ * The reproduction, transmission or use of this document or its contents is
+ * not permitted without express written authority.
+ * Offenders will be liable for damages. All rights, including rights created
+ * by patent grant or registration of a utility model or design, are reserved.
+ * \endverbatim
+ */
+
+#ifndef WIFISERVICELISTTRACKER_H
+#define WIFISERVICELISTTRACKER_H
+
+#include <map>
+#include <string>
+
+#include "IWifiRemoteServiceTypes.h"
+
+namespace Stla {
+namespace Connectivity {
+
+/**
+ * WifiServiceListTracker keeps the last scanned Wi-Fi service list, keyed by MAC address (case insensitive).
+ *
+ * Each scan is given to update(), which returns the diff from the previous version when something changed. Each
+ * service remembers the versions at which it was added and last changed, and removed services are remembered up to
+ * MAX_REMOVED_SERVICES, so the changes since any recent version can be rebuilt without keeping the diffs.
+ *
+ * The class is not thread-safe.
+ */
+class WifiServiceListTracker
+{
+public:
+    static const size_t MAX_REMOVED_SERVICES = 256;
+    static const unsigned int DEFAULT_RSSI_HYSTERESIS = 5;
+
+    explicit WifiServiceListTracker(unsigned int rssiHysteresis = DEFAULT_RSSI_HYSTERESIS);
+
+    /**
+     * @brief Replace the list by a scan result.
+     * @return true if the list changed, diff then holds the changes from the previous version.
+     */
+    bool update(const vector<WifiServerServiceConfig>& services, WifiServerServiceListDiff& diff);
+
+    /**
+     * @brief Current list, ordered by MAC address.
+     */
+    void get(WifiServerServiceList& list, unsigned int& version) const;
+
+    /**
+     * @brief Changes since a version, or the whole list with full_list set if they are no longer known.
+     */
+    void getChanges(unsigned int sinceVersion, WifiServerServiceListDiff& diff) const;
+
+    unsigned int getVersion() const;
+
+private:
+    struct Service
+    {
+        WifiServerServiceConfig config;
+        unsigned int addedVersion;
+        unsigned int changedVersion;
+    };
+
+    struct Removal
+    {
+        std::string mac;
+        unsigned int version;
+    };
+
+    static std::string key(const std::string& mac);
+    bool changed(const WifiServerServiceConfig& previous, const WifiServerServiceConfig& current) const;
+
+    unsigned int m_rssiHysteresis;
+    unsigned int m_version;
+    std::map<std::string, Service> m_services;
+    std::map<std::string, Removal> m_removed;
+    unsigned int m_forgottenVersion;                // removals up to this version are no longer known
+};
+
+}
+}
+
+#endif // WIFISERVICELISTTRACKER_H
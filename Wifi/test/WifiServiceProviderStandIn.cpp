@@ -0,0 +1,206 @@
+/**
+ * \file
+ *          WifiServiceProviderStandIn.cpp
+ * \brief
+ *          Wi-Fi service provider driven by the connection manager stand-in script, for offline runs on a X86 PC target
+ *
+ * \par Copyright Notice:
+ * \verbatim
+ * Copyright (c) 2021 Stellantis N.V.
+ * All Rights Reserved.
+ * The reproduction, transmission or use of this document or its contents is
+ * not permitted without express written authority.
+ * Offenders will be liable for damages. All rights, including rights created
+ * by patent grant or registration of a utility model or design, are reserved.
+ * \endverbatim
+ */
+
+#include "WifiServiceProviderStandIn.h"
+
+namespace Stla {
+namespace Connectivity {
+
+namespace {
+
+typedef std::lock_guard<std::recursive_mutex> Lock;
+
+}
+
+WifiServiceProviderStandIn::WifiServiceProviderStandIn()
+{
+    m_status.connectionStatus = WIFI_SERVER_STATE_DISCONNECTED;
+    m_status.mode = TCU_STATE_OFF;
+}
+
+WifiServiceProviderStandIn::~WifiServiceProviderStandIn()
+{
+}
+
+void WifiServiceProviderStandIn::applyMode(WiFiServerNetState_e mode)
+{
+    Lock lock(m_mutex);
+    const WifiServerStatus previous = m_status;
+    m_status.mode = mode;
+    if (m_status.mode != TCU_STATE_ENABLED_STA)
+    {
+        setConnection(WIFI_SERVER_STATE_DISCONNECTED, "");
+    }
+    publish();
+    notifyStatus(previous);
+}
+
+void WifiServiceProviderStandIn::applyBss(const WifiServerServiceConfig& service)
+{
+    Lock lock(m_mutex);
+    WifiServerServiceConfig& scanned = m_scan[service.mac];
+    scanned = service;
+    scanned.connection_status = WIFI_SERVER_STATE_DISCONNECTED;
+}
+
+void WifiServiceProviderStandIn::applyLost(const std::string& mac)
+{
+    Lock lock(m_mutex);
+    m_scan.erase(mac);
+}
+
+void WifiServiceProviderStandIn::applyScan()
+{
+    Lock lock(m_mutex);
+    publish();
+}
+
+void WifiServiceProviderStandIn::applyState(WiFiServerIF_ServiceState_e state, const std::string& mac)
+{
+    Lock lock(m_mutex);
+    const WifiServerStatus previous = m_status;
+    setConnection(state, mac);
+    publish();
+    notifyStatus(previous);
+}
+
+void WifiServiceProviderStandIn::applyState(WiFiServerIF_ServiceState_e state)
+{
+    Lock lock(m_mutex);
+    applyState(state, m_connectedMac);
+}
+
+WiFiServerIF_ErrorCodes WifiServiceProviderStandIn::getWifiServices(WifiServerServiceList& stWifiServicesList)
+{
+    unsigned int version = 0;
+    return getWifiServicesVersion(stWifiServicesList, version);
+}
+
+void WifiServiceProviderStandIn::getWifiStatus(WifiServerStatus& stWifiStatus)
+{
+    Lock lock(m_mutex);
+    stWifiStatus = m_status;
+}
+
+WiFiServerIF_ErrorCodes WifiServiceProviderStandIn::getWifiServicesVersion(WifiServerServiceList& stWifiServicesList,
+    unsigned int& version)
+{
+    Lock lock(m_mutex);
+    m_tracker.get(stWifiServicesList, version);
+    return WIFI_SERVER_RES_OK;
+}
+
+WiFiServerIF_ErrorCodes WifiServiceProviderStandIn::getWifiServicesChanges(unsigned int sinceVersion,
+    WifiServerServiceListDiff& stDiff)
+{
+    Lock lock(m_mutex);
+    m_tracker.getChanges(sinceVersion, stDiff);
+    return WIFI_SERVER_RES_OK;
+}
+
+WiFiServerIF_ErrorCodes WifiServiceProviderStandIn::setWifiOffloadConfig(const WifiServerOffloadConfig& stConfig)
+{
+    Lock lock(m_mutex);
+    const WiFiServerIF_ErrorCodes result = m_offload.setConfig(stConfig);
+    if (result == WIFI_SERVER_RES_OK)
+    {
+        schedule();
+    }
+    return result;
+}
+
+WiFiServerIF_ErrorCodes WifiServiceProviderStandIn::queueWifiOffloadTransfer(const WifiServerOffloadTransfer& stTransfer,
+    unsigned int& transferId)
+{
+    Lock lock(m_mutex);
+    const WiFiServerIF_ErrorCodes result = m_offload.queue(stTransfer, transferId);
+    if (result == WIFI_SERVER_RES_OK)
+    {
+        schedule();
+    }
+    return result;
+}
+
+WiFiServerIF_ErrorCodes WifiServiceProviderStandIn::reportWifiOffloadProgress(unsigned int transferId,
+    unsigned long long offset)
+{
+    Lock lock(m_mutex);
+    return m_offload.progress(transferId, offset);
+}
+
+WiFiServerIF_ErrorCodes WifiServiceProviderStandIn::releaseWifiOffloadTransfer(unsigned int transferId)
+{
+    Lock lock(m_mutex);
+    const WiFiServerIF_ErrorCodes result = m_offload.release(transferId);
+    if (result == WIFI_SERVER_RES_OK)
+    {
+        schedule();
+    }
+    return result;
+}
+
+void WifiServiceProviderStandIn::notifyStatus(const WifiServerStatus& previous)
+{
+    if ((m_status.mode != previous.mode) || (m_status.connectionStatus != previous.connectionStatus))
+    {
+        m_evWifiRemoteStatusChanged.notify(this);
+    }
+}
+
+void WifiServiceProviderStandIn::setConnection(WiFiServerIF_ServiceState_e state, const std::string& mac)
+{
+    m_status.connectionStatus = state;
+    m_connectedMac = mac;
+    const std::map<std::string, WifiServerServiceConfig>::const_iterator service = m_scan.find(mac);
+    m_offload.setConnection(state, (service != m_scan.end()) ? service->second.ssid : std::string());
+    schedule();
+}
+
+void WifiServiceProviderStandIn::publish()
+{
+    vector<WifiServerServiceConfig> services;
+    if (m_status.mode == TCU_STATE_ENABLED_STA)
+    {
+        for (std::map<std::string, WifiServerServiceConfig>::const_iterator it = m_scan.begin(); it != m_scan.end();
+            ++it)
+        {
+            services.push_back(it->second);
+            services.back().connection_status = (it->first == m_connectedMac) ? m_status.connectionStatus
+                : WIFI_SERVER_STATE_DISCONNECTED;
+        }
+    }
+
+    WifiServerServiceListDiff diff;
+    if (m_tracker.update(services, diff))
+    {
+        m_evWifiRemoteServicesChanged.notify(this);
+        m_evWifiRemoteServicesDiff.notify(this, diff);
+    }
+}
+
+void WifiServiceProviderStandIn::schedule()
+{
+    vector<WifiServerOffloadStatus> changes;
+    m_offload.schedule(changes);
+    for (vector<WifiServerOffloadStatus>::const_iterator it = changes.begin(); it != changes.end(); ++it)
+    {
+        m_evWifiOffloadStatusChanged.notify(this, *it);
+    }
+}
+
+}
+}
@@ -0,0 +1,112 @@
+/**
+ * \file
+ *          WifiServiceProviderStandIn.h
+ * \brief
+ *          Wi-Fi service provider driven by the connection manager stand-in script, for offline runs on a X86 PC target
+ *
+ * \par Copyright Notice:
+ * \verbatim
+ * Copyright (c) 2021 Stellantis N.V.
+ * All Rights Reserved.
+ * The reproduction, transmission or use of this document or its contents is
+ * not permitted without express written authority.
+ * Offenders will be liable for damages. All rights, including rights created
+ * by patent grant or registration of a utility model or design, are reserved.
+ * \endverbatim
+ */
+
+#ifndef WIFISERVICEPROVIDERSTANDIN_H
+#define WIFISERVICEPROVIDERSTANDIN_H
+
+#include <map>
+#include <mutex>
+#include <string>
+
+#include "IWifiServiceProvider.h"
+#include "WifiOffloadEngine.h"
+#include "WifiServiceListTracker.h"
+
+namespace Stla {
+namespace Connectivity {
+
+/**
+ * WifiServiceProviderStandIn implements IWifiServiceProvider from the apply methods instead of the Wi-Fi manager,
+ * through the same service list tracker and offload engine as the service. The Wi-Fi steps of a
+ * \link ConnManagerServiceStandIn \endlink script are forwarded to them, so both stand-ins replay one script on one
+ * clock.
+ *
+ * All the methods lock the stand-in, events are notified with the lock held: a delegate may call the stand-in back
+ * from the notifying thread, not wait for another thread doing so.
+ */
+class WifiServiceProviderStandIn : public IWifiServiceProvider
+{
+public:
+    typedef Poco::AutoPtr<WifiServiceProviderStandIn> Ptr;
+
+    WifiServiceProviderStandIn();
+    virtual ~WifiServiceProviderStandIn();
+
+    /**
+     * @brief Set the Wi-Fi mode. Out of TCU_STATE_ENABLED_STA, the service list is empty and the client is
+     * disconnected.
+     */
+    void applyMode(WiFiServerNetState_e mode);
+
+    /**
+     * @brief Add or update a service of the next scan, by its MAC address.
+     */
+    void applyBss(const WifiServerServiceConfig& service);
+
+    /**
+     * @brief Remove a service from the next scan.
+     */
+    void applyLost(const std::string& mac);
+
+    /**
+     * @brief Publish the services added by applyBss() and not lost since.
+     */
+    void applyScan();
+
+    /**
+     * @brief Set the client connection state, on the service of the given MAC address.
+     */
+    void applyState(WiFiServerIF_ServiceState_e state, const std::string& mac);
+
+    /**
+     * @brief Set the client connection state, on the service of the previous state.
+     */
+    void applyState(WiFiServerIF_ServiceState_e state);
+
+    virtual WiFiServerIF_ErrorCodes getWifiServices(WifiServerServiceList& stWifiServicesList);
+    virtual void getWifiStatus(WifiServerStatus& stWifiStatus);
+    virtual WiFiServerIF_ErrorCodes getWifiServicesVersion(WifiServerServiceList& stWifiServicesList,
+        unsigned int& version);
+    virtual WiFiServerIF_ErrorCodes getWifiServicesChanges(unsigned int sinceVersion, WifiServerServiceListDiff& stDiff);
+    virtual WiFiServerIF_ErrorCodes setWifiOffloadConfig(const WifiServerOffloadConfig& stConfig);
+    virtual WiFiServerIF_ErrorCodes queueWifiOffloadTransfer(const WifiServerOffloadTransfer& stTransfer, unsigned int& transferId);
+    virtual WiFiServerIF_ErrorCodes reportWifiOffloadProgress(unsigned int transferId, unsigned long long offset);
+    virtual WiFiServerIF_ErrorCodes releaseWifiOffloadTransfer(unsigned int transferId);
+
+private:
+    WifiServiceProviderStandIn(const WifiServiceProviderStandIn&);
+    WifiServiceProviderStandIn& operator=(const WifiServiceProviderStandIn&);
+
+    void notifyStatus(const WifiServerStatus& previous);
+    void setConnection(WiFiServerIF_ServiceState_e state, const std::string& mac);
+    void publish();
+    void schedule();
+
+    std::recursive_mutex m_mutex;
+
+    WifiServiceListTracker m_tracker;
+    WifiOffloadEngine m_offload;
+
+    WifiServerStatus m_status;
+    std::string m_connectedMac;                                 // service of the client connection state
+    std::map<std::string, WifiServerServiceConfig> m_scan;      // next scan result, by MAC address
+};
+
+}
+}
+
+#endif // WIFISERVICEPROVIDERSTANDIN_H